@@ -36,10 +36,54 @@ BookController::BookController(application::IBookService* bookService,
 
     connect(m_bookService, &application::IBookService::noSearchHitsFound, this,
             &IBookController::noSearchHitsFound);
+
+    connect(m_bookService, &application::IBookService::searchHitsChanged, this,
+            &IBookController::searchHitsChanged);
+
+    connect(m_bookService, &application::IBookService::pageGeometryChanged,
+            this, &IBookController::pageGeometryChanged);
+
+    connect(m_bookService, &application::IBookService::loadingStarted, this,
+            &IBookController::loadingChanged);
+
+    connect(m_bookService, &application::IBookService::loadingProgressChanged,
+            this, &IBookController::loadingProgressChanged);
+
+    connect(m_bookService, &application::IBookService::loadingFinished, this,
+            [this]()
+            {
+                // The page count and outline are known now
+                emit loadingChanged();
+                emit pageCountChanged(getPageCount());
+                emit tableOfContentsChanged();
+                emit loadingFinished();
+            });
+
+    connect(m_bookService, &application::IBookService::loadingFailed, this,
+            [this]()
+            {
+                emit loadingChanged();
+                emit loadingFailed();
+            });
+
+    // Syncing the library can replace the highlights of the opened book
+    connect(m_libraryService, &application::ILibraryService::dataChanged,
+            this,
+            [this](int index)
+            {
+                if(m_bookUuid.isNull() ||
+                   index != m_libraryService->getBookIndex(m_bookUuid))
+                {
+                    return;
+                }
+
+                m_bookService->reloadHighlights();
+            });
 }
 
 bool BookController::setUp(QString uuid)
 {
+    m_bookUuid = QUuid(uuid);
     m_bookService->setUp(
         std::make_unique<LibraryBookGetter>(m_libraryService, QUuid(uuid)));
 
@@ -72,11 +116,47 @@ bool BookController::setUp(QString uuid)
     return true;
 }
 
+void BookController::cancelLoading()
+{
+    m_bookService->cancelLoading();
+    emit loadingChanged();
+}
+
+bool BookController::isLoading() const
+{
+    return m_bookService->isLoading();
+}
+
+double BookController::getLoadingProgress() const
+{
+    return m_bookService->getLoadingProgress();
+}
+
 mupdf::FzDocument* BookController::getFzDocument()
 {
     return m_bookService->getFzDocument();
 }
 
+RenderScheduler* BookController::getRenderScheduler()
+{
+    return m_bookService->getRenderScheduler();
+}
+
+RenderCache* BookController::getRenderCache()
+{
+    return m_bookService->getRenderCache();
+}
+
+utils::TextPageCache* BookController::getTextPageCache()
+{
+    return m_bookService->getTextPageCache();
+}
+
+const PageGeometry& BookController::getPageGeometry() const
+{
+    return m_bookService->getPageGeometry();
+}
+
 void BookController::search(const QString& text)
 {
     m_bookService->search(text, m_searchOptions);
@@ -97,6 +177,17 @@ void BookController::goToPreviousSearchHit()
     m_bookService->goToPreviousSearchHit();
 }
 
+const utils::SearchHits& BookController::getSearchHits() const
+{
+    return m_bookService->getSearchHits();
+}
+
+QList<qreal> BookController::getSearchHitDensity(int bucketCount) const
+{
+    auto& searchHits = m_bookService->getSearchHits();
+    return searchHits.getDensity(m_bookService->getPageCount(), bucketCount);
+}
+
 const QList<Highlight>& BookController::getHighlights() const
 {
     return m_bookService->getHighlights();
@@ -126,6 +217,11 @@ const Highlight* BookController::getHighlightAtPoint(const QPointF& point,
     return m_bookService->getHighlightAtPoint(restoredPoint, page);
 }
 
+QList<const Highlight*> BookController::getHighlightsOfPage(int page) const
+{
+    return m_bookService->getHighlightsOfPage(page);
+}
+
 const QList<Bookmark>& BookController::getBookmark() const
 {
     return m_bookService->getBookmarks();
@@ -167,6 +263,21 @@ void BookController::followLink(const char* uri)
     return m_bookService->followLink(uri);
 }
 
+void BookController::prefetchPages(int currentPage, float pagesPerSecond)
+{
+    m_bookService->prefetchPages(currentPage, pagesPerSecond);
+}
+
+void BookController::prefetchPage(int pageNumber)
+{
+    m_bookService->prefetchPage(pageNumber);
+}
+
+void BookController::prefetchLinkTarget(const char* uri)
+{
+    m_bookService->prefetchLinkTarget(uri);
+}
+
 QString BookController::getFilePath() const
 {
     return m_bookService->getFilePath();
@@ -201,6 +312,11 @@ void BookController::setZoom(float newZoom)
     emit zoomChanged(newZoom);
 }
 
+void BookController::setDevicePixelRatio(double dpr)
+{
+    m_bookService->setDevicePixelRatio(dpr);
+}
+
 bool BookController::getSearchWholeWords() const
 {
     return m_searchOptions.wholeWords;
@@ -223,6 +339,17 @@ void BookController::setSearchCaseSensitive(bool newCaseSensitive)
     emit searchCaseSensitiveChanged();
 }
 
+bool BookController::getSearchRegularExpression() const
+{
+    return m_searchOptions.regularExpression;
+}
+
+void BookController::setSearchRegularExpression(bool newRegularExpression)
+{
+    m_searchOptions.regularExpression = newRegularExpression;
+    emit searchRegularExpressionChanged();
+}
+
 bool BookController::getSearchFromStart() const
 {
     return m_searchOptions.fromStart;
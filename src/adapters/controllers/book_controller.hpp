@@ -2,6 +2,7 @@
 #include <QObject>
 #include <QRectF>
 #include <QString>
+#include <QUuid>
 #include "adapters_export.hpp"
 #include "bookmarks_model.hpp"
 #include "i_book_controller.hpp"
@@ -22,12 +23,21 @@ public:
                    application::ILibraryService* libraryService);
 
     bool setUp(QString uuid) override;
+    void cancelLoading() override;
+    bool isLoading() const override;
+    double getLoadingProgress() const override;
     mupdf::FzDocument* getFzDocument() override;
+    application::core::RenderScheduler* getRenderScheduler() override;
+    application::core::RenderCache* getRenderCache() override;
+    application::core::utils::TextPageCache* getTextPageCache() override;
+    const application::core::PageGeometry& getPageGeometry() const override;
 
     void search(const QString& text) override;
     void clearSearch() override;
     void goToNextSearchHit() override;
     void goToPreviousSearchHit() override;
+    const application::core::utils::SearchHits& getSearchHits() const override;
+    QList<qreal> getSearchHitDensity(int bucketCount) const override;
 
     const QList<domain::entities::Highlight>& getHighlights() const override;
     void addHighlight(const domain::entities::Highlight& highlight) override;
@@ -35,6 +45,8 @@ public:
     void changeHighlightColor(const QUuid& uuid, const QColor& color) override;
     const domain::entities::Highlight* getHighlightAtPoint(
         const QPointF& point, int page) const override;
+    QList<const domain::entities::Highlight*> getHighlightsOfPage(
+        int page) const override;
 
     const QList<domain::entities::Bookmark>& getBookmark() const override;
     QString addBookmark(const QString& name, int pageNumber,
@@ -45,6 +57,10 @@ public:
 
     void followLink(const char* uri) override;
 
+    void prefetchPages(int currentPage, float pagesPerSecond) override;
+    void prefetchPage(int pageNumber) override;
+    void prefetchLinkTarget(const char* uri) override;
+
     QString getFilePath() const override;
     int getPageCount() const override;
 
@@ -53,6 +69,7 @@ public:
 
     float getZoom() const override;
     void setZoom(float newZoom) override;
+    void setDevicePixelRatio(double dpr) override;
 
     bool getSearchWholeWords() const override;
     void setSearchWholeWords(bool newSearchWholeWords) override;
@@ -60,6 +77,9 @@ public:
     bool getSearchCaseSensitive() const override;
     void setSearchCaseSensitive(bool newCaseSensitive) override;
 
+    bool getSearchRegularExpression() const override;
+    void setSearchRegularExpression(bool newRegularExpression) override;
+
     bool getSearchFromStart() const override;
     void setSearchFromStart(bool newSearchFromStart) override;
 
@@ -72,6 +92,7 @@ public:
 private:
     application::IBookService* m_bookService;
     application::ILibraryService* m_libraryService;
+    QUuid m_bookUuid;
     application::core::utils::SearchOptions m_searchOptions;
 
     std::unique_ptr<data_models::BookmarksModel> m_bookmarksModel;
@@ -37,6 +37,40 @@ ExternalBookController::ExternalBookController(
     connect(m_externalBookService,
             &application::IBookService::noSearchHitsFound, this,
             &IBookController::noSearchHitsFound);
+
+    connect(m_externalBookService,
+            &application::IBookService::searchHitsChanged, this,
+            &IBookController::searchHitsChanged);
+
+    connect(m_externalBookService,
+            &application::IBookService::pageGeometryChanged, this,
+            &IBookController::pageGeometryChanged);
+
+    connect(m_externalBookService, &application::IBookService::loadingStarted,
+            this, &IBookController::loadingChanged);
+
+    connect(m_externalBookService,
+            &application::IBookService::loadingProgressChanged, this,
+            &IBookController::loadingProgressChanged);
+
+    connect(m_externalBookService, &application::IBookService::loadingFinished,
+            this,
+            [this]()
+            {
+                // The page count and outline are known now
+                emit loadingChanged();
+                emit pageCountChanged(getPageCount());
+                emit tableOfContentsChanged();
+                emit loadingFinished();
+            });
+
+    connect(m_externalBookService, &application::IBookService::loadingFailed,
+            this,
+            [this]()
+            {
+                emit loadingChanged();
+                emit loadingFailed();
+            });
 }
 
 bool ExternalBookController::setUp(QString filePath)
@@ -49,11 +83,47 @@ bool ExternalBookController::setUp(QString filePath)
     return true;
 }
 
+void ExternalBookController::cancelLoading()
+{
+    m_externalBookService->cancelLoading();
+    emit loadingChanged();
+}
+
+bool ExternalBookController::isLoading() const
+{
+    return m_externalBookService->isLoading();
+}
+
+double ExternalBookController::getLoadingProgress() const
+{
+    return m_externalBookService->getLoadingProgress();
+}
+
 mupdf::FzDocument* ExternalBookController::getFzDocument()
 {
     return m_externalBookService->getFzDocument();
 }
 
+RenderScheduler* ExternalBookController::getRenderScheduler()
+{
+    return m_externalBookService->getRenderScheduler();
+}
+
+RenderCache* ExternalBookController::getRenderCache()
+{
+    return m_externalBookService->getRenderCache();
+}
+
+utils::TextPageCache* ExternalBookController::getTextPageCache()
+{
+    return m_externalBookService->getTextPageCache();
+}
+
+const PageGeometry& ExternalBookController::getPageGeometry() const
+{
+    return m_externalBookService->getPageGeometry();
+}
+
 void ExternalBookController::search(const QString& text)
 {
     m_externalBookService->search(text, m_searchOptions);
@@ -74,6 +144,18 @@ void ExternalBookController::goToPreviousSearchHit()
     m_externalBookService->goToPreviousSearchHit();
 }
 
+const utils::SearchHits& ExternalBookController::getSearchHits() const
+{
+    return m_externalBookService->getSearchHits();
+}
+
+QList<qreal> ExternalBookController::getSearchHitDensity(int bucketCount) const
+{
+    auto& searchHits = m_externalBookService->getSearchHits();
+    auto pageCount = m_externalBookService->getPageCount();
+    return searchHits.getDensity(pageCount, bucketCount);
+}
+
 const QList<Highlight>& ExternalBookController::getHighlights() const
 {
     return m_emptyHighlights;
@@ -105,6 +187,14 @@ const Highlight* ExternalBookController::getHighlightAtPoint(
     return nullptr;
 }
 
+QList<const Highlight*> ExternalBookController::getHighlightsOfPage(
+    int page) const
+{
+    Q_UNUSED(page);
+
+    return {};
+}
+
 const QList<Bookmark>& ExternalBookController::getBookmark() const
 {
     return m_emptyBookmarks;
@@ -142,6 +232,22 @@ void ExternalBookController::followLink(const char* uri)
     return m_externalBookService->followLink(uri);
 }
 
+void ExternalBookController::prefetchPages(int currentPage,
+                                           float pagesPerSecond)
+{
+    m_externalBookService->prefetchPages(currentPage, pagesPerSecond);
+}
+
+void ExternalBookController::prefetchPage(int pageNumber)
+{
+    m_externalBookService->prefetchPage(pageNumber);
+}
+
+void ExternalBookController::prefetchLinkTarget(const char* uri)
+{
+    m_externalBookService->prefetchLinkTarget(uri);
+}
+
 QString ExternalBookController::getFilePath() const
 {
     return m_externalBookService->getFilePath();
@@ -176,6 +282,11 @@ void ExternalBookController::setZoom(float newZoom)
     emit zoomChanged(newZoom);
 }
 
+void ExternalBookController::setDevicePixelRatio(double dpr)
+{
+    m_externalBookService->setDevicePixelRatio(dpr);
+}
+
 bool ExternalBookController::getSearchWholeWords() const
 {
     return m_searchOptions.wholeWords;
@@ -198,6 +309,18 @@ void ExternalBookController::setSearchCaseSensitive(bool newCaseSensitive)
     emit searchCaseSensitiveChanged();
 }
 
+bool ExternalBookController::getSearchRegularExpression() const
+{
+    return m_searchOptions.regularExpression;
+}
+
+void ExternalBookController::setSearchRegularExpression(
+    bool newRegularExpression)
+{
+    m_searchOptions.regularExpression = newRegularExpression;
+    emit searchRegularExpressionChanged();
+}
+
 bool ExternalBookController::getSearchFromStart() const
 {
     return m_searchOptions.fromStart;
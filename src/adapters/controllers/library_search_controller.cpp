@@ -0,0 +1,45 @@
+#include "library_search_controller.hpp"
+#include <QVariantMap>
+
+namespace adapters::controllers
+{
+
+LibrarySearchController::LibrarySearchController(
+    application::ILibrarySearchService* librarySearchService) :
+    m_librarySearchService(librarySearchService)
+{
+    connect(m_librarySearchService,
+            &application::ILibrarySearchService::searchResultsReady, this,
+            &LibrarySearchController::processSearchResults);
+}
+
+void LibrarySearchController::search(const QString& text)
+{
+    m_librarySearchService->search(text);
+}
+
+int LibrarySearchController::getIndexedBookCount() const
+{
+    return m_librarySearchService->getIndexedBookCount();
+}
+
+void LibrarySearchController::processSearchResults(
+    const QString& text, const QList<application::LibrarySearchResult>& results)
+{
+    QVariantList resultList;
+    for(auto& result : results)
+    {
+        QVariantMap resultMap {
+            { "uuid", result.bookUuid.toString(QUuid::WithoutBraces) },
+            { "title", result.title },
+            { "pageNumber", result.pageNumber },
+            { "snippet", result.snippet },
+            { "score", result.score },
+        };
+        resultList.append(resultMap);
+    }
+
+    emit searchResultsReady(text, resultList);
+}
+
+}  // namespace adapters::controllers
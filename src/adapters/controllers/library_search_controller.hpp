@@ -0,0 +1,30 @@
+#pragma once
+#include <QObject>
+#include "adapters_export.hpp"
+#include "i_library_search_controller.hpp"
+#include "i_library_search_service.hpp"
+
+namespace adapters::controllers
+{
+
+class ADAPTERS_EXPORT LibrarySearchController : public ILibrarySearchController
+{
+    Q_OBJECT
+
+public:
+    LibrarySearchController(
+        application::ILibrarySearchService* librarySearchService);
+
+    void search(const QString& text) override;
+    int getIndexedBookCount() const override;
+
+private slots:
+    void processSearchResults(
+        const QString& text,
+        const QList<application::LibrarySearchResult>& results);
+
+private:
+    application::ILibrarySearchService* m_librarySearchService;
+};
+
+}  // namespace adapters::controllers
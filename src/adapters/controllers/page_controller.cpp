@@ -1,17 +1,47 @@
 #include "page_controller.hpp"
+#include <cmath>
 #include "fz_utils.hpp"
 #include "mupdf/classes.h"
+#include "rendering/disk_render_cache.hpp"
+#include "rendering/tiling.hpp"
 
 using namespace application::core;
 
 namespace adapters::controllers
 {
 
-PageController::PageController(mupdf::FzDocument* document, int pageNumber,
-                               double dpr) :
-    m_pageGenerator(document, pageNumber),
+PageController::PageController(mupdf::FzDocument* document,
+                               RenderScheduler* renderScheduler,
+                               RenderCache* renderCache,
+                               utils::TextPageCache* textPageCache,
+                               int pageNumber, double dpr) :
+    m_pageGenerator(document, pageNumber, renderCache, textPageCache),
+    m_renderScheduler(renderScheduler),
+    m_renderCache(renderCache),
+    m_pageNumber(pageNumber),
+    m_pageXOffset(m_pageGenerator.getPageXOffset()),
+    m_pageYOffset(m_pageGenerator.getPageYOffset()),
     m_dpr(dpr)
 {
+    connect(m_renderScheduler, &RenderScheduler::pageRendered, this,
+            [this](quint64 ticket, int pageNumber, const QImage& image)
+            {
+                if(pageNumber == m_pageNumber)
+                    handleRenderedPage(ticket, image);
+            });
+
+    // Stored images are loaded on the disk cache's thread, so the results
+    // arrive queued, just like rendered pages.
+    if(auto diskCache = m_renderCache->getDiskCache())
+    {
+        connect(diskCache, &DiskRenderCache::imageLoaded, this,
+                &PageController::handleLoadedPage);
+    }
+}
+
+PageController::~PageController()
+{
+    cancelPendingRender();
 }
 
 int PageController::getWidth()
@@ -24,6 +54,11 @@ int PageController::getHeight()
     return m_pageGenerator.getHeight() * m_matrix.d / m_dpr;
 }
 
+QSize PageController::getPageSize() const
+{
+    return QSize(m_pageGenerator.getWidth(), m_pageGenerator.getHeight());
+}
+
 int PageController::getXOffset() const
 {
     return m_pageXOffset;
@@ -41,6 +76,8 @@ void PageController::setZoom(float zoom)
 
     m_pageImageOutdated = true;
     m_selectionRectsOutdated = true;
+    cancelPendingRender();
+    updateTiles();
 }
 
 float PageController::getZoom()
@@ -48,31 +85,311 @@ float PageController::getZoom()
     return m_matrix.a;
 }
 
-void PageController::setInvertColor(bool newInvertColor)
+void PageController::requestPageImage(bool isVisible, RenderQuality quality)
 {
-    m_pageGenerator.setInvertColor(newInvertColor);
-    m_pageImageOutdated = true;
+    auto priority =
+        isVisible ? RenderPriority::Visible : RenderPriority::Buffered;
+
+    // Tiles are only needed for reading the page closely, which is not
+    // possible while it is flying by.
+    if(usesTiles() && quality == RenderQuality::Full)
+        requestTiles(priority);
+
+    if(!m_pageImageOutdated && m_pageImageQuality >= quality)
+        return;
+
+    // The page is already being rendered, just make sure that it is rendered
+    // with the right priority. A pending draft render is replaced once a full
+    // quality image is needed.
+    if(m_pendingRenderTicket != 0)
+    {
+        if(m_pendingRenderQuality >= quality)
+        {
+            if(priority != m_pendingRenderPriority)
+            {
+                m_renderScheduler->setPriority(m_pendingRenderTicket,
+                                               priority);
+                m_pendingRenderPriority = priority;
+            }
+
+            return;
+        }
+
+        m_renderScheduler->cancelRender(m_pendingRenderTicket);
+        m_pendingRenderTicket = 0;
+    }
+
+    // The stored image is on its way, it is replaced by a render if it fails
+    if(m_pendingLoadTicket != 0)
+        return;
+
+    // The page might have been rendered with the same settings before, e.g.
+    // when it is shown again after scrolling away from it.
+    auto cachedImage = m_renderCache->getImage(getRenderCacheKey());
+    if(!cachedImage.isNull())
+    {
+        m_pageImage = cachedImage;
+        m_pageImageZoom = getBaseLayerZoom();
+        m_pageImageQuality = RenderQuality::Full;
+        m_pageImageOutdated = false;
+
+        emit pageImageChanged();
+        return;
+    }
+
+    // Decoding a stored image is much cheaper than rendering the page, e.g.
+    // right after the book was reopened.
+    if(auto diskCache = m_renderCache->getDiskCache())
+    {
+        m_pendingLoadTicket = diskCache->loadImage(getRenderCacheKey());
+        if(m_pendingLoadTicket != 0)
+        {
+            m_pendingLoadPriority = priority;
+            return;
+        }
+    }
+
+    requestRender(priority, quality);
 }
 
-QImage PageController::renderPage()
+const QImage& PageController::getPageImage() const
 {
-    if(!m_pageImageOutdated)
-        return m_pageImage;
+    return m_pageImage;
+}
 
-    auto zoom = m_matrix.a;
-    m_pageImage = utils::qImageFromPixmap(m_pageGenerator.renderPage(zoom));
+float PageController::getPageImageZoom() const
+{
+    return m_pageImageZoom;
+}
+
+bool PageController::pageImageIsOutdated() const
+{
+    if(m_pageImageOutdated || m_pageImageQuality == RenderQuality::Draft)
+        return true;
+
+    for(auto& tile : m_tiles)
+    {
+        if(tile.image.isNull() && tile.renderTicket == 0)
+            return true;
+    }
+
+    return false;
+}
+
+void PageController::setVisibleArea(const QRectF& visibleArea)
+{
+    if(m_visibleArea == visibleArea)
+        return;
+
+    m_visibleArea = visibleArea;
+    updateTiles();
+}
+
+bool PageController::usesTiles() const
+{
+    return tiling::usesTiles(getScaledPageSize());
+}
+
+const QHash<QPoint, PageTile>& PageController::getTiles() const
+{
+    return m_tiles;
+}
+
+void PageController::handleRenderedPage(quint64 ticket, const QImage& image)
+{
+    // Results of renders that were cancelled after they were already started
+    // can still arrive, they are outdated and thus dropped.
+    if(ticket == m_pendingRenderTicket)
+    {
+        m_pendingRenderTicket = 0;
+        m_pageImage = image;
+        m_pageImageZoom = m_pendingRenderZoom;
+        m_pageImageQuality = m_pendingRenderQuality;
+        m_pageImageOutdated = false;
+        if(m_pageImageQuality == RenderQuality::Full)
+            m_renderCache->insertImage(getRenderCacheKey(), image);
+
+        auto diskCache = m_renderCache->getDiskCache();
+        if(ticket == m_storedImageRefreshTicket && diskCache != nullptr)
+        {
+            m_storedImageRefreshTicket = 0;
+            diskCache->storeImage(getRenderCacheKey(), image, true);
+        }
+
+        emit pageImageChanged();
+        return;
+    }
 
-    auto xOffset = m_pageGenerator.getPageXOffset();
-    auto yOffset = m_pageGenerator.getPageYOffset();
-    if(xOffset != m_pageXOffset || yOffset != m_pageYOffset)
+    for(auto& tile : m_tiles)
     {
-        m_pageXOffset = xOffset;
-        m_pageYOffset = yOffset;
-        emit pageOffsetsChanged(xOffset, yOffset);
+        if(tile.renderTicket == ticket)
+        {
+            tile.renderTicket = 0;
+            tile.image = image;
+
+            emit pageImageChanged();
+            return;
+        }
     }
+}
 
+void PageController::handleLoadedPage(quint64 ticket, const QImage& image)
+{
+    if(ticket != m_pendingLoadTicket)
+        return;
+
+    m_pendingLoadTicket = 0;
+    if(image.isNull())
+    {
+        requestRender(m_pendingLoadPriority, RenderQuality::Full);
+        return;
+    }
+
+    m_pageImage = image;
+    m_pageImageZoom = getBaseLayerZoom();
+    m_pageImageQuality = RenderQuality::Full;
     m_pageImageOutdated = false;
-    return m_pageImage;
+    m_renderCache->insertImage(getRenderCacheKey(), image);
+
+    emit pageImageChanged();
+
+    // Stored images are only checked against the book's file, so the page is
+    // still rendered again with the lowest priority. The render replaces the
+    // shown image and the stored one once it arrives, without the page ever
+    // being blank.
+    requestRender(RenderPriority::Prefetch, RenderQuality::Full);
+    m_storedImageRefreshTicket = m_pendingRenderTicket;
+}
+
+void PageController::requestRender(RenderPriority priority,
+                                   RenderQuality quality)
+{
+    RenderRequest request {
+        .pageNumber = m_pageNumber,
+        .zoom = getBaseLayerZoom(),
+        .priority = priority,
+        .displayList = m_pageGenerator.getDisplayList(),
+        .pageBox = m_pageGenerator.getPageBox(),
+        .quality = quality,
+    };
+
+    m_pendingRenderTicket = m_renderScheduler->requestRender(request);
+    m_pendingRenderPriority = priority;
+    m_pendingRenderZoom = request.zoom;
+    m_pendingRenderQuality = quality;
+}
+
+void PageController::cancelPendingRender()
+{
+    clearTiles();
+
+    // Stored images that are still being loaded are dropped once they arrive
+    m_pendingLoadTicket = 0;
+
+    if(m_pendingRenderTicket == 0)
+        return;
+
+    m_renderScheduler->cancelRender(m_pendingRenderTicket);
+    m_pendingRenderTicket = 0;
+}
+
+void PageController::requestTiles(RenderPriority priority)
+{
+    for(auto& tile : m_tiles)
+    {
+        if(!tile.image.isNull() || tile.renderTicket != 0)
+            continue;
+
+        RenderRequest request {
+            .pageNumber = m_pageNumber,
+            .zoom = m_matrix.a,
+            .priority = priority,
+            .displayList = m_pageGenerator.getDisplayList(),
+            .pageBox = m_pageGenerator.getPageBox(),
+            .region = tile.rect,
+        };
+
+        tile.renderTicket = m_renderScheduler->requestRender(request);
+    }
+}
+
+void PageController::updateTiles()
+{
+    if(!usesTiles() || m_visibleArea.isEmpty())
+    {
+        clearTiles();
+        return;
+    }
+
+    // The visible area is in logical pixels, but tiles are in device pixels.
+    // Also keep one row / column of tiles around the visible area, so that
+    // panning a bit does not immediately uncover the base layer.
+    const int tileSize = tiling::tileSize;
+    auto pageSize = getScaledPageSize();
+    QRectF scaledArea(m_visibleArea.topLeft() * m_dpr,
+                      m_visibleArea.size() * m_dpr);
+    auto neededArea = scaledArea.toAlignedRect()
+                          .adjusted(-tileSize, -tileSize, tileSize, tileSize)
+                          .intersected(QRect(QPoint(0, 0), pageSize));
+
+    int firstColumn = neededArea.left() / tileSize;
+    int lastColumn = neededArea.right() / tileSize;
+    int firstRow = neededArea.top() / tileSize;
+    int lastRow = neededArea.bottom() / tileSize;
+
+    // Free the tiles that are not needed anymore to keep the memory bounded
+    for(auto it = m_tiles.begin(); it != m_tiles.end();)
+    {
+        auto index = it.key();
+        if(index.x() < firstColumn || index.x() > lastColumn ||
+           index.y() < firstRow || index.y() > lastRow)
+        {
+            if(it->renderTicket != 0)
+                m_renderScheduler->cancelRender(it->renderTicket);
+
+            it = m_tiles.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    for(int row = firstRow; row <= lastRow; ++row)
+    {
+        for(int column = firstColumn; column <= lastColumn; ++column)
+        {
+            QPoint index(column, row);
+            if(m_tiles.contains(index))
+                continue;
+
+            QRect rect(column * tileSize, row * tileSize, tileSize, tileSize);
+            m_tiles.insert(index, PageTile { rect.intersected(QRect(
+                                      QPoint(0, 0), pageSize)) });
+        }
+    }
+}
+
+void PageController::clearTiles()
+{
+    for(auto& tile : m_tiles)
+    {
+        if(tile.renderTicket != 0)
+            m_renderScheduler->cancelRender(tile.renderTicket);
+    }
+
+    m_tiles.clear();
+}
+
+float PageController::getBaseLayerZoom() const
+{
+    return tiling::getPageImageZoom(m_matrix.a, getScaledPageSize());
+}
+
+QSize PageController::getScaledPageSize() const
+{
+    return QSize(std::ceil(m_pageGenerator.getWidth() * m_matrix.a),
+                 std::ceil(m_pageGenerator.getHeight() * m_matrix.d));
 }
 
 bool PageController::pointIsAboveText(const QPointF& point)
@@ -178,4 +495,15 @@ QString PageController::getTextFromSelection(const QPointF& start,
     return QString::fromStdString(res);
 }
 
+RenderCacheKey PageController::getRenderCacheKey() const
+{
+    // Tiles are not cached, so the key describes the page image. When tiling,
+    // that is the base layer, whose zoom is derived from the page's zoom.
+    return RenderCacheKey {
+        .pageNumber = m_pageNumber,
+        .zoom = static_cast<float>(m_matrix.a / m_dpr),
+        .dpr = m_dpr,
+    };
+}
+
 }  // namespace adapters::controllers
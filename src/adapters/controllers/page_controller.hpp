@@ -3,6 +3,8 @@
 #include "i_page_controller.hpp"
 #include "mupdf/classes.h"
 #include "page_generator.hpp"
+#include "rendering/render_cache.hpp"
+#include "rendering/render_scheduler.hpp"
 
 namespace adapters::controllers
 {
@@ -12,10 +14,16 @@ class PageController : public IPageController
     Q_OBJECT
 
 public:
-    PageController(mupdf::FzDocument* document, int pageNumber, double dpr);
+    PageController(mupdf::FzDocument* document,
+                   application::core::RenderScheduler* renderScheduler,
+                   application::core::RenderCache* renderCache,
+                   application::core::utils::TextPageCache* textPageCache,
+                   int pageNumber, double dpr);
+    ~PageController();
 
     int getWidth() override;
     int getHeight() override;
+    QSize getPageSize() const override;
 
     int getXOffset() const override;
     int getYOffset() const override;
@@ -23,9 +31,16 @@ public:
     void setZoom(float zoom) override;
     float getZoom() override;
 
-    void setInvertColor(bool newInvertColor) override;
+    void requestPageImage(bool isVisible,
+                          application::core::RenderQuality quality =
+                              application::core::RenderQuality::Full) override;
+    const QImage& getPageImage() const override;
+    float getPageImageZoom() const override;
+    bool pageImageIsOutdated() const override;
 
-    QImage renderPage() override;
+    void setVisibleArea(const QRectF& visibleArea) override;
+    bool usesTiles() const override;
+    const QHash<QPoint, PageTile>& getTiles() const override;
 
     bool pointIsAboveText(const QPointF& point) override;
     bool pointIsAboveLink(const QPointF& point) override;
@@ -43,7 +58,22 @@ public:
                                  const QPointF& end) override;
 
 private:
+    void handleRenderedPage(quint64 ticket, const QImage& image);
+    void handleLoadedPage(quint64 ticket, const QImage& image);
+    void requestRender(application::core::RenderPriority priority,
+                       application::core::RenderQuality quality);
+    void cancelPendingRender();
+    void requestTiles(application::core::RenderPriority priority);
+    void updateTiles();
+    void clearTiles();
+    float getBaseLayerZoom() const;
+    QSize getScaledPageSize() const;
+    application::core::RenderCacheKey getRenderCacheKey() const;
+
     application::core::PageGenerator m_pageGenerator;
+    application::core::RenderScheduler* m_renderScheduler;
+    application::core::RenderCache* m_renderCache;
+    int m_pageNumber;
     mupdf::FzMatrix m_matrix;
 
     int m_pageXOffset = 0;
@@ -56,9 +86,34 @@ private:
     // that the page is not blurry.
     double m_dpr = 1.0;
 
-    // Image caching
+    // Image caching. The page image is kept until its replacement has been
+    // rendered, so that there is always something to show.
     bool m_pageImageOutdated = true;
     QImage m_pageImage;
+    quint64 m_pendingRenderTicket = 0;
+    application::core::RenderPriority m_pendingRenderPriority;
+    float m_pendingRenderZoom = 1;
+    float m_pageImageZoom = 1;
+
+    // Images stored on disk are loaded in the background before rendering
+    // the page is considered, see DiskRenderCache.
+    quint64 m_pendingLoadTicket = 0;
+    application::core::RenderPriority m_pendingLoadPriority;
+
+    // The render of a page that was shown from its stored image, the stored
+    // image is replaced with it once it arrives.
+    quint64 m_storedImageRefreshTicket = 0;
+
+    // Draft images are shown while scrolling fast, but are never cached and
+    // are outdated as soon as a full quality image is requested.
+    application::core::RenderQuality m_pendingRenderQuality =
+        application::core::RenderQuality::Full;
+    application::core::RenderQuality m_pageImageQuality =
+        application::core::RenderQuality::Full;
+
+    // Tiling, see tiling.hpp
+    QHash<QPoint, PageTile> m_tiles;
+    QRectF m_visibleArea;
 
     // Selection rects outdated
     bool m_selectionRectsOutdated = true;
@@ -3,7 +3,12 @@
 #include "bookmark.hpp"
 #include "bookmarks_proxy_model.hpp"
 #include "highlight.hpp"
+#include "layout/page_geometry.hpp"
 #include "mupdf/classes.h"
+#include "rendering/render_cache.hpp"
+#include "rendering/render_scheduler.hpp"
+#include "search_hits.hpp"
+#include "text_page_cache.hpp"
 #include "toc/filtered_toc_model.hpp"
 #pragma once
 
@@ -21,6 +26,9 @@ class ADAPTERS_EXPORT IBookController : public QObject
     Q_OBJECT
     Q_PROPERTY(QString filePath NOTIFY filePathChanged)
     Q_PROPERTY(int pageCount READ getPageCount NOTIFY pageCountChanged)
+    Q_PROPERTY(bool loading READ isLoading NOTIFY loadingChanged)
+    Q_PROPERTY(double loadingProgress READ getLoadingProgress NOTIFY
+                   loadingProgressChanged)
     Q_PROPERTY(int currentPage READ getCurrentPage WRITE setCurrentPage NOTIFY
                    currentPageChanged)
     Q_PROPERTY(float zoom READ getZoom WRITE setZoom NOTIFY zoomChanged)
@@ -32,6 +40,9 @@ class ADAPTERS_EXPORT IBookController : public QObject
                    setSearchWholeWords NOTIFY searchWholeWordsChanged)
     Q_PROPERTY(bool searchCaseSensitive READ getSearchCaseSensitive WRITE
                    setSearchCaseSensitive NOTIFY searchCaseSensitiveChanged)
+    Q_PROPERTY(bool searchRegularExpression READ getSearchRegularExpression
+                   WRITE setSearchRegularExpression NOTIFY
+                       searchRegularExpressionChanged)
     Q_PROPERTY(bool searchFromStart READ getSearchFromStart WRITE
                    setSearchFromStart NOTIFY searchFromStartChanged)
     Q_PROPERTY(QString colorTheme READ getColorTheme WRITE setColorTheme NOTIFY
@@ -41,12 +52,28 @@ public:
     virtual ~IBookController() noexcept = default;
 
     Q_INVOKABLE virtual bool setUp(QString filePath) = 0;
+    Q_INVOKABLE virtual void cancelLoading() = 0;
+    virtual bool isLoading() const = 0;
+    virtual double getLoadingProgress() const = 0;
     virtual mupdf::FzDocument* getFzDocument() = 0;
+    virtual application::core::RenderScheduler* getRenderScheduler() = 0;
+    virtual application::core::RenderCache* getRenderCache() = 0;
+    virtual application::core::utils::TextPageCache* getTextPageCache() = 0;
+    virtual const application::core::PageGeometry& getPageGeometry() const = 0;
 
     Q_INVOKABLE virtual void search(const QString& text) = 0;
     Q_INVOKABLE virtual void clearSearch() = 0;
     Q_INVOKABLE virtual void goToNextSearchHit() = 0;
     Q_INVOKABLE virtual void goToPreviousSearchHit() = 0;
+    virtual const application::core::utils::SearchHits& getSearchHits()
+        const = 0;
+
+    /**
+     * How densely the search hits are spread over the book, as the relative
+     * hit count (0 to 1) of each of bucketCount equally sized page ranges.
+     */
+    Q_INVOKABLE virtual QList<qreal> getSearchHitDensity(
+        int bucketCount) const = 0;
 
     virtual const QList<domain::entities::Highlight>& getHighlights() const = 0;
     virtual void addHighlight(const domain::entities::Highlight& highlight) = 0;
@@ -55,6 +82,8 @@ public:
                                       const QColor& color) = 0;
     virtual const domain::entities::Highlight* getHighlightAtPoint(
         const QPointF& point, int page) const = 0;
+    virtual QList<const domain::entities::Highlight*> getHighlightsOfPage(
+        int page) const = 0;
 
     virtual const QList<domain::entities::Bookmark>& getBookmark() const = 0;
     Q_INVOKABLE virtual QString addBookmark(const QString& name, int pageNumber,
@@ -66,6 +95,11 @@ public:
 
     virtual void followLink(const char* uri) = 0;
 
+    Q_INVOKABLE virtual void prefetchPages(int currentPage,
+                                           float pagesPerSecond) = 0;
+    Q_INVOKABLE virtual void prefetchPage(int pageNumber) = 0;
+    virtual void prefetchLinkTarget(const char* uri) = 0;
+
     virtual QString getFilePath() const = 0;
     virtual void setCurrentPage(int newCurrentPage) = 0;
 
@@ -74,6 +108,7 @@ public:
 
     virtual float getZoom() const = 0;
     virtual void setZoom(float newZoom) = 0;
+    virtual void setDevicePixelRatio(double dpr) = 0;
 
     virtual bool getSearchWholeWords() const = 0;
     virtual void setSearchWholeWords(bool newSearchWholeWords) = 0;
@@ -81,6 +116,10 @@ public:
     virtual bool getSearchCaseSensitive() const = 0;
     virtual void setSearchCaseSensitive(bool newSearchCaseSensitive) = 0;
 
+    virtual bool getSearchRegularExpression() const = 0;
+    virtual void setSearchRegularExpression(
+        bool newSearchRegularExpression) = 0;
+
     virtual bool getSearchFromStart() const = 0;
     virtual void setSearchFromStart(bool newSearchFromStart) = 0;
 
@@ -92,6 +131,10 @@ public:
 
 signals:
     void filePathChanged(const QString& filePath);
+    void loadingChanged();
+    void loadingProgressChanged(double progress);
+    void loadingFinished();
+    void loadingFailed();
     void pageCountChanged(int pageCount);
     void currentPageChanged(int currentPage);
     void zoomChanged(float zoom);
@@ -101,8 +144,11 @@ signals:
     void textSelectionFinished(float centerX, float topY);
     void highlightSelected(float centerX, float topY, const QString& uuid);
     void noSearchHitsFound();
+    void searchHitsChanged();
+    void pageGeometryChanged();
     void searchWholeWordsChanged();
     void searchCaseSensitiveChanged();
+    void searchRegularExpressionChanged();
     void searchFromStartChanged();
     void bookmarksModelChanged();
     void colorThemeChanged(const QString& colorTheme);
@@ -0,0 +1,33 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QVariantList>
+#include "adapters_export.hpp"
+
+namespace adapters
+{
+
+/**
+ * The LibrarySearchController class is exposed to the UI code and thus is the
+ * "entry point" to the application's backend for searching the text of all
+ * books in the library.
+ */
+class ADAPTERS_EXPORT ILibrarySearchController : public QObject
+{
+    Q_OBJECT
+
+public:
+    virtual ~ILibrarySearchController() noexcept = default;
+
+    Q_INVOKABLE virtual void search(const QString& text) = 0;
+    Q_INVOKABLE virtual int getIndexedBookCount() const = 0;
+
+signals:
+    /**
+     * Every result is a map with the keys "uuid", "title", "pageNumber",
+     * "snippet" and "score", ordered from the most relevant book.
+     */
+    void searchResultsReady(const QString& text, const QVariantList& results);
+};
+
+}  // namespace adapters
@@ -1,12 +1,29 @@
 #pragma once
 #include <mupdf/classes.h>
+#include <QHash>
 #include <QImage>
 #include <QObject>
+#include <QPoint>
+#include <QRect>
 #include "adapters_export.hpp"
+#include "rendering/render_quality.hpp"
 
 namespace adapters
 {
 
+/**
+ * A part of a page that is rendered on its own at full resolution. Tiles are
+ * used at high zoom levels, at which rendering the whole page at once would
+ * require too much memory.
+ */
+struct PageTile
+{
+    // The area of the zoomed page in pixels, relative to its top left corner
+    QRect rect;
+    QImage image;
+    quint64 renderTicket = 0;
+};
+
 /**
  * The PageController is an interface for the UI to run operations on a page,
  * such as rendering, generating selections, etc.
@@ -20,6 +37,8 @@ public:
 
     virtual int getWidth() = 0;
     virtual int getHeight() = 0;
+    // The page's size without any zoom applied
+    virtual QSize getPageSize() const = 0;
 
     virtual int getXOffset() const = 0;
     virtual int getYOffset() const = 0;
@@ -27,9 +46,17 @@ public:
     virtual void setZoom(float zoom) = 0;
     virtual float getZoom() = 0;
 
-    virtual void setInvertColor(bool newInvertColor) = 0;
+    virtual void requestPageImage(
+        bool isVisible,
+        application::core::RenderQuality quality =
+            application::core::RenderQuality::Full) = 0;
+    virtual const QImage& getPageImage() const = 0;
+    virtual float getPageImageZoom() const = 0;
+    virtual bool pageImageIsOutdated() const = 0;
 
-    virtual QImage renderPage() = 0;
+    virtual void setVisibleArea(const QRectF& visibleArea) = 0;
+    virtual bool usesTiles() const = 0;
+    virtual const QHash<QPoint, PageTile>& getTiles() const = 0;
 
     virtual bool pointIsAboveText(const QPointF& point) = 0;
     virtual bool pointIsAboveLink(const QPointF& point) = 0;
@@ -47,7 +74,7 @@ public:
                                          const QPointF& end) = 0;
 
 signals:
-    void pageOffsetsChanged(int xOffset, int yOffset);
+    void pageImageChanged();
 };
 
 }  // namespace adapters
@@ -0,0 +1,123 @@
+#include "document_loader.hpp"
+#include <QDebug>
+#include "layout_cache.hpp"
+#include "page_generator.hpp"
+
+namespace application::core
+{
+
+DocumentLoader::DocumentLoader(QObject* parent) :
+    QObject(parent)
+{
+    // Opening a document can't be interrupted, so the previous book might
+    // still be opening when the next one is. The next one must not wait for it.
+    m_threadPool.setMaxThreadCount(2);
+}
+
+DocumentLoader::~DocumentLoader()
+{
+    cancel();
+    m_threadPool.waitForDone();
+}
+
+void DocumentLoader::load(const QString& filePath, const QString& cacheKey,
+                          int firstPage)
+{
+    auto generation = ++m_generation;
+
+    m_threadPool.start(
+        [this, filePath, cacheKey, firstPage, generation]()
+        {
+            LoadedDocument loadedDocument;
+            bool success = loadDocument(filePath, cacheKey, firstPage,
+                                        generation, loadedDocument);
+
+            // Deliver the result on the thread the loader lives in. It is
+            // dropped if loading was cancelled in the meantime.
+            QMetaObject::invokeMethod(
+                this,
+                [this, success, loadedDocument, generation]()
+                {
+                    if(generation != m_generation)
+                        return;
+
+                    if(success)
+                        emit documentLoaded(loadedDocument);
+                    else
+                        emit loadingFailed();
+                },
+                Qt::QueuedConnection);
+        });
+}
+
+void DocumentLoader::cancel()
+{
+    ++m_generation;
+}
+
+bool DocumentLoader::loadDocument(const QString& filePath,
+                                  const QString& cacheKey, int firstPage,
+                                  int generation,
+                                  LoadedDocument& loadedDocument)
+{
+    try
+    {
+        reportProgress(0, generation);
+        bool hasStoredLayout = LayoutCache::hasStoredLayout(filePath, cacheKey);
+        auto document = LayoutCache::openDocument(filePath, cacheKey);
+
+        // Counting the pages of a chapter lays it out, which is what takes
+        // long for reflowable documents. Fixed layout ones have one chapter.
+        // With a stored layout, the page counts are known without it.
+        int pageCount = 0;
+        int chapterCount = document.fz_count_chapters();
+        for(int chapter = 0; chapter < chapterCount; ++chapter)
+        {
+            if(generation != m_generation)
+                return false;
+
+            pageCount += document.fz_count_chapter_pages(chapter);
+            reportProgress(static_cast<double>(chapter + 1) / chapterCount,
+                           generation);
+        }
+
+        if(pageCount <= 0 || generation != m_generation)
+            return false;
+
+        if(!hasStoredLayout)
+            LayoutCache::storeLayout(document, cacheKey);
+
+        // Running the page the book is opened at is the most expensive part of
+        // showing it, do it here as well.
+        firstPage = qBound(0, firstPage, pageCount - 1);
+        PageGenerator pageGenerator(&document, firstPage);
+
+        loadedDocument = LoadedDocument {
+            .document = document,
+            .pageCount = pageCount,
+            .firstPage = firstPage,
+            .firstPageDisplayList = pageGenerator.getDisplayList(),
+        };
+    }
+    catch(...)
+    {
+        qWarning() << QString("Failed loading document at: %1").arg(filePath);
+        return false;
+    }
+
+    return true;
+}
+
+void DocumentLoader::reportProgress(double progress, int generation)
+{
+    QMetaObject::invokeMethod(
+        this,
+        [this, progress, generation]()
+        {
+            if(generation == m_generation)
+                emit loadingProgressChanged(progress);
+        },
+        Qt::QueuedConnection);
+}
+
+}  // namespace application::core
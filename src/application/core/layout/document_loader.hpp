@@ -0,0 +1,76 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include "application_export.hpp"
+#include "mupdf/classes.h"
+
+namespace application::core
+{
+
+/**
+ * A document that was opened and laid out by the DocumentLoader, together with
+ * the display list of the page that is shown first, so that it can be
+ * rendered right away.
+ */
+struct LoadedDocument
+{
+    mupdf::FzDocument document;
+    int pageCount = 0;
+    int firstPage = 0;
+    mupdf::FzDisplayList firstPageDisplayList;
+};
+
+/**
+ * The DocumentLoader opens a book's FzDocument without blocking the GUI thread.
+ *
+ * Opening a document can take a long time, e.g. when MuPDF needs to repair the
+ * broken xref table of a large PDF, or when a long EPUB needs to be laid out.
+ * The layout happens one chapter at a time, which is reported as the loading
+ * progress and allows cancelling the loading in between. Once the document
+ * was laid out, the layout is stored in the LayoutCache, so that opening the
+ * book the next time is instant.
+ *
+ * Once the document is ready, it is handed over to the thread the loader lives
+ * in and must only be used from there afterwards.
+ *
+ * The document is only handed over once all chapters were counted, not once
+ * the chapter of the first page is known. FzDocuments must not be used from
+ * two threads, so the remaining chapters could not be counted in the
+ * background afterwards, and the page count is needed right away, e.g. for
+ * laying out the pages and for the reading progress.
+ */
+class APPLICATION_EXPORT DocumentLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DocumentLoader(QObject* parent = nullptr);
+    ~DocumentLoader();
+
+    /**
+     * The cache key identifies the book's stored layout, e.g. the file's hash.
+     * The first page is the one the book is opened at, its display list is
+     * prepared along with the document. Loading a new document cancels
+     * loading the previous one.
+     */
+    void load(const QString& filePath, const QString& cacheKey, int firstPage);
+    void cancel();
+
+signals:
+    void loadingProgressChanged(double progress);
+    void documentLoaded(const application::core::LoadedDocument& document);
+    void loadingFailed();
+
+private:
+    bool loadDocument(const QString& filePath, const QString& cacheKey,
+                      int firstPage, int generation,
+                      LoadedDocument& loadedDocument);
+    void reportProgress(double progress, int generation);
+
+    QThreadPool m_threadPool;
+    std::atomic<int> m_generation = 0;
+};
+
+}  // namespace application::core
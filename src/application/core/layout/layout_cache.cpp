@@ -0,0 +1,131 @@
+#include "layout_cache.hpp"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QTemporaryFile>
+#include "mupdf/classes2.h"
+
+namespace application::core
+{
+
+mupdf::FzDocument LayoutCache::openDocument(const QString& filePath,
+                                            const QString& cacheKey,
+                                            const LayoutParameters& parameters)
+{
+    auto stdFilePath = filePath.toStdString();
+    auto layoutFilePath = getLayoutFilePath(cacheKey, parameters);
+
+    mupdf::FzDocument document;
+    try
+    {
+        // Opens the document normally if there is no stored layout
+        auto stdLayoutFilePath = layoutFilePath.toStdString();
+        document = mupdf::fz_open_accelerated_document(
+            stdFilePath.c_str(), stdLayoutFilePath.c_str());
+    }
+    catch(...)
+    {
+        qWarning() << QString("Discarding stored layout at: %1")
+                          .arg(layoutFilePath);
+        QFile::remove(layoutFilePath);
+        document = mupdf::FzDocument(stdFilePath.c_str());
+    }
+
+    if(document.fz_is_document_reflowable())
+    {
+        document.fz_layout_document(parameters.width, parameters.height,
+                                    parameters.fontSize);
+    }
+
+    return document;
+}
+
+void LayoutCache::storeLayout(mupdf::FzDocument& document,
+                              const QString& cacheKey,
+                              const LayoutParameters& parameters)
+{
+    if(!document.fz_document_supports_accelerator())
+        return;
+
+    // MuPDF writes the file itself, so it is written to a temporary file
+    // first and then moved into place, so that no partial layout is read.
+    auto layoutFilePath = getLayoutFilePath(cacheKey, parameters);
+    QTemporaryFile tempFile(layoutFilePath + ".XXXXXX");
+    if(!tempFile.open())
+    {
+        qWarning() << QString("Storing layout failed. "
+                              "Failed opening file at: %1")
+                          .arg(layoutFilePath);
+        return;
+    }
+    tempFile.close();
+
+    try
+    {
+        auto stdTempFilePath = tempFile.fileName().toStdString();
+        document.fz_save_accelerator(stdTempFilePath.c_str());
+    }
+    catch(...)
+    {
+        qWarning() << QString("Storing layout failed. "
+                              "Failed writing file at: %1")
+                          .arg(layoutFilePath);
+        return;
+    }
+
+    QFile::remove(layoutFilePath);
+    if(!tempFile.rename(layoutFilePath))
+    {
+        qWarning() << QString("Storing layout failed. "
+                              "Failed moving file to: %1")
+                          .arg(layoutFilePath);
+    }
+}
+
+bool LayoutCache::hasStoredLayout(const QString& filePath,
+                                  const QString& cacheKey,
+                                  const LayoutParameters& parameters)
+{
+    // Same check as MuPDF does, a layout older than the book is outdated
+    QFileInfo layoutFileInfo(getLayoutFilePath(cacheKey, parameters));
+    return layoutFileInfo.exists() &&
+           layoutFileInfo.lastModified() >= QFileInfo(filePath).lastModified();
+}
+
+void LayoutCache::removeLayouts(const QString& cacheKey)
+{
+    QDir dir(getLayoutDirPath(cacheKey));
+    if(dir.exists() && !dir.removeRecursively())
+    {
+        qWarning() << QString("Failed removing stored layouts at: %1")
+                          .arg(dir.path());
+    }
+}
+
+QString LayoutCache::getLayoutDirPath(const QString& cacheKey)
+{
+    QDir dir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+
+    // The key might contain characters which are not allowed in file names
+    auto hash = QCryptographicHash::hash(cacheKey.toUtf8(),
+                                         QCryptographicHash::Sha1);
+    return dir.filePath("layout/" + QString::fromLatin1(hash.toHex()));
+}
+
+QString LayoutCache::getLayoutFilePath(const QString& cacheKey,
+                                       const LayoutParameters& parameters)
+{
+    QDir dir(getLayoutDirPath(cacheKey));
+    dir.mkpath(".");
+
+    auto fileName = QString("%1x%2_%3.accel")
+                        .arg(parameters.width)
+                        .arg(parameters.height)
+                        .arg(parameters.fontSize);
+    return dir.filePath(fileName);
+}
+
+}  // namespace application::core
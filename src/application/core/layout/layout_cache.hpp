@@ -0,0 +1,70 @@
+#pragma once
+#include <QString>
+#include "application_export.hpp"
+#include "mupdf/classes.h"
+
+namespace application::core
+{
+
+/**
+ * The page size and font size that reflowable documents (e.g. EPUBs) are laid
+ * out with. The defaults are the ones MuPDF uses when nothing else is set.
+ */
+struct LayoutParameters
+{
+    float width = 450;
+    float height = 600;
+    float fontSize = 12;
+};
+
+/**
+ * The LayoutCache keeps the result of laying out a book's document, so that
+ * it is not laid out again every time the book is opened.
+ *
+ * MuPDF has to lay out every chapter of a reflowable document before it knows
+ * the page count or where a page is, which takes long for big EPUBs. Damaged
+ * PDFs similarly need to be repaired before their pages can be found. MuPDF
+ * can store what it found out in an "accelerator" file (e.g. the page count
+ * of every chapter) and skip that work when the document is opened with it.
+ *
+ * There is a separate file for every book and set of layout parameters, so
+ * switching between them is instant once each was used before. The files of
+ * a book are kept in a directory of their own. A file is ignored by MuPDF
+ * once the book's file is newer than it.
+ *
+ * Every FzDocument of a book should be opened through openDocument(), so that
+ * all of them are laid out the same way and agree on the page numbers.
+ */
+class APPLICATION_EXPORT LayoutCache
+{
+public:
+    static mupdf::FzDocument openDocument(
+        const QString& filePath, const QString& cacheKey,
+        const LayoutParameters& parameters = LayoutParameters());
+
+    /**
+     * Stores the layout of a document that was fully laid out, i.e. whose
+     * pages were counted. Does nothing if the document's format does not
+     * support storing it.
+     */
+    static void storeLayout(
+        mupdf::FzDocument& document, const QString& cacheKey,
+        const LayoutParameters& parameters = LayoutParameters());
+
+    static bool hasStoredLayout(
+        const QString& filePath, const QString& cacheKey,
+        const LayoutParameters& parameters = LayoutParameters());
+
+    /**
+     * Removes the stored layouts of a book for all layout parameters, e.g.
+     * once the book's file was removed.
+     */
+    static void removeLayouts(const QString& cacheKey);
+
+private:
+    static QString getLayoutDirPath(const QString& cacheKey);
+    static QString getLayoutFilePath(const QString& cacheKey,
+                                     const LayoutParameters& parameters);
+};
+
+}  // namespace application::core
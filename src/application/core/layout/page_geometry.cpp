@@ -0,0 +1,130 @@
+#include "page_geometry.hpp"
+#include <QJsonValue>
+#include <algorithm>
+#include <cmath>
+
+namespace application::core
+{
+
+PageGeometry::PageGeometry(QList<QSize> pageSizes) :
+    m_pageSizes(std::move(pageSizes))
+{
+    updateOffsets(0);
+}
+
+bool PageGeometry::isEmpty() const
+{
+    return m_pageSizes.isEmpty();
+}
+
+int PageGeometry::getPageCount() const
+{
+    return m_pageSizes.size();
+}
+
+const QList<QSize>& PageGeometry::getPageSizes() const
+{
+    return m_pageSizes;
+}
+
+QSize PageGeometry::getPageSize(int pageNumber) const
+{
+    if(pageNumber < 0 || pageNumber >= m_pageSizes.size())
+        return QSize();
+
+    return m_pageSizes[pageNumber];
+}
+
+void PageGeometry::setPageSize(int pageNumber, const QSize& pageSize)
+{
+    if(pageNumber < 0 || pageNumber >= m_pageSizes.size() ||
+       m_pageSizes[pageNumber] == pageSize)
+    {
+        return;
+    }
+
+    m_pageSizes[pageNumber] = pageSize;
+    updateOffsets(pageNumber);
+}
+
+int PageGeometry::getMaxPageWidth() const
+{
+    return m_maxPageWidth;
+}
+
+double PageGeometry::getPageTop(int pageNumber, float zoom,
+                                double spacing) const
+{
+    pageNumber = std::clamp(pageNumber, 0, getPageCount());
+
+    return m_heightOffsets[pageNumber] * zoom + pageNumber * spacing;
+}
+
+double PageGeometry::getContentHeight(float zoom, double spacing) const
+{
+    if(isEmpty())
+        return 0;
+
+    // There is no spacing after the last page
+    return getPageTop(getPageCount(), zoom, spacing) - spacing;
+}
+
+int PageGeometry::getPageAtY(double y, float zoom, double spacing) const
+{
+    if(isEmpty())
+        return -1;
+
+    // The last page starting above the given position. The page tops are
+    // monotonic, so they can be searched without computing all of them.
+    auto pageCount = getPageCount();
+    int low = 0;
+    int high = pageCount;
+    while(low < high)
+    {
+        auto middle = low + (high - low) / 2;
+        if(getPageTop(middle, zoom, spacing) <= y)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return std::clamp(low - 1, 0, pageCount - 1);
+}
+
+QJsonArray PageGeometry::toJson() const
+{
+    QJsonArray jsonPages;
+    for(auto& pageSize : m_pageSizes)
+        jsonPages.append(QJsonArray { pageSize.width(), pageSize.height() });
+
+    return jsonPages;
+}
+
+PageGeometry PageGeometry::fromJson(const QJsonArray& jsonPages)
+{
+    QList<QSize> pageSizes;
+    pageSizes.reserve(jsonPages.size());
+    for(const auto& jsonPage : jsonPages)
+    {
+        auto jsonSize = jsonPage.toArray();
+        if(jsonSize.size() != 2)
+            return PageGeometry();
+
+        pageSizes.append(QSize(jsonSize[0].toInt(), jsonSize[1].toInt()));
+    }
+
+    return PageGeometry(std::move(pageSizes));
+}
+
+void PageGeometry::updateOffsets(int fromPage)
+{
+    m_heightOffsets.resize(m_pageSizes.size() + 1);
+    for(int i = fromPage; i < m_pageSizes.size(); ++i)
+        m_heightOffsets[i + 1] = m_heightOffsets[i] + m_pageSizes[i].height();
+
+    m_maxPageWidth = 0;
+    for(auto& pageSize : m_pageSizes)
+        m_maxPageWidth = std::max(m_maxPageWidth, pageSize.width());
+}
+
+}  // namespace application::core
@@ -0,0 +1,55 @@
+#pragma once
+#include <QJsonArray>
+#include <QList>
+#include <QSize>
+#include <vector>
+#include "application_export.hpp"
+
+namespace application::core
+{
+
+/**
+ * The PageGeometry is the table of all page sizes of a book (without any zoom
+ * applied), from which the position of every page in the continuous document
+ * layout can be computed without loading the page.
+ *
+ * The page heights are prefix summed, so the top of any page at any zoom and
+ * page spacing is computed in constant time and the page at a given position
+ * is found with a binary search.
+ */
+class APPLICATION_EXPORT PageGeometry
+{
+public:
+    PageGeometry() = default;
+    explicit PageGeometry(QList<QSize> pageSizes);
+
+    bool isEmpty() const;
+    int getPageCount() const;
+    const QList<QSize>& getPageSizes() const;
+    QSize getPageSize(int pageNumber) const;
+    void setPageSize(int pageNumber, const QSize& pageSize);
+    int getMaxPageWidth() const;
+
+    /**
+     * The positions are in the zoomed document layout, where the pages are
+     * placed below each other with the given spacing between them.
+     */
+    double getPageTop(int pageNumber, float zoom, double spacing) const;
+    double getContentHeight(float zoom, double spacing) const;
+    int getPageAtY(double y, float zoom, double spacing) const;
+
+    QJsonArray toJson() const;
+    static PageGeometry fromJson(const QJsonArray& jsonPages);
+
+private:
+    void updateOffsets(int fromPage);
+
+    QList<QSize> m_pageSizes;
+
+    // The sum of the heights of all pages above a page, the last element is
+    // the height of all pages together.
+    std::vector<qint64> m_heightOffsets { 0 };
+    int m_maxPageWidth = 0;
+};
+
+}  // namespace application::core
@@ -0,0 +1,168 @@
+#include "page_geometry_loader.hpp"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include "layout_cache.hpp"
+#include "mupdf/classes.h"
+
+namespace application::core
+{
+
+PageGeometryLoader::PageGeometryLoader(QObject* parent) :
+    QObject(parent)
+{
+    // Loading the pages of two books at the same time is never useful
+    m_threadPool.setMaxThreadCount(1);
+}
+
+PageGeometryLoader::~PageGeometryLoader()
+{
+    cancel();
+    m_threadPool.waitForDone();
+}
+
+void PageGeometryLoader::load(const QString& filePath, const QString& cacheKey)
+{
+    auto generation = ++m_generation;
+    auto cacheFilePath = getCacheFilePath(cacheKey);
+
+    m_threadPool.start(
+        [this, filePath, cacheKey, cacheFilePath, generation]()
+        {
+            auto geometry = loadFromCache(filePath, cacheFilePath);
+            if(geometry.isEmpty())
+            {
+                geometry = computePageGeometry(filePath, cacheKey, generation);
+                if(geometry.isEmpty())
+                    return;
+
+                saveToCache(geometry, filePath, cacheFilePath);
+            }
+
+            // Deliver the result on the thread the loader lives in. It is
+            // dropped if a different book was loaded in the meantime.
+            QMetaObject::invokeMethod(
+                this,
+                [this, geometry, generation]()
+                {
+                    if(generation == m_generation)
+                        emit pageGeometryLoaded(geometry);
+                },
+                Qt::QueuedConnection);
+        });
+}
+
+void PageGeometryLoader::cancel()
+{
+    ++m_generation;
+}
+
+PageGeometry PageGeometryLoader::loadFromCache(
+    const QString& filePath, const QString& cacheFilePath) const
+{
+    QFile cacheFile(cacheFilePath);
+    if(!cacheFile.open(QFile::ReadOnly))
+        return PageGeometry();
+
+    auto jsonObject = QJsonDocument::fromJson(cacheFile.readAll()).object();
+
+    // The stored geometry is outdated if the book's file changed since
+    QFileInfo fileInfo(filePath);
+    auto lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+    if(jsonObject["fileSize"].toInteger() != fileInfo.size() ||
+       jsonObject["lastModified"].toInteger() != lastModified)
+    {
+        return PageGeometry();
+    }
+
+    return PageGeometry::fromJson(jsonObject["pages"].toArray());
+}
+
+void PageGeometryLoader::saveToCache(const PageGeometry& geometry,
+                                     const QString& filePath,
+                                     const QString& cacheFilePath) const
+{
+    QFileInfo fileInfo(filePath);
+    QJsonObject jsonObject {
+        { "fileSize", fileInfo.size() },
+        { "lastModified", fileInfo.lastModified().toMSecsSinceEpoch() },
+        { "pages", geometry.toJson() },
+    };
+
+    // Written to a temporary file first, so that no partial geometry is read
+    QSaveFile cacheFile(cacheFilePath);
+    if(!cacheFile.open(QFile::WriteOnly))
+    {
+        qWarning() << QString("Saving page geometry failed. "
+                              "Failed opening file at: %1")
+                          .arg(cacheFilePath);
+        return;
+    }
+
+    cacheFile.write(QJsonDocument(jsonObject).toJson(QJsonDocument::Compact));
+    if(!cacheFile.commit())
+    {
+        qWarning() << QString("Saving page geometry failed. "
+                              "Failed writing file at: %1")
+                          .arg(cacheFilePath);
+    }
+}
+
+PageGeometry PageGeometryLoader::computePageGeometry(const QString& filePath,
+                                                     const QString& cacheKey,
+                                                     int generation) const
+{
+    QList<QSize> pageSizes;
+    try
+    {
+        auto document = LayoutCache::openDocument(filePath, cacheKey);
+
+        auto pageCount = document.fz_count_pages();
+        pageSizes.reserve(pageCount);
+        for(int i = 0; i < pageCount; ++i)
+        {
+            if(generation != m_generation)
+                return PageGeometry();
+
+            // Same as the size the PageGenerator computes for the page
+            auto page = document.fz_load_page(i);
+            auto pageBox = page.fz_bound_page_box(FZ_CROP_BOX);
+            pageSizes.append(QSize(pageBox.x1 - pageBox.x0,
+                                   pageBox.y1 - pageBox.y0));
+        }
+    }
+    catch(...)
+    {
+        qWarning() << QString("Failed computing page geometry of book at: %1")
+                          .arg(filePath);
+        return PageGeometry();
+    }
+
+    return PageGeometry(std::move(pageSizes));
+}
+
+void PageGeometryLoader::removeFromCache(const QString& cacheKey)
+{
+    QFile::remove(getCacheFilePath(cacheKey));
+}
+
+QString PageGeometryLoader::getCacheFilePath(const QString& cacheKey)
+{
+    QDir dir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+    dir.mkpath("page_geometry");
+    dir.cd("page_geometry");
+
+    // The key might contain characters which are not allowed in file names
+    auto hash = QCryptographicHash::hash(cacheKey.toUtf8(),
+                                         QCryptographicHash::Sha1);
+    return dir.filePath(QString::fromLatin1(hash.toHex()) + ".json");
+}
+
+}  // namespace application::core
@@ -0,0 +1,62 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include "application_export.hpp"
+#include "page_geometry.hpp"
+
+namespace application::core
+{
+
+/**
+ * The PageGeometryLoader gets the PageGeometry of a book without blocking the
+ * GUI thread.
+ *
+ * Computing the geometry requires loading every page of the book, so once it
+ * was computed it is stored in a small file in the app's data directory and
+ * only read from there the next time the book is opened. The stored geometry
+ * is invalidated when the book's file changes.
+ *
+ * The pages are loaded from a separate FzDocument on a background thread,
+ * since the book's own FzDocument must only be used from the GUI thread.
+ */
+class APPLICATION_EXPORT PageGeometryLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PageGeometryLoader(QObject* parent = nullptr);
+    ~PageGeometryLoader();
+
+    /**
+     * The cache key identifies the book's geometry file, e.g. the file's hash.
+     * Loading a new book cancels loading the previous one.
+     */
+    void load(const QString& filePath, const QString& cacheKey);
+    void cancel();
+
+    /**
+     * Removes the stored geometry of a book, e.g. once the book's file was
+     * removed.
+     */
+    static void removeFromCache(const QString& cacheKey);
+
+signals:
+    void pageGeometryLoaded(const application::core::PageGeometry& geometry);
+
+private:
+    PageGeometry loadFromCache(const QString& filePath,
+                               const QString& cacheFilePath) const;
+    void saveToCache(const PageGeometry& geometry, const QString& filePath,
+                     const QString& cacheFilePath) const;
+    PageGeometry computePageGeometry(const QString& filePath,
+                                     const QString& cacheKey,
+                                     int generation) const;
+    static QString getCacheFilePath(const QString& cacheKey);
+
+    QThreadPool m_threadPool;
+    std::atomic<int> m_generation = 0;
+};
+
+}  // namespace application::core
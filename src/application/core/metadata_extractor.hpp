@@ -1,12 +1,13 @@
 #pragma once
 #include <memory>
+#include "application_export.hpp"
 #include "i_metadata_extractor.hpp"
 #include "mupdf/classes.h"
 
 namespace application::core
 {
 
-class MetadataExtractor : public IMetadataExtractor
+class APPLICATION_EXPORT MetadataExtractor : public IMetadataExtractor
 {
 public:
     bool setup(const QString& filePath) override;
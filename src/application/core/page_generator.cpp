@@ -10,128 +10,220 @@ namespace application::core
 {
 
 using utils::FzPointPair;
+using utils::TextPageCache;
 
 application::core::PageGenerator::PageGenerator(mupdf::FzDocument* document,
-                                                int pageNumber) :
+                                                int pageNumber,
+                                                RenderCache* renderCache,
+                                                TextPageCache* textPageCache) :
     m_document(document),
+    m_pageNumber(pageNumber),
+    m_renderCache(renderCache),
+    m_textPageCache(textPageCache),
     m_textSelector(nullptr)
 {
     m_page =
         std::make_unique<mupdf::FzPage>(m_document->fz_load_page(pageNumber));
-    auto boundPage = m_page->fz_bound_page();
+    m_pageBox = m_page->fz_bound_page_box(FZ_CROP_BOX);
 
-    setupDisplayList(boundPage);
-    setupTextPage(pageNumber);
-    setupSymbolBounds();
-    setupLinks();
-
-    m_textSelector = utils::TextSelector(m_textPage.get());
+    setupPageOffsets();
 }
 
-void PageGenerator::setupDisplayList(const mupdf::FzRect& boundPage)
+void PageGenerator::setupDisplayList()
 {
-    m_displayList = mupdf::FzDisplayList(boundPage);
+    // Running the page is the most expensive part of setting up a page, so
+    // reuse the display list if the page was set up before.
+    if(m_renderCache != nullptr)
+    {
+        auto cachedDisplayList = m_renderCache->getDisplayList(m_pageNumber);
+        if(cachedDisplayList.has_value())
+        {
+            m_displayList = *cachedDisplayList;
+            return;
+        }
+    }
+
+    m_displayList = mupdf::FzDisplayList(m_page->fz_bound_page());
 
     auto listDevice = m_displayList.fz_new_list_device();
     mupdf::FzCookie defaultCookie;
     m_page->fz_run_page(listDevice, mupdf::FzMatrix(), defaultCookie);
     listDevice.fz_close_device();
+
+    if(m_renderCache != nullptr)
+        m_renderCache->insertDisplayList(m_pageNumber, m_displayList);
 }
 
-void PageGenerator::setupTextPage(int pageNumber)
+void PageGenerator::setupTextPage()
 {
-    mupdf::FzStextOptions options;
-    m_textPage =
-        std::make_unique<mupdf::FzStextPage>(*m_document, pageNumber, options);
+    // Extract the text from the display list instead of running the page again
+    auto extractTextPage = [this]()
+    {
+        mupdf::FzStextOptions options;
+        auto displayList = getDisplayList();
+        return std::make_shared<mupdf::FzStextPage>(displayList, options);
+    };
+
+    // Pages are set up on the GUI thread, so it must not wait for a search
+    // that is extracting the same page in the background.
+    if(m_textPageCache != nullptr)
+        m_textPage = m_textPageCache->getTextPageWithoutWaiting(
+            m_pageNumber, extractTextPage);
+    else
+        m_textPage = extractTextPage();
+
+    m_textSelector = utils::TextSelector(m_textPage.get());
+    m_textSelector.setPageXOffset(m_pageXOffset);
+    m_textSelector.setPageYOffset(m_pageYOffset);
 }
 
 void PageGenerator::setupSymbolBounds()
 {
+    if(m_textPage == nullptr)
+        setupTextPage();
+
     auto curr = m_textPage->begin();
     auto end = m_textPage->end();
 
-    m_symbolBounds.resize(100);
+    int index = 0;
     while(curr != end)
     {
         auto symbol = curr;
         fz_rect rect = symbol->m_internal->bbox;
-        m_symbolBounds.emplace_back(rect);
+        m_symbolIndex.insert(index++, QRectF(rect.x0 - m_pageXOffset,
+                                             rect.y0 - m_pageYOffset,
+                                             rect.x1 - rect.x0,
+                                             rect.y1 - rect.y0));
         ++curr;
     }
+
+    m_symbolBoundsLoaded = true;
 }
 
 void PageGenerator::setupLinks()
 {
-    auto end = m_page->fz_load_links().end();
-    auto curr = m_page->fz_load_links().begin();
-    while(curr != end)
+    auto links = m_page->fz_load_links();
+    for(auto curr = links.begin(); curr != links.end(); ++curr)
     {
-        m_links.push_back(*curr);
-        ++curr;
+        auto link = *curr;
+        auto newLinkRect =
+            utils::moveRect(link.rect(), m_pageXOffset, m_pageYOffset);
+        link.fz_set_link_rect(newLinkRect);
+
+        m_linkIndex.insert(m_links.size(), utils::fzRectToQRectF(newLinkRect));
+        m_links.push_back(link);
     }
+
+    m_linksLoaded = true;
+}
+
+utils::TextSelector& PageGenerator::getTextSelector()
+{
+    if(m_textPage == nullptr)
+        setupTextPage();
+
+    return m_textSelector;
+}
+
+void PageGenerator::setupPageOffsets()
+{
+    // The offsets are the position of the page's crop box at a zoom of 1,
+    // they are the same ones that a pixmap of the page would be positioned at.
+    auto bbox = getPageBox().fz_round_rect();
+    if(bbox.x0 != 0 && bbox.y0 != 0)
+        setPageOffsets(bbox.x0, bbox.y0);
 }
 
-mupdf::FzPixmap PageGenerator::renderPage(float zoom)
+QImage PageGenerator::renderPage(float zoom)
+{
+    // A one-off render, so there is nothing worth pooling
+    mupdf::FzCookie cookie;
+    PixmapPool pixmapPool(0);
+    return renderDisplayList(getDisplayList(), getPageBox(), zoom, cookie,
+                             pixmapPool);
+}
+
+QImage PageGenerator::renderDisplayList(mupdf::FzDisplayList displayList,
+                                        const mupdf::FzRect& pageBox,
+                                        float zoom, mupdf::FzCookie& cookie,
+                                        PixmapPool& pixmapPool,
+                                        const QRect& region,
+                                        RenderQuality quality)
 {
     // Create matrix with zoom
     mupdf::FzMatrix matrix;
     matrix.a = zoom;
     matrix.d = zoom;
 
-    auto pixmap = getEmptyPixmap(matrix);
-    auto drawDevice = mupdf::fz_new_draw_device(mupdf::FzMatrix(), pixmap);
-
-    // Determine the page offset the first time we render the page
-    if(m_pageXOffset == 0 && m_pageYOffset == 0)
+    auto bbox = pageBox.fz_transform_rect(matrix).fz_round_rect();
+    mupdf::FzRect rect = mupdf::FzRect::Fixed_INFINITE;
+    if(!region.isNull())
     {
-        int restoredXOffset = round(pixmap.x() / zoom);
-        int restoredYOffset = round(pixmap.y() / zoom);
-        if(restoredXOffset != 0 && restoredYOffset != 0)
-        {
-            setPageOffsets(restoredXOffset, restoredYOffset);
-
-            std::vector<fz_rect> newSymbolBounds;
-            for(auto& rect : m_symbolBounds)
-            {
-                auto newRect = fz_make_rect(
-                    rect.x0 - m_pageXOffset, rect.y0 - m_pageYOffset,
-                    rect.x1 - m_pageXOffset, rect.y1 - m_pageYOffset);
-
-                newSymbolBounds.emplace_back(newRect);
-            }
-            m_symbolBounds = newSymbolBounds;
-
-            for(auto& link : m_links)
-            {
-                auto newLinkRect =
-                    utils::moveRect(link.rect(), m_pageXOffset, m_pageYOffset);
-                link.fz_set_link_rect(newLinkRect);
-            }
-        }
+        // The region is relative to the zoomed page's top left corner, but the
+        // pixmap needs to be positioned in the zoomed page's coordinates.
+        auto regionBbox = mupdf::fz_make_irect(
+            bbox.x0 + region.left(), bbox.y0 + region.top(),
+            bbox.x0 + region.left() + region.width(),
+            bbox.y0 + region.top() + region.height());
+        bbox = mupdf::fz_intersect_irect(regionBbox, bbox);
+
+        // Skip everything outside of the region while replaying the list
+        rect = mupdf::fz_rect_from_irect(bbox);
     }
 
-    mupdf::FzCookie cookie;
-    mupdf::FzRect rect = mupdf::FzRect::Fixed_INFINITE;
-    m_displayList.fz_run_display_list(drawDevice, matrix, rect, cookie);
+    auto image =
+        pixmapPool.createImage(QSize(bbox.x1 - bbox.x0, bbox.y1 - bbox.y0));
+    if(image.isNull())
+        return image;
+
+    // An RGB pixmap with alpha has 4 bytes per pixel and is premultiplied,
+    // just like the image, so MuPDF can draw into the image's bits directly.
+    // The pixmap only borrows the bits, it does not free them.
+    mupdf::FzPixmap pixmap(mupdf::FzColorspace::Fixed_RGB, bbox,
+                           mupdf::FzSeparations(), 1, image.bits());
+    pixmap.fz_clear_pixmap_with_value(0xff);
+
+    bool isDraft = quality == RenderQuality::Draft;
+    DraftQualityScope draftQualityScope(isDraft);
+
+    auto drawDevice = mupdf::fz_new_draw_device(mupdf::FzMatrix(), pixmap);
+    if(isDraft)
+        drawDevice.fz_enable_device_hints(FZ_DONT_INTERPOLATE_IMAGES);
+
+    displayList.fz_run_display_list(drawDevice, matrix, rect, cookie);
     drawDevice.fz_close_device();
 
-    if(m_invertColor)
-        pixmap.fz_invert_pixmap();
+    return image;
+}
+
+PageGenerator::DraftQualityScope::DraftQualityScope(bool enabled) :
+    m_enabled(enabled)
+{
+    if(!m_enabled)
+        return;
 
-    return pixmap;
+    m_aaLevel = mupdf::fz_aa_level();
+    mupdf::fz_set_aa_level(draftAaLevel);
+
+    m_iccWasDisabled = iccDisabled;
+    mupdf::fz_disable_icc();
+    iccDisabled = true;
 }
 
-mupdf::FzPixmap PageGenerator::getEmptyPixmap(
-    const mupdf::FzMatrix& matrix) const
+PageGenerator::DraftQualityScope::~DraftQualityScope()
 {
-    auto bbox = m_page->fz_bound_page_box(FZ_CROP_BOX);
-    auto scaledBbox = bbox.fz_transform_rect(matrix);
+    if(!m_enabled)
+        return;
 
-    mupdf::FzPixmap pixmap(mupdf::FzColorspace::Fixed_RGB, scaledBbox,
-                           mupdf::FzSeparations(), 0);
-    pixmap.fz_clear_pixmap();
+    mupdf::fz_set_aa_level(m_aaLevel);
+    if(m_iccWasDisabled)
+        return;
 
-    return pixmap;
+    // Without ICC support it can't be enabled in the first place
+#if FZ_ENABLE_ICC
+    mupdf::fz_enable_icc();
+#endif
+    iccDisabled = false;
 }
 
 void PageGenerator::setPageOffsets(int xOffset, int yOffset)
@@ -143,24 +235,14 @@ void PageGenerator::setPageOffsets(int xOffset, int yOffset)
     m_textSelector.setPageYOffset(yOffset);
 }
 
-void imageCleanupHandler(void* data)
-{
-    unsigned char* samples = static_cast<unsigned char*>(data);
-    delete[] samples;
-}
-
 int PageGenerator::getWidth() const
 {
-    auto bbox = m_page->fz_bound_page_box(FZ_CROP_BOX);
-
-    return (bbox.x1 - bbox.x0);
+    return (m_pageBox.x1 - m_pageBox.x0);
 }
 
 int PageGenerator::getHeight() const
 {
-    auto bbox = m_page->fz_bound_page_box(FZ_CROP_BOX);
-
-    return (bbox.y1 - bbox.y0);
+    return (m_pageBox.y1 - m_pageBox.y0);
 }
 
 int PageGenerator::getPageXOffset() const
@@ -178,68 +260,69 @@ QList<mupdf::FzQuad>& PageGenerator::getBufferedSelectionRects()
     return m_bufferedSelectionRects;
 }
 
-void PageGenerator::setInvertColor(bool newInvertColor)
+mupdf::FzDisplayList PageGenerator::getDisplayList()
 {
-    if(m_invertColor == newInvertColor)
-        return;
+    if(m_displayList.m_internal == nullptr)
+        setupDisplayList();
+
+    return m_displayList;
+}
 
-    m_invertColor = newInvertColor;
+mupdf::FzRect PageGenerator::getPageBox() const
+{
+    return m_pageBox;
 }
 
 void PageGenerator::generateSelectionRects(mupdf::FzPoint start,
                                            mupdf::FzPoint end)
 {
-    m_textSelector.generateSelectionRects(m_bufferedSelectionRects, start, end);
+    getTextSelector().generateSelectionRects(m_bufferedSelectionRects, start,
+                                             end);
 }
 
 FzPointPair PageGenerator::getPositionsForWordSelection(mupdf::FzPoint begin,
                                                         mupdf::FzPoint end)
 {
-    return m_textSelector.getPositionsForWordSelection(begin, end);
+    return getTextSelector().getPositionsForWordSelection(begin, end);
 }
 
 FzPointPair PageGenerator::getPositionsForLineSelection(mupdf::FzPoint point)
 {
-    return m_textSelector.getPositionsForLineSelection(point);
+    return getTextSelector().getPositionsForLineSelection(point);
 }
 
 std::string PageGenerator::getTextFromSelection(mupdf::FzPoint start,
                                                 mupdf::FzPoint end)
 {
-    return m_textSelector.getTextFromSelection(start, end);
+    return getTextSelector().getTextFromSelection(start, end);
 }
 
 bool PageGenerator::pointIsAboveText(mupdf::FzPoint point)
 {
-    for(auto& rect : m_symbolBounds)
-    {
-        if(point.fz_is_point_inside_rect(rect))
-            return true;
-    }
+    if(!m_symbolBoundsLoaded)
+        setupSymbolBounds();
 
-    return false;
+    return m_symbolIndex.containsItemAt(QPointF(point.x, point.y));
 }
 
 bool PageGenerator::pointIsAboveLink(mupdf::FzPoint point)
 {
-    for(auto& link : m_links)
-    {
-        if(point.fz_is_point_inside_rect(link.rect()))
-            return true;
-    }
+    if(!m_linksLoaded)
+        setupLinks();
 
-    return false;
+    return m_linkIndex.containsItemAt(QPointF(point.x, point.y));
 }
 
 mupdf::FzLink PageGenerator::getLinkAtPoint(mupdf::FzPoint point)
 {
-    for(auto& link : m_links)
-    {
-        if(point.fz_is_point_inside_rect(link.rect()))
-            return link;
-    }
+    if(!m_linksLoaded)
+        setupLinks();
+
+    auto index = m_linkIndex.itemAt(QPointF(point.x, point.y));
+    if(!index.has_value())
+        return mupdf::FzLink();
 
-    return mupdf::FzLink();
+    return m_links.at(*index);
 }
 
 }  // namespace application::core
@@ -1,11 +1,18 @@
 #pragma once
+#include <QImage>
 #include <QList>
 #include <QPair>
+#include <QRect>
 #include <string>
 #include <vector>
 #include "application_export.hpp"
 #include "fz_utils.hpp"
 #include "mupdf/classes.h"
+#include "rendering/pixmap_pool.hpp"
+#include "rendering/render_quality.hpp"
+#include "rendering/render_cache.hpp"
+#include "spatial_grid.hpp"
+#include "text_page_cache.hpp"
 #include "text_selector.hpp"
 
 namespace application::core
@@ -17,11 +24,18 @@ namespace application::core
  * positions of symbols, ...
  * It expects all coordinates to be "restored" meaning without any applied
  * transformations such as zooms.
+ *
+ * Creating a PageGenerator only loads the page and its bounds. Everything else
+ * (display list, text page, symbol bounds and links) is set up on first use,
+ * since most pages are never hovered or selected. If a TextPageCache is given,
+ * the text page is shared with everything else that needs the page's text.
  */
 class APPLICATION_EXPORT PageGenerator
 {
 public:
-    PageGenerator(mupdf::FzDocument* document, int pageNumber);
+    PageGenerator(mupdf::FzDocument* document, int pageNumber,
+                  RenderCache* renderCache = nullptr,
+                  utils::TextPageCache* textPageCache = nullptr);
 
     int getWidth() const;
     int getHeight() const;
@@ -29,8 +43,27 @@ public:
     int getPageXOffset() const;
     int getPageYOffset() const;
 
-    mupdf::FzPixmap renderPage(float zoom);
-    void setInvertColor(bool newInvertColor);
+    QImage renderPage(float zoom);
+
+    mupdf::FzDisplayList getDisplayList();
+    mupdf::FzRect getPageBox() const;
+
+    /**
+     * Renders the display list of a page without touching the page or the
+     * document it belongs to. Display lists are safe to be shared between
+     * threads, so this can be called from the render workers while the page
+     * itself stays on the thread that created it.
+     * If a region is given, only that part of the zoomed page is rendered.
+     * The page is rendered straight into a buffer from the pixmap pool, which
+     * the returned image adopts without copying or converting it.
+     * Draft renders change settings of the calling thread's fz_context for the
+     * duration of the render, which only the render workers own exclusively.
+     */
+    static QImage renderDisplayList(
+        mupdf::FzDisplayList displayList, const mupdf::FzRect& pageBox,
+        float zoom, mupdf::FzCookie& cookie, PixmapPool& pixmapPool,
+        const QRect& region = QRect(),
+        RenderQuality quality = RenderQuality::Full);
 
     bool pointIsAboveText(mupdf::FzPoint point);
     bool pointIsAboveLink(mupdf::FzPoint point);
@@ -44,22 +77,58 @@ public:
     std::string getTextFromSelection(mupdf::FzPoint start, mupdf::FzPoint end);
 
 private:
-    void setupDisplayList(const mupdf::FzRect& boundPage);
-    void setupTextPage(int pageNumber);
+    /**
+     * Anti-aliasing and color management are settings of the fz_context, of
+     * which every render worker has its own one. They are lowered for draft
+     * renders while this exists and restored afterwards, even if the render
+     * throws, so that the worker's next job is not affected.
+     */
+    class DraftQualityScope
+    {
+    public:
+        explicit DraftQualityScope(bool enabled);
+        ~DraftQualityScope();
+
+    private:
+        bool m_enabled;
+        int m_aaLevel = 8;
+        bool m_iccWasDisabled = false;
+
+        // MuPDF has no getter for whether ICC is enabled, and only draft
+        // renders change it, so it is tracked here, per thread like the
+        // fz_context it belongs to.
+        inline static thread_local bool iccDisabled = false;
+    };
+
+    // The number of bits of anti-aliasing used for draft renders, full
+    // quality renders use MuPDF's default of 8 bits.
+    static constexpr int draftAaLevel = 2;
+
+    void setupDisplayList();
+    void setupTextPage();
     void setupSymbolBounds();
     void setupLinks();
-    mupdf::FzPixmap getEmptyPixmap(const mupdf::FzMatrix& matrix) const;
+    utils::TextSelector& getTextSelector();
+    void setupPageOffsets();
     void setPageOffsets(int xOffset, int yOffset);
 
     const mupdf::FzDocument* m_document;
+    int m_pageNumber;
+    RenderCache* m_renderCache;
+    utils::TextPageCache* m_textPageCache;
     std::unique_ptr<mupdf::FzPage> m_page;
-    std::unique_ptr<mupdf::FzStextPage> m_textPage;
+    mupdf::FzRect m_pageBox;
+    QList<mupdf::FzQuad> m_bufferedSelectionRects;
+
+    // Lazily set up, see setupDisplayList(), setupTextPage(), ...
     mupdf::FzDisplayList m_displayList;
+    std::shared_ptr<mupdf::FzStextPage> m_textPage;
     utils::TextSelector m_textSelector;
-    QList<mupdf::FzQuad> m_bufferedSelectionRects;
     QList<mupdf::FzLink> m_links;
-    std::vector<fz_rect> m_symbolBounds;
-    bool m_invertColor = false;
+    utils::SpatialGrid<int> m_linkIndex;
+    bool m_linksLoaded = false;
+    utils::SpatialGrid<int> m_symbolIndex;
+    bool m_symbolBoundsLoaded = false;
     int m_pageXOffset = 0;
     int m_pageYOffset = 0;
 };
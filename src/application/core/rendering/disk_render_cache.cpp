@@ -0,0 +1,309 @@
+#include "disk_render_cache.hpp"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+#include <vector>
+
+namespace application::core
+{
+
+DiskRenderCache::DiskRenderCache(const QString& directory, qint64 capacity,
+                                 QObject* parent) :
+    QObject(parent),
+    m_capacity(capacity)
+{
+    auto path = directory;
+    if(path.isEmpty())
+    {
+        QDir appData(
+            QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+        path = appData.filePath("render_cache");
+    }
+
+    m_directory.mkpath(path);
+    m_directory.setPath(path);
+
+    QDirIterator it(m_directory.path(), { "*.png" }, QDir::Files,
+                    QDirIterator::Subdirectories);
+    while(it.hasNext())
+        m_size += it.nextFileInfo().size();
+
+    m_threadPool.setMaxThreadCount(1);
+}
+
+DiskRenderCache::~DiskRenderCache()
+{
+    waitForPendingWrites();
+}
+
+void DiskRenderCache::setUp(const QString& bookKey, const QString& filePath)
+{
+    // The key might contain characters which are not allowed in file names
+    auto hash = QCryptographicHash::hash(bookKey.toUtf8(),
+                                         QCryptographicHash::Sha1);
+    auto bookDirName = QString::fromLatin1(hash.toHex());
+    m_directory.mkpath(bookDirName);
+
+    QMutexLocker locker(&m_mutex);
+    m_bookDir = QDir(m_directory.filePath(bookDirName));
+    locker.unlock();
+
+    removeOutdatedImages(filePath);
+
+    locker.relock();
+    auto fileNames = m_bookDir.entryList({ "*.png" }, QDir::Files);
+    m_storedFiles = QSet<QString>(fileNames.begin(), fileNames.end());
+}
+
+bool DiskRenderCache::containsImage(const RenderCacheKey& key) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_storedFiles.contains(getFileName(key));
+}
+
+quint64 DiskRenderCache::loadImage(const RenderCacheKey& key)
+{
+    QMutexLocker locker(&m_mutex);
+    auto fileName = getFileName(key);
+    if(!m_storedFiles.contains(fileName))
+        return 0;
+
+    // The path is taken now, the cache might be set up with another book
+    // before the image is loaded.
+    auto filePath = m_bookDir.filePath(fileName);
+    auto ticket = m_nextTicket++;
+    locker.unlock();
+
+    m_threadPool.start(
+        [this, filePath, ticket]()
+        {
+            emit imageLoaded(ticket, readImage(filePath));
+        });
+
+    return ticket;
+}
+
+QImage DiskRenderCache::getImage(const RenderCacheKey& key)
+{
+    QMutexLocker locker(&m_mutex);
+    auto fileName = getFileName(key);
+    if(!m_storedFiles.contains(fileName))
+        return QImage();
+
+    auto filePath = m_bookDir.filePath(fileName);
+    locker.unlock();
+
+    return readImage(filePath);
+}
+
+void DiskRenderCache::storeImage(const RenderCacheKey& key,
+                                 const QImage& image, bool replace)
+{
+    if(image.isNull())
+        return;
+
+    QMutexLocker locker(&m_mutex);
+    auto fileName = getFileName(key);
+    if(m_storedFiles.contains(fileName) && !replace)
+        return;
+
+    auto bookDir = m_bookDir;
+    m_storedFiles.insert(fileName);
+    locker.unlock();
+
+    // QImages are implicitly shared, so the image is not copied
+    m_threadPool.start(
+        [this, bookDir, fileName, image]()
+        {
+            writeImage(bookDir, fileName, image);
+            evictImages();
+        });
+}
+
+void DiskRenderCache::setCapacity(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_capacity = bytes;
+}
+
+qint64 DiskRenderCache::getCapacity() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_capacity;
+}
+
+qint64 DiskRenderCache::getSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_size;
+}
+
+void DiskRenderCache::waitForPendingWrites()
+{
+    m_threadPool.waitForDone();
+}
+
+void DiskRenderCache::writeImage(const QDir& bookDir, const QString& fileName,
+                                 const QImage& image)
+{
+    // Pages are opaque, so the alpha channel is dropped to save space. The
+    // image is written to a temporary file first, so that no half written
+    // image is ever read and a stored image can be replaced.
+    auto filePath = bookDir.filePath(fileName);
+    auto previousSize = QFileInfo(filePath).size();
+    auto opaqueImage = image.convertToFormat(QImage::Format_RGB888);
+
+    QSaveFile file(filePath);
+    if(!file.open(QFile::WriteOnly) || !opaqueImage.save(&file, "PNG") ||
+       !file.commit())
+    {
+        qWarning() << QString("Failed storing page image at: %1")
+                          .arg(filePath);
+
+        // A previously stored image is left in place when replacing it failed
+        QMutexLocker locker(&m_mutex);
+        if(m_bookDir == bookDir && !QFile::exists(filePath))
+            m_storedFiles.remove(fileName);
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_size += QFileInfo(filePath).size() - previousSize;
+}
+
+QImage DiskRenderCache::readImage(const QString& filePath)
+{
+    QImage image(filePath);
+    if(image.isNull())
+    {
+        qWarning() << QString("Failed loading cached page image at: %1")
+                          .arg(filePath);
+        return image;
+    }
+
+    // Mark the image as recently used, so that it is evicted last
+    QFile file(filePath);
+    if(file.open(QFile::ReadWrite))
+    {
+        file.setFileTime(QDateTime::currentDateTime(),
+                         QFileDevice::FileModificationTime);
+    }
+
+    // Same format as freshly rendered pages
+    return image.convertToFormat(QImage::Format_RGBA8888_Premultiplied);
+}
+
+void DiskRenderCache::evictImages()
+{
+    QMutexLocker locker(&m_mutex);
+    if(m_size <= m_capacity)
+        return;
+    locker.unlock();
+
+    std::vector<QFileInfo> files;
+    qint64 totalSize = 0;
+
+    QDirIterator it(m_directory.path(), { "*.png" }, QDir::Files,
+                    QDirIterator::Subdirectories);
+    while(it.hasNext())
+    {
+        auto fileInfo = it.nextFileInfo();
+        totalSize += fileInfo.size();
+        files.push_back(fileInfo);
+    }
+
+    std::ranges::sort(files, {},
+                      [](const QFileInfo& fileInfo)
+                      {
+                          return fileInfo.lastModified();
+                      });
+
+    // Evict a bit more than needed, so that the next writes don't have to
+    // walk the files again right away.
+    locker.relock();
+    auto targetSize = m_capacity / 10 * 9;
+    for(auto& fileInfo : files)
+    {
+        if(totalSize <= targetSize)
+            break;
+
+        if(!QFile::remove(fileInfo.filePath()))
+            continue;
+
+        totalSize -= fileInfo.size();
+        if(fileInfo.dir() == m_bookDir)
+            m_storedFiles.remove(fileInfo.fileName());
+    }
+
+    m_size = totalSize;
+}
+
+void DiskRenderCache::removeOutdatedImages(const QString& filePath)
+{
+    QMutexLocker locker(&m_mutex);
+    auto bookDir = m_bookDir;
+    locker.unlock();
+
+    QFileInfo fileInfo(filePath);
+    auto lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+
+    auto bookFilePath = bookDir.filePath(m_bookFileName);
+    QFile bookFile(bookFilePath);
+    if(bookFile.open(QFile::ReadOnly))
+    {
+        auto jsonObject = QJsonDocument::fromJson(bookFile.readAll()).object();
+        if(jsonObject["fileSize"].toInteger() == fileInfo.size() &&
+           jsonObject["lastModified"].toInteger() == lastModified)
+        {
+            return;
+        }
+    }
+
+    // The images show pages of an older version of the book's file
+    qint64 removedSize = 0;
+    for(auto& storedFile : bookDir.entryInfoList({ "*.png" }, QDir::Files))
+    {
+        if(QFile::remove(storedFile.filePath()))
+            removedSize += storedFile.size();
+    }
+
+    locker.relock();
+    m_size -= removedSize;
+    locker.unlock();
+
+    QJsonObject jsonObject {
+        { "fileSize", fileInfo.size() },
+        { "lastModified", lastModified },
+    };
+
+    QSaveFile savedBookFile(bookFilePath);
+    if(!savedBookFile.open(QFile::WriteOnly))
+    {
+        qWarning() << QString("Failed opening file at: %1").arg(bookFilePath);
+        return;
+    }
+
+    QJsonDocument jsonDocument(jsonObject);
+    savedBookFile.write(jsonDocument.toJson(QJsonDocument::Compact));
+    if(!savedBookFile.commit())
+        qWarning() << QString("Failed writing file at: %1").arg(bookFilePath);
+}
+
+QString DiskRenderCache::getFileName(const RenderCacheKey& key) const
+{
+    return QString("%1_%2_%3.png")
+        .arg(key.pageNumber)
+        .arg(key.zoom, 0, 'g', 9)
+        .arg(key.dpr, 0, 'g', 17);
+}
+
+}  // namespace application::core
@@ -0,0 +1,104 @@
+#pragma once
+#include <QDir>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+#include "application_export.hpp"
+#include "render_cache.hpp"
+
+namespace application::core
+{
+
+/**
+ * The DiskRenderCache keeps rendered page images of books on disk, so that
+ * the pages at which a book is reopened are shown instantly, instead of only
+ * after they were rendered again.
+ *
+ * Every book has its own directory, named after the key it is set up with
+ * (e.g. the book's file hash), which contains one compressed image per
+ * RenderCacheKey. The color theme is not part of the key, since it is applied
+ * when drawing the images. The directory also stores the size and
+ * modification time of the book's file, if the file changed since, the
+ * stored images are removed. The size of all directories together is bounded,
+ * once it is exceeded the least recently used images are removed.
+ *
+ * Images are decoded, encoded and written on a background thread. Loaded
+ * images are reported through imageLoaded() with the ticket that loadImage()
+ * returned, the same way the RenderScheduler delivers rendered pages. Looking
+ * up whether an image is stored is cheap, since the stored ones are indexed
+ * in memory when the cache is set up with a book.
+ */
+class APPLICATION_EXPORT DiskRenderCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DiskRenderCache(const QString& directory = QString(),
+                             qint64 capacity = 256 * 1024 * 1024,
+                             QObject* parent = nullptr);
+    ~DiskRenderCache();
+
+    void setUp(const QString& bookKey, const QString& filePath);
+
+    bool containsImage(const RenderCacheKey& key) const;
+
+    /**
+     * Loads the image in the background, returns 0 if it is not stored. The
+     * image is null if it could not be loaded.
+     */
+    quint64 loadImage(const RenderCacheKey& key);
+
+    /**
+     * Blocks until the image was decoded, so it should not be called from the
+     * GUI thread, use loadImage() there instead.
+     */
+    QImage getImage(const RenderCacheKey& key);
+
+    /**
+     * Images that are already stored are kept, unless replace is set, e.g.
+     * when the page was rendered again to refresh its stored image.
+     */
+    void storeImage(const RenderCacheKey& key, const QImage& image,
+                    bool replace = false);
+
+    void setCapacity(qint64 bytes);
+    qint64 getCapacity() const;
+    qint64 getSize() const;
+
+    /**
+     * Blocks until all images that are being stored are written to disk.
+     */
+    void waitForPendingWrites();
+
+signals:
+    void imageLoaded(quint64 ticket, const QImage& image);
+
+private:
+    void writeImage(const QDir& bookDir, const QString& fileName,
+                    const QImage& image);
+    QImage readImage(const QString& filePath);
+    void evictImages();
+    void removeOutdatedImages(const QString& filePath);
+    QString getFileName(const RenderCacheKey& key) const;
+
+    QDir m_directory;
+    QDir m_bookDir;
+    QSet<QString> m_storedFiles;
+    mutable QMutex m_mutex;
+    qint64 m_capacity;
+    quint64 m_nextTicket = 1;
+    const QString m_bookFileName = "book_file.json";
+
+    // The size of all stored images, it is only computed from the files once,
+    // so that they are not walked after every write.
+    qint64 m_size = 0;
+
+    // Images are loaded and written one after another, in the order they were
+    // requested in.
+    QThreadPool m_threadPool;
+};
+
+}  // namespace application::core
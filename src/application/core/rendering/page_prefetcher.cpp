@@ -0,0 +1,354 @@
+#include "page_prefetcher.hpp"
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <utility>
+#include "layout/layout_cache.hpp"
+#include "page_generator.hpp"
+#include "tiling.hpp"
+
+namespace application::core
+{
+
+PagePrefetcher::PagePrefetcher(RenderScheduler* renderScheduler,
+                               RenderCache* renderCache, QObject* parent) :
+    QObject(parent),
+    m_renderScheduler(renderScheduler),
+    m_renderCache(renderCache)
+{
+    // Collect the pages that are requested until the event loop runs again,
+    // so that the most important one of them is loaded first.
+    m_prefetchTimer.setInterval(0);
+    m_prefetchTimer.setSingleShot(true);
+    connect(&m_prefetchTimer, &QTimer::timeout, this,
+            &PagePrefetcher::prefetchNextPage);
+
+    connect(m_renderScheduler, &RenderScheduler::pageRendered, this,
+            &PagePrefetcher::handleRenderedPage);
+
+    // The pages share a single FzDocument, so they are loaded one by one
+    m_threadPool.setMaxThreadCount(1);
+}
+
+PagePrefetcher::~PagePrefetcher()
+{
+    ++m_generation;
+    m_threadPool.waitForDone();
+}
+
+void PagePrefetcher::setUp(const QString& filePath, const QString& cacheKey,
+                           int pageCount)
+{
+    cancel();
+    m_filePath = filePath;
+    m_cacheKey = cacheKey;
+    m_pageCount = pageCount;
+}
+
+void PagePrefetcher::setRenderParameters(float zoom, double dpr)
+{
+    if(zoom == m_zoom && dpr == m_dpr)
+        return;
+
+    // Everything that was prefetched so far is useless at the new zoom
+    cancel();
+    m_zoom = zoom;
+    m_dpr = dpr;
+}
+
+void PagePrefetcher::prefetchAround(int currentPage, float pagesPerSecond)
+{
+    if(m_pageCount == 0)
+        return;
+
+    // The faster the user scrolls, the further ahead the pages are needed
+    int direction = pagesPerSecond < 0 ? -1 : 1;
+    int pagesAhead = std::ceil(std::abs(pagesPerSecond) * m_lookAheadSeconds);
+    pagesAhead = std::clamp(pagesAhead, m_minPagesAhead, m_maxPagesAhead);
+    int signedPagesAhead = direction * pagesAhead;
+
+    if(currentPage == m_lastCurrentPage &&
+       signedPagesAhead == m_lastSignedPagesAhead)
+    {
+        return;
+    }
+
+    m_lastCurrentPage = currentPage;
+    m_lastSignedPagesAhead = signedPagesAhead;
+
+    auto isWanted = [=](int pageNumber)
+    {
+        int distance = (pageNumber - currentPage) * direction;
+        return distance > 0 && distance <= pagesAhead;
+    };
+
+    // Drop the pages that are not ahead of the current page anymore
+    std::erase_if(m_queue,
+                  [&](int pageNumber)
+                  {
+                      return !isWanted(pageNumber);
+                  });
+
+    for(auto it = m_pendingRenders.begin(); it != m_pendingRenders.end();)
+    {
+        if(isWanted(it->key.pageNumber))
+        {
+            ++it;
+            continue;
+        }
+
+        m_renderScheduler->cancelRender(it.key());
+        m_usedMemory -= it->size;
+        it = m_pendingRenders.erase(it);
+    }
+
+    // Rendered pages that were reached are shown now, they are not the
+    // prefetcher's memory anymore.
+    std::erase_if(m_renderedImages,
+                  [&](const PrefetchedImage& image)
+                  {
+                      if(isWanted(image.key.pageNumber))
+                          return false;
+
+                      m_usedMemory -= image.size;
+                      return true;
+                  });
+
+    for(int i = 1; i <= pagesAhead; ++i)
+        enqueue(currentPage + i * direction, false);
+}
+
+void PagePrefetcher::prefetchPage(int pageNumber)
+{
+    if(m_pageCount == 0)
+        return;
+
+    enqueue(pageNumber, true);
+}
+
+void PagePrefetcher::cancel()
+{
+    // Pages which are still being loaded are dropped once they arrive
+    ++m_generation;
+    m_loadingPageNumber = -1;
+
+    m_prefetchTimer.stop();
+    m_queue.clear();
+
+    for(auto it = m_pendingRenders.begin(); it != m_pendingRenders.end(); ++it)
+        m_renderScheduler->cancelRender(it.key());
+    m_pendingRenders.clear();
+    m_renderedImages.clear();
+
+    m_usedMemory = 0;
+    m_lastCurrentPage = -1;
+    m_lastSignedPagesAhead = 0;
+}
+
+void PagePrefetcher::setMemoryBudget(qint64 bytes)
+{
+    m_memoryBudget = bytes;
+}
+
+qint64 PagePrefetcher::getMemoryBudget() const
+{
+    return m_memoryBudget;
+}
+
+void PagePrefetcher::prefetchNextPage()
+{
+    if(m_loadingPageNumber != -1)
+        return;
+
+    releaseEvictedImages();
+    while(!m_queue.empty())
+    {
+        int pageNumber = m_queue.front();
+        m_queue.pop_front();
+
+        // Pages that are stored on disk don't need to be rendered again
+        auto key = getRenderCacheKey(pageNumber);
+        if(m_renderCache->containsImage(key) ||
+           m_renderCache->containsImageOnDisk(key))
+        {
+            continue;
+        }
+
+        if(m_usedMemory >= m_memoryBudget)
+        {
+            m_queue.clear();
+            return;
+        }
+
+        m_loadingPageNumber = pageNumber;
+        m_threadPool.start(
+            [this, pageNumber, filePath = m_filePath, cacheKey = m_cacheKey,
+             generation = m_generation.load()]()
+            {
+                loadPage(pageNumber, filePath, cacheKey, generation);
+            });
+        return;
+    }
+}
+
+void PagePrefetcher::loadPage(int pageNumber, const QString& filePath,
+                              const QString& cacheKey, int generation)
+{
+    if(generation != m_generation)
+        return;
+
+    std::optional<mupdf::FzDisplayList> displayList;
+    mupdf::FzRect pageBox;
+    try
+    {
+        if(m_document.m_internal == nullptr || m_documentCacheKey != cacheKey)
+        {
+            m_document = LayoutCache::openDocument(filePath, cacheKey);
+            m_documentCacheKey = cacheKey;
+        }
+
+        // The page might have been shown before, e.g. at another zoom, then
+        // only its bounds need to be loaded.
+        PageGenerator pageGenerator(&m_document, pageNumber);
+        pageBox = pageGenerator.getPageBox();
+        displayList = m_renderCache->getDisplayList(pageNumber);
+        if(!displayList.has_value())
+            displayList = pageGenerator.getDisplayList();
+    }
+    catch(...)
+    {
+        qWarning() << QString("Failed prefetching page: %1").arg(pageNumber);
+        displayList = std::nullopt;
+    }
+
+    // Deliver the result on the thread the prefetcher lives in
+    QMetaObject::invokeMethod(
+        this,
+        [this, pageNumber, displayList, pageBox, generation]()
+        {
+            if(generation != m_generation)
+                return;
+
+            m_loadingPageNumber = -1;
+            if(displayList.has_value())
+                requestRender(pageNumber, *displayList, pageBox);
+
+            prefetchNextPage();
+        },
+        Qt::QueuedConnection);
+}
+
+void PagePrefetcher::requestRender(int pageNumber,
+                                   mupdf::FzDisplayList displayList,
+                                   mupdf::FzRect pageBox)
+{
+    // Only added now, so that the display list of a previous book, which was
+    // loaded while the cache was cleared, never ends up in it.
+    m_renderCache->insertDisplayList(pageNumber, displayList);
+
+    float scaledZoom = m_zoom * m_dpr;
+    QSize scaledPageSize(std::ceil((pageBox.x1 - pageBox.x0) * scaledZoom),
+                         std::ceil((pageBox.y1 - pageBox.y0) * scaledZoom));
+    auto imageZoom = tiling::getPageImageZoom(scaledZoom, scaledPageSize);
+
+    // Estimate the image's size to stay within the budget
+    auto scale = imageZoom / scaledZoom;
+    qint64 imageSize = scaledPageSize.width() * scale *
+                       scaledPageSize.height() * scale * 4;
+    if(m_usedMemory + imageSize > m_memoryBudget)
+    {
+        m_queue.clear();
+        return;
+    }
+
+    RenderRequest request {
+        .pageNumber = pageNumber,
+        .zoom = imageZoom,
+        .priority = RenderPriority::Prefetch,
+        .displayList = std::move(displayList),
+        .pageBox = pageBox,
+    };
+
+    auto ticket = m_renderScheduler->requestRender(request);
+    m_pendingRenders.insert(ticket,
+                            PrefetchedImage {
+                                .key = getRenderCacheKey(pageNumber),
+                                .size = imageSize,
+                            });
+    m_usedMemory += imageSize;
+}
+
+void PagePrefetcher::handleRenderedPage(quint64 ticket, int pageNumber,
+                                        const QImage& image)
+{
+    Q_UNUSED(pageNumber);
+
+    auto it = m_pendingRenders.find(ticket);
+    if(it == m_pendingRenders.end())
+        return;
+
+    // Account for the actual size from now on instead of the estimated one
+    auto prefetchedImage = it.value();
+    m_pendingRenders.erase(it);
+    m_usedMemory -= prefetchedImage.size;
+
+    m_renderCache->insertImage(prefetchedImage.key, image);
+    if(!m_renderCache->containsImage(prefetchedImage.key))
+        return;
+
+    prefetchedImage.size = image.sizeInBytes();
+    m_renderedImages.push_back(prefetchedImage);
+    m_usedMemory += prefetchedImage.size;
+}
+
+void PagePrefetcher::releaseEvictedImages()
+{
+    std::erase_if(m_renderedImages,
+                  [this](const PrefetchedImage& image)
+                  {
+                      if(m_renderCache->containsImage(image.key))
+                          return false;
+
+                      m_usedMemory -= image.size;
+                      return true;
+                  });
+}
+
+void PagePrefetcher::enqueue(int pageNumber, bool prioritize)
+{
+    if(pageNumber < 0 || pageNumber >= m_pageCount ||
+       pageNumber == m_loadingPageNumber)
+    {
+        return;
+    }
+
+    for(const auto& prefetchedImage : std::as_const(m_pendingRenders))
+    {
+        if(prefetchedImage.key.pageNumber == pageNumber)
+            return;
+    }
+
+    std::erase(m_queue, pageNumber);
+    if(prioritize)
+        m_queue.push_front(pageNumber);
+    else
+        m_queue.push_back(pageNumber);
+
+    if(!m_prefetchTimer.isActive())
+        m_prefetchTimer.start();
+}
+
+RenderCacheKey PagePrefetcher::getRenderCacheKey(int pageNumber) const
+{
+    // Derive the zoom the same way the PageController does, so that the keys
+    // of the prefetched images match exactly.
+    float scaledZoom = m_zoom * m_dpr;
+    return RenderCacheKey {
+        .pageNumber = pageNumber,
+        .zoom = static_cast<float>(scaledZoom / m_dpr),
+        .dpr = m_dpr,
+    };
+}
+
+}  // namespace application::core
@@ -0,0 +1,116 @@
+#pragma once
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include "application_export.hpp"
+#include "mupdf/classes.h"
+#include "render_cache.hpp"
+#include "render_scheduler.hpp"
+
+namespace application::core
+{
+
+/**
+ * The PagePrefetcher prepares pages before they are shown, so that they appear
+ * instantly instead of being rendered once they come into view.
+ *
+ * Pages are prefetched ahead of the scroll direction, the faster the user
+ * scrolls the more pages are prefetched. Additionally, single pages that are
+ * likely to be jumped to (e.g. the target of a hovered link) can be
+ * prefetched.
+ *
+ * Prefetching a page loads its display list on a background thread, from a
+ * separate FzDocument, and renders it with the lowest priority. The results
+ * are stored in the RenderCache, from which the pages pick them up once they
+ * are shown. The images that are being rendered, or were rendered and are
+ * still ahead of the current page, are limited by a memory budget.
+ */
+class APPLICATION_EXPORT PagePrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    PagePrefetcher(RenderScheduler* renderScheduler, RenderCache* renderCache,
+                   QObject* parent = nullptr);
+    ~PagePrefetcher();
+
+    /**
+     * The cache key identifies the book's stored layout, so that the pages are
+     * laid out the same way as in the document that is shown.
+     */
+    void setUp(const QString& filePath, const QString& cacheKey,
+               int pageCount);
+    void setRenderParameters(float zoom, double dpr);
+
+    void prefetchAround(int currentPage, float pagesPerSecond);
+    void prefetchPage(int pageNumber);
+    void cancel();
+
+    void setMemoryBudget(qint64 bytes);
+    qint64 getMemoryBudget() const;
+
+    RenderCacheKey getRenderCacheKey(int pageNumber) const;
+
+private slots:
+    void prefetchNextPage();
+    void handleRenderedPage(quint64 ticket, int pageNumber,
+                            const QImage& image);
+
+private:
+    struct PrefetchedImage
+    {
+        RenderCacheKey key;
+        qint64 size;
+    };
+
+    void enqueue(int pageNumber, bool prioritize);
+    void loadPage(int pageNumber, const QString& filePath,
+                  const QString& cacheKey, int generation);
+    void requestRender(int pageNumber, mupdf::FzDisplayList displayList,
+                       mupdf::FzRect pageBox);
+    void releaseEvictedImages();
+
+    RenderScheduler* m_renderScheduler;
+    RenderCache* m_renderCache;
+    QString m_filePath;
+    QString m_cacheKey;
+    int m_pageCount = 0;
+    float m_zoom = 1;
+    double m_dpr = 1;
+
+    QTimer m_prefetchTimer;
+    std::deque<int> m_queue;
+    int m_loadingPageNumber = -1;
+
+    // The memory of an image is accounted for from the moment its render is
+    // requested until it was evicted from the RenderCache, or the current
+    // page moved past it.
+    QHash<quint64, PrefetchedImage> m_pendingRenders;
+    std::vector<PrefetchedImage> m_renderedImages;
+    qint64 m_memoryBudget = 64 * 1024 * 1024;
+    qint64 m_usedMemory = 0;
+
+    // The last prefetched range, to avoid planning it again on every scroll
+    int m_lastCurrentPage = -1;
+    int m_lastSignedPagesAhead = 0;
+    const float m_lookAheadSeconds = 1.5;
+    const int m_minPagesAhead = 2;
+    const int m_maxPagesAhead = 16;
+
+    // Pages are loaded one after another, loads of a previous book or zoom
+    // are recognized by their generation and dropped.
+    QThreadPool m_threadPool;
+    std::atomic<int> m_generation = 0;
+
+    // Only used by the background thread
+    mupdf::FzDocument m_document;
+    QString m_documentCacheKey;
+};
+
+}  // namespace application::core
@@ -0,0 +1,86 @@
+#include "pixmap_pool.hpp"
+#include <QMutexLocker>
+
+namespace application::core
+{
+
+PixmapPool::PixmapPool(qint64 capacity) :
+    m_storage(std::make_shared<Storage>())
+{
+    m_storage->capacity = capacity;
+}
+
+QImage PixmapPool::createImage(const QSize& size)
+{
+    if(size.isEmpty())
+        return QImage();
+
+    const int bytesPerLine = size.width() * 4;
+    const qint64 neededSize = static_cast<qint64>(bytesPerLine) * size.height();
+
+    auto imageBuffer = new ImageBuffer { m_storage, nullptr, neededSize };
+
+    // Take the smallest free buffer that fits, as long as it does not waste
+    // too much memory (e.g. a whole page's buffer for a small tile).
+    QMutexLocker locker(&m_storage->mutex);
+    auto it = m_storage->buffers.lower_bound(neededSize);
+    if(it != m_storage->buffers.end() && it->first <= neededSize * 5 / 4)
+    {
+        imageBuffer->data = std::move(it->second);
+        imageBuffer->size = it->first;
+        m_storage->pooledSize -= it->first;
+        m_storage->buffers.erase(it);
+    }
+    locker.unlock();
+
+    if(imageBuffer->data == nullptr)
+        imageBuffer->data = std::make_unique_for_overwrite<uchar[]>(neededSize);
+
+    return QImage(imageBuffer->data.get(), size.width(), size.height(),
+                  bytesPerLine, QImage::Format_RGBA8888_Premultiplied,
+                  &PixmapPool::releaseImageBuffer, imageBuffer);
+}
+
+void PixmapPool::setCapacity(qint64 bytes)
+{
+    QMutexLocker locker(&m_storage->mutex);
+    m_storage->capacity = bytes;
+    evict(*m_storage);
+}
+
+qint64 PixmapPool::getPooledSize() const
+{
+    QMutexLocker locker(&m_storage->mutex);
+    return m_storage->pooledSize;
+}
+
+void PixmapPool::clear()
+{
+    QMutexLocker locker(&m_storage->mutex);
+    m_storage->buffers.clear();
+    m_storage->pooledSize = 0;
+}
+
+void PixmapPool::releaseImageBuffer(void* info)
+{
+    std::unique_ptr<ImageBuffer> imageBuffer(static_cast<ImageBuffer*>(info));
+    auto& storage = *imageBuffer->storage;
+
+    QMutexLocker locker(&storage.mutex);
+    storage.buffers.emplace(imageBuffer->size, std::move(imageBuffer->data));
+    storage.pooledSize += imageBuffer->size;
+    evict(storage);
+}
+
+void PixmapPool::evict(Storage& storage)
+{
+    // Free the largest buffers first to get below the capacity quickly
+    while(storage.pooledSize > storage.capacity)
+    {
+        auto largest = std::prev(storage.buffers.end());
+        storage.pooledSize -= largest->first;
+        storage.buffers.erase(largest);
+    }
+}
+
+}  // namespace application::core
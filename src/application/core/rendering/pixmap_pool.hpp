@@ -0,0 +1,61 @@
+#pragma once
+#include <QImage>
+#include <QMutex>
+#include <QSize>
+#include <map>
+#include <memory>
+#include "application_export.hpp"
+
+namespace application::core
+{
+
+/**
+ * The PixmapPool recycles the pixel buffers that pages are rendered into.
+ * Page images are large and get rendered all the time (e.g. while scrolling or
+ * zooming), so reusing their buffers saves allocating and faulting in fresh
+ * memory for every render.
+ *
+ * The images it creates adopt a pooled buffer without copying it. Once the
+ * last copy of such an image is destroyed, its buffer returns to the pool.
+ * This may happen on any thread, even after the pool itself was destroyed.
+ */
+class APPLICATION_EXPORT PixmapPool
+{
+public:
+    explicit PixmapPool(qint64 capacity = 128 * 1024 * 1024);
+
+    /**
+     * Creates an uninitialized, premultiplied RGBA image, which matches the
+     * memory layout of an RGB FzPixmap with an alpha channel. Its scanlines
+     * are tightly packed, so that MuPDF can render into its bits directly.
+     */
+    QImage createImage(const QSize& size);
+
+    void setCapacity(qint64 bytes);
+    qint64 getPooledSize() const;
+    void clear();
+
+private:
+    struct Storage
+    {
+        // Free buffers by their size in bytes
+        std::multimap<qint64, std::unique_ptr<uchar[]>> buffers;
+        qint64 pooledSize = 0;
+        qint64 capacity = 0;
+        QMutex mutex;
+    };
+
+    struct ImageBuffer
+    {
+        std::shared_ptr<Storage> storage;
+        std::unique_ptr<uchar[]> data;
+        qint64 size;
+    };
+
+    static void releaseImageBuffer(void* info);
+    static void evict(Storage& storage);
+
+    std::shared_ptr<Storage> m_storage;
+};
+
+}  // namespace application::core
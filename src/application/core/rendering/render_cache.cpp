@@ -0,0 +1,165 @@
+#include "render_cache.hpp"
+#include <QMutexLocker>
+#include "disk_render_cache.hpp"
+
+namespace application::core
+{
+
+size_t qHash(const RenderCacheKey& key, size_t seed)
+{
+    return qHashMulti(seed, key.pageNumber, key.zoom, key.dpr);
+}
+
+RenderCache::RenderCache(qint64 imageBudget, int maxDisplayListCount) :
+    m_imageBudget(imageBudget),
+    m_maxDisplayListCount(maxDisplayListCount)
+{
+}
+
+std::optional<mupdf::FzDisplayList> RenderCache::getDisplayList(int pageNumber)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_displayListLookup.find(pageNumber);
+    if(it == m_displayListLookup.end())
+        return std::nullopt;
+
+    // Mark the entry as the most recently used one
+    m_displayLists.splice(m_displayLists.begin(), m_displayLists, it.value());
+    return it.value()->displayList;
+}
+
+void RenderCache::insertDisplayList(int pageNumber,
+                                    mupdf::FzDisplayList displayList)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_displayListLookup.find(pageNumber);
+    if(it != m_displayListLookup.end())
+        m_displayLists.erase(it.value());
+
+    m_displayLists.push_front({ pageNumber, std::move(displayList) });
+    m_displayListLookup.insert(pageNumber, m_displayLists.begin());
+
+    evictDisplayLists();
+}
+
+QImage RenderCache::getImage(const RenderCacheKey& key)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_imageLookup.find(key);
+    if(it == m_imageLookup.end())
+        return QImage();
+
+    m_images.splice(m_images.begin(), m_images, it.value());
+    return it.value()->image;
+}
+
+void RenderCache::insertImage(const RenderCacheKey& key, const QImage& image)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // An image larger than the whole budget would just evict everything else
+    if(image.isNull() || image.sizeInBytes() > m_imageBudget)
+        return;
+
+    auto it = m_imageLookup.find(key);
+    if(it != m_imageLookup.end())
+    {
+        m_imageCacheSize -= it.value()->image.sizeInBytes();
+        m_images.erase(it.value());
+    }
+
+    m_images.push_front({ key, image });
+    m_imageLookup.insert(key, m_images.begin());
+    m_imageCacheSize += image.sizeInBytes();
+
+    evictImages();
+}
+
+bool RenderCache::containsImage(const RenderCacheKey& key) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_imageLookup.contains(key);
+}
+
+bool RenderCache::containsImageOnDisk(const RenderCacheKey& key) const
+{
+    auto diskCache = getDiskCache();
+    return diskCache != nullptr && diskCache->containsImage(key);
+}
+
+void RenderCache::setImageBudget(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_imageBudget = bytes;
+    evictImages();
+}
+
+qint64 RenderCache::getImageBudget() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_imageBudget;
+}
+
+qint64 RenderCache::getImageCacheSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_imageCacheSize;
+}
+
+void RenderCache::setMaxDisplayListCount(int count)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxDisplayListCount = count;
+    evictDisplayLists();
+}
+
+int RenderCache::getMaxDisplayListCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maxDisplayListCount;
+}
+
+void RenderCache::setDiskCache(DiskRenderCache* diskCache)
+{
+    QMutexLocker locker(&m_mutex);
+    m_diskCache = diskCache;
+}
+
+DiskRenderCache* RenderCache::getDiskCache() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_diskCache;
+}
+
+void RenderCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_images.clear();
+    m_imageLookup.clear();
+    m_imageCacheSize = 0;
+    m_displayLists.clear();
+    m_displayListLookup.clear();
+}
+
+void RenderCache::evictImages()
+{
+    while(m_imageCacheSize > m_imageBudget && !m_images.empty())
+    {
+        auto& leastRecentlyUsed = m_images.back();
+        m_imageCacheSize -= leastRecentlyUsed.image.sizeInBytes();
+        m_imageLookup.remove(leastRecentlyUsed.key);
+        m_images.pop_back();
+    }
+}
+
+void RenderCache::evictDisplayLists()
+{
+    while(static_cast<int>(m_displayLists.size()) > m_maxDisplayListCount &&
+          !m_displayLists.empty())
+    {
+        m_displayListLookup.remove(m_displayLists.back().pageNumber);
+        m_displayLists.pop_back();
+    }
+}
+
+}  // namespace application::core
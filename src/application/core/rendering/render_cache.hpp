@@ -0,0 +1,105 @@
+#pragma once
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <list>
+#include <optional>
+#include "application_export.hpp"
+#include "mupdf/classes.h"
+
+namespace application::core
+{
+
+struct RenderCacheKey
+{
+    int pageNumber;
+    float zoom;
+    double dpr;
+
+    bool operator==(const RenderCacheKey& other) const = default;
+};
+
+size_t qHash(const RenderCacheKey& key, size_t seed = 0);
+
+class DiskRenderCache;
+
+/**
+ * The RenderCache keeps the expensive results of working with a document's
+ * pages around, so that they don't need to be recomputed when a page is shown
+ * again, e.g. after scrolling back to it.
+ *
+ * It holds the display lists of pages as well as the images that were
+ * rendered from them. The images don't depend on the color theme, since it is
+ * applied when drawing them. Both are evicted in least-recently-used order
+ * once the cache grows beyond its budget. Images are limited by their size in
+ * bytes, display lists by their count, since MuPDF does not expose their size.
+ *
+ * Optionally, a DiskRenderCache can be attached, from which images that are
+ * not in memory can be loaded in the background, e.g. right after a book was
+ * reopened. getImage() only ever looks at the images in memory.
+ *
+ * The cache is shared between all pages of a document and may be accessed
+ * from multiple threads.
+ */
+class APPLICATION_EXPORT RenderCache
+{
+public:
+    RenderCache(qint64 imageBudget = 256 * 1024 * 1024,
+                int maxDisplayListCount = 64);
+
+    std::optional<mupdf::FzDisplayList> getDisplayList(int pageNumber);
+    void insertDisplayList(int pageNumber, mupdf::FzDisplayList displayList);
+
+    QImage getImage(const RenderCacheKey& key);
+    void insertImage(const RenderCacheKey& key, const QImage& image);
+
+    /**
+     * Check whether an image is available without loading it or marking it as
+     * used, e.g. to decide whether a page needs to be rendered at all.
+     */
+    bool containsImage(const RenderCacheKey& key) const;
+    bool containsImageOnDisk(const RenderCacheKey& key) const;
+
+    void setImageBudget(qint64 bytes);
+    qint64 getImageBudget() const;
+    qint64 getImageCacheSize() const;
+
+    void setMaxDisplayListCount(int count);
+    int getMaxDisplayListCount() const;
+
+    void setDiskCache(DiskRenderCache* diskCache);
+    DiskRenderCache* getDiskCache() const;
+
+    void clear();
+
+private:
+    struct ImageEntry
+    {
+        RenderCacheKey key;
+        QImage image;
+    };
+
+    struct DisplayListEntry
+    {
+        int pageNumber;
+        mupdf::FzDisplayList displayList;
+    };
+
+    void evictImages();
+    void evictDisplayLists();
+
+    // The lists are ordered from the most to the least recently used entry,
+    // the hashes point into them for constant time lookups.
+    std::list<ImageEntry> m_images;
+    QHash<RenderCacheKey, std::list<ImageEntry>::iterator> m_imageLookup;
+    std::list<DisplayListEntry> m_displayLists;
+    QHash<int, std::list<DisplayListEntry>::iterator> m_displayListLookup;
+
+    mutable QMutex m_mutex;
+    qint64 m_imageBudget;
+    qint64 m_imageCacheSize = 0;
+    int m_maxDisplayListCount;
+    DiskRenderCache* m_diskCache = nullptr;
+};
+
+}  // namespace application::core
@@ -0,0 +1,18 @@
+#pragma once
+
+namespace application::core
+{
+
+/**
+ * Draft renders are cheaper, but look worse: they use less anti-aliasing, no
+ * ICC color management and no image smoothing. They are meant for pages that
+ * are only on the screen for a few frames (e.g. while scrolling fast) and are
+ * replaced with a full quality render once the view settles.
+ */
+enum class RenderQuality
+{
+    Draft = 0,
+    Full,
+};
+
+}  // namespace application::core
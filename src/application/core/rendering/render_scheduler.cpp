@@ -0,0 +1,127 @@
+#include "render_scheduler.hpp"
+#include <QDebug>
+#include <QMutexLocker>
+#include <QThread>
+#include <algorithm>
+#include "page_generator.hpp"
+
+namespace application::core
+{
+
+RenderScheduler::RenderScheduler(QObject* parent) :
+    QObject(parent)
+{
+    // MuPDF's C++ bindings give every thread its own clone of the global
+    // fz_context, which is set up with the locking callbacks MuPDF requires for
+    // multi-threaded use. We never let the worker threads expire, so that each
+    // of them keeps reusing its cloned context instead of creating a new one.
+    auto workerCount = QThread::idealThreadCount() - 1;
+    m_threadPool.setMaxThreadCount(qBound(1, workerCount, m_maxWorkerCount));
+    m_threadPool.setExpiryTimeout(-1);
+}
+
+RenderScheduler::~RenderScheduler()
+{
+    cancelAllRenders();
+    m_threadPool.waitForDone();
+}
+
+quint64 RenderScheduler::requestRender(RenderRequest request)
+{
+    QMutexLocker locker(&m_mutex);
+    auto ticket = m_nextTicket++;
+    m_pendingJobs.push_back({ ticket, std::move(request) });
+    locker.unlock();
+
+    // Each started task renders whichever job has the highest priority at the
+    // time it runs, not necessarily the one that was just added.
+    m_threadPool.start(
+        [this]()
+        {
+            renderNextJob();
+        });
+
+    return ticket;
+}
+
+void RenderScheduler::cancelRender(quint64 ticket)
+{
+    QMutexLocker locker(&m_mutex);
+    std::erase_if(m_pendingJobs,
+                  [ticket](const RenderJob& job)
+                  {
+                      return job.ticket == ticket;
+                  });
+
+    // MuPDF checks the cookie while rendering and stops once it is aborted
+    if(auto cookie = m_runningJobs.value(ticket))
+        cookie->abort = 1;
+}
+
+void RenderScheduler::cancelAllRenders()
+{
+    QMutexLocker locker(&m_mutex);
+    m_pendingJobs.clear();
+
+    for(auto cookie : std::as_const(m_runningJobs))
+        cookie->abort = 1;
+}
+
+void RenderScheduler::setPriority(quint64 ticket, RenderPriority priority)
+{
+    QMutexLocker locker(&m_mutex);
+    for(auto& job : m_pendingJobs)
+    {
+        if(job.ticket == ticket)
+        {
+            job.request.priority = priority;
+            break;
+        }
+    }
+}
+
+void RenderScheduler::renderNextJob()
+{
+    QMutexLocker locker(&m_mutex);
+    if(m_pendingJobs.empty())
+        return;
+
+    // Jobs are stored in the order they were requested in, so if there are
+    // multiple jobs with the highest priority, the oldest one is taken.
+    auto next = std::ranges::max_element(m_pendingJobs, {},
+                                         [](const RenderJob& job)
+                                         {
+                                             return job.request.priority;
+                                         });
+    auto job = std::move(*next);
+    m_pendingJobs.erase(next);
+
+    mupdf::FzCookie cookie;
+    m_runningJobs.insert(job.ticket, &cookie);
+    locker.unlock();
+
+    QImage image;
+    try
+    {
+        auto& request = job.request;
+        image = PageGenerator::renderDisplayList(
+            request.displayList, request.pageBox, request.zoom, cookie,
+            m_pixmapPool, request.region, request.quality);
+    }
+    catch(...)
+    {
+        qWarning() << QString("Failed rendering page: %1")
+                          .arg(job.request.pageNumber);
+    }
+
+    locker.relock();
+    m_runningJobs.remove(job.ticket);
+    bool aborted = cookie.abort;
+    locker.unlock();
+
+    // An aborted render only contains parts of the page
+    if(!aborted && !image.isNull())
+        emit pageRendered(job.ticket, job.request.pageNumber, image);
+}
+
+}  // namespace application::core
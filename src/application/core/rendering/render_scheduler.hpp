@@ -0,0 +1,87 @@
+#pragma once
+#include <QImage>
+#include <QMutex>
+#include <QHash>
+#include <QObject>
+#include <QRect>
+#include <QThreadPool>
+#include <vector>
+#include "application_export.hpp"
+#include "mupdf/classes.h"
+#include "pixmap_pool.hpp"
+#include "render_quality.hpp"
+
+namespace application::core
+{
+
+/**
+ * Pages which are visible on the screen are rendered before the pages which
+ * are only kept around (e.g. in the view's cache buffer). Pages which are only
+ * rendered in anticipation of being shown soon come last.
+ */
+enum class RenderPriority
+{
+    Prefetch = 0,
+    Buffered,
+    Visible,
+};
+
+struct RenderRequest
+{
+    int pageNumber;
+    float zoom;
+    RenderPriority priority;
+    mupdf::FzDisplayList displayList;
+    mupdf::FzRect pageBox;
+
+    // The part of the zoomed page to render in pixels, relative to the page's
+    // top left corner. A null region renders the whole page.
+    QRect region;
+
+    RenderQuality quality = RenderQuality::Full;
+};
+
+/**
+ * The RenderScheduler renders pages on a pool of worker threads, so that
+ * neither the GUI thread nor the scene graph's render thread is blocked.
+ *
+ * Every request gets a ticket which identifies its result once it arrives via
+ * the pageRendered signal. Requests that became obsolete should be cancelled,
+ * they are then dropped without ever being rendered. If they are already being
+ * rendered, the render is aborted through its FzCookie.
+ */
+class APPLICATION_EXPORT RenderScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RenderScheduler(QObject* parent = nullptr);
+    ~RenderScheduler();
+
+    quint64 requestRender(RenderRequest request);
+    void cancelRender(quint64 ticket);
+    void cancelAllRenders();
+    void setPriority(quint64 ticket, RenderPriority priority);
+
+signals:
+    void pageRendered(quint64 ticket, int pageNumber, const QImage& image);
+
+private:
+    struct RenderJob
+    {
+        quint64 ticket;
+        RenderRequest request;
+    };
+
+    void renderNextJob();
+
+    QThreadPool m_threadPool;
+    QMutex m_mutex;
+    std::vector<RenderJob> m_pendingJobs;
+    QHash<quint64, mupdf::FzCookie*> m_runningJobs;
+    PixmapPool m_pixmapPool;
+    quint64 m_nextTicket = 1;
+    const int m_maxWorkerCount = 4;
+};
+
+}  // namespace application::core
@@ -0,0 +1,40 @@
+#pragma once
+#include <QSize>
+#include <QtGlobal>
+#include <cmath>
+
+namespace application::core::tiling
+{
+
+/**
+ * Once a zoomed page gets larger than maxFullPageArea, only the tiles in the
+ * visible area are rendered at full resolution. The page image is then
+ * rendered at a lower resolution, covering at most maxBaseLayerArea, and serves
+ * as a base layer that is shown wherever the tiles have not been rendered yet.
+ */
+constexpr int tileSize = 512;
+constexpr qint64 maxFullPageArea = 4096 * 2048;
+constexpr qint64 maxBaseLayerArea = 1024 * 1024;
+
+inline bool usesTiles(const QSize& scaledPageSize)
+{
+    return static_cast<qint64>(scaledPageSize.width()) *
+               scaledPageSize.height() >
+           maxFullPageArea;
+}
+
+/**
+ * Returns the zoom the page image is rendered at for a page that is shown at
+ * the given zoom, and has the given size at that zoom.
+ */
+inline float getPageImageZoom(float zoom, const QSize& scaledPageSize)
+{
+    if(!usesTiles(scaledPageSize))
+        return zoom;
+
+    double area = static_cast<double>(scaledPageSize.width()) *
+                  scaledPageSize.height();
+    return zoom * std::sqrt(maxBaseLayerArea / area);
+}
+
+}  // namespace application::core::tiling
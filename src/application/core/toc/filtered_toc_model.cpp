@@ -1,5 +1,4 @@
 #include "filtered_toc_model.hpp"
-#include <algorithm>
 #include "string_utils.hpp"
 #include "toc_model.hpp"
 
@@ -15,11 +14,8 @@ bool FilteredTOCModel::filterAcceptsRow(int row,
                                         const QModelIndex& parent) const
 {
     auto index = sourceModel()->index(row, 0, parent);
-    auto title = sourceModel()->data(index, TOCModel::Roles::TitleRole);
-
-    auto temp = sourceModel()->index(row, 0, parent);
-    TOCItem* item = static_cast<TOCItem*>(temp.internalPointer());
-    if(item != nullptr && hasChildrenMatchingTheFilter(item))
+    TOCItem* item = static_cast<TOCItem*>(index.internalPointer());
+    if(item != nullptr && hasChildrenMatchingTheFilter(item->data().internal))
         return true;
 
     return false;
@@ -43,22 +39,25 @@ QString FilteredTOCModel::getFilterString()
     return m_filterString;
 }
 
-bool FilteredTOCModel::hasChildrenMatchingTheFilter(const TOCItem* item) const
+bool FilteredTOCModel::hasChildrenMatchingTheFilter(
+    const fz_outline* outline) const
 {
-    if(itemPassesFilter(item))
+    if(itemPassesFilter(outline))
         return true;
 
-    return std::any_of(item->getChildren().begin(), item->getChildren().end(),
-                       [this](const TOCItem* child)
-                       {
-                           return hasChildrenMatchingTheFilter(child);
-                       });
+    for(auto child = outline->down; child != nullptr; child = child->next)
+    {
+        if(hasChildrenMatchingTheFilter(child))
+            return true;
+    }
+
+    return false;
 }
 
-bool FilteredTOCModel::itemPassesFilter(const TOCItem* item) const
+bool FilteredTOCModel::itemPassesFilter(const fz_outline* outline) const
 {
     auto similarity = string_utils::similarity(
-        item->data().title, m_filterString, m_filterScorer.get());
+        QString(outline->title), m_filterString, m_filterScorer.get());
     double minSimilarity = 70;
 
     return similarity >= minSimilarity;
@@ -27,9 +27,11 @@ signals:
     void filterStringUpdated();
 
 private:
-    // Recursively check if the item or any of its children match the filter
-    bool hasChildrenMatchingTheFilter(const TOCItem* item) const;
-    bool itemPassesFilter(const TOCItem* item) const;
+    // Recursively check if the entry or any of its children match the filter.
+    // The outline is used, since the children of entries which were never
+    // expanded are not in the model.
+    bool hasChildrenMatchingTheFilter(const fz_outline* outline) const;
+    bool itemPassesFilter(const fz_outline* outline) const;
 
     QString m_filterString;
     std::unique_ptr<rapidfuzz::fuzz::CachedRatio<unsigned int>> m_filterScorer;
@@ -43,6 +43,23 @@ TOCItemData TOCItem::data() const
     return m_data;
 }
 
+void TOCItem::setLink(int pageNumber, float yOffset)
+{
+    m_data.pageNumber = pageNumber;
+    m_data.yOffset = yOffset;
+    m_data.resolved = true;
+}
+
+bool TOCItem::hasChildren() const
+{
+    // The children are only created once they are needed, the outline
+    // already knows whether there are any.
+    if(m_data.internal != nullptr)
+        return m_data.internal->down != nullptr;
+
+    return !m_children.isEmpty();
+}
+
 int TOCItem::row() const
 {
     if(m_parentItem != nullptr)
@@ -10,9 +10,11 @@ namespace application::core
 struct TOCItemData
 {
     QString title;
-    int pageNumber;
-    float yOffset;
-    fz_outline* internal;
+    int pageNumber = -1;
+    float yOffset = 0;
+    QString uri;
+    bool resolved = false;
+    fz_outline* internal = nullptr;
 };
 
 class TOCItem
@@ -27,6 +29,8 @@ public:
     int childCount() const;
     int columnCount() const;
     TOCItemData data() const;
+    void setLink(int pageNumber, float yOffset);
+    bool hasChildren() const;
     int row() const;
     TOCItem* parentItem();
     void setParent(TOCItem* parent);
@@ -0,0 +1,236 @@
+#include "toc_link_resolver.hpp"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include "layout/layout_cache.hpp"
+
+namespace application::core
+{
+
+TOCLinkResolver::TOCLinkResolver(const QString& filePath,
+                                 const QString& cacheKey, QObject* parent) :
+    QObject(parent),
+    m_filePath(filePath),
+    m_cacheKey(cacheKey)
+{
+    // The links share a single FzDocument, so they are resolved one by one
+    m_threadPool.setMaxThreadCount(1);
+}
+
+TOCLinkResolver::~TOCLinkResolver()
+{
+    m_stopped = true;
+    m_threadPool.waitForDone();
+
+    if(m_storedLinksChanged)
+        saveToCache();
+}
+
+std::optional<TOCLink> TOCLinkResolver::findResolvedLink(
+    const QString& uri) const
+{
+    auto it = m_resolvedLinks.find(uri);
+    if(it == m_resolvedLinks.end())
+        return std::nullopt;
+
+    return it.value();
+}
+
+void TOCLinkResolver::resolve(const QString& uri)
+{
+    if(m_requestedUris.contains(uri))
+        return;
+
+    m_requestedUris.insert(uri);
+    m_pendingUris.append(uri);
+
+    // Collect all links requested until the event loop runs again, e.g. the
+    // ones of all entries that are shown, and resolve them together.
+    if(m_pendingUris.size() == 1)
+    {
+        QMetaObject::invokeMethod(this, &TOCLinkResolver::startResolving,
+                                  Qt::QueuedConnection);
+    }
+}
+
+void TOCLinkResolver::startResolving()
+{
+    QStringList uris;
+    uris.swap(m_pendingUris);
+
+    m_threadPool.start(
+        [this, uris]()
+        {
+            auto links = resolveLinks(uris);
+            if(m_stopped)
+                return;
+
+            // Deliver the result on the thread the resolver lives in
+            QMetaObject::invokeMethod(
+                this,
+                [this, links]()
+                {
+                    m_resolvedLinks.insert(links);
+                    emit linksResolved(links);
+                },
+                Qt::QueuedConnection);
+        });
+}
+
+QHash<QString, TOCLink> TOCLinkResolver::resolveLinks(const QStringList& uris)
+{
+    if(!m_storedLinksLoaded)
+    {
+        loadFromCache();
+        m_storedLinksLoaded = true;
+    }
+
+    QHash<QString, TOCLink> links;
+    for(const auto& uri : uris)
+    {
+        if(m_stopped)
+            return links;
+
+        auto storedLink = m_storedLinks.find(uri);
+        if(storedLink != m_storedLinks.end())
+        {
+            links.insert(uri, storedLink.value());
+            continue;
+        }
+
+        auto link = resolveLink(uri);
+        links.insert(uri, link);
+
+        // Links which failed resolving are tried again the next time
+        if(link.pageNumber != -1)
+        {
+            m_storedLinks.insert(uri, link);
+            m_storedLinksChanged = true;
+        }
+    }
+
+    return links;
+}
+
+TOCLink TOCLinkResolver::resolveLink(const QString& uri)
+{
+    try
+    {
+        if(m_document.m_internal == nullptr)
+            m_document = LayoutCache::openDocument(m_filePath, m_cacheKey);
+
+        auto stdUri = uri.toStdString();
+        float yOffset = 0;
+        auto location =
+            m_document.fz_resolve_link(stdUri.c_str(), nullptr, &yOffset);
+
+        return TOCLink {
+            .pageNumber = m_document.fz_page_number_from_location(location),
+            .yOffset = yOffset,
+        };
+    }
+    catch(...)
+    {
+        qWarning() << QString("Failed resolving table of contents link: %1")
+                          .arg(uri);
+        return TOCLink();
+    }
+}
+
+void TOCLinkResolver::loadFromCache()
+{
+    QFile cacheFile(getCacheFilePath(m_cacheKey));
+    if(!cacheFile.open(QFile::ReadOnly))
+        return;
+
+    auto jsonObject = QJsonDocument::fromJson(cacheFile.readAll()).object();
+
+    // The stored links are outdated if the book's file changed since
+    QFileInfo fileInfo(m_filePath);
+    auto lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+    if(jsonObject["fileSize"].toInteger() != fileInfo.size() ||
+       jsonObject["lastModified"].toInteger() != lastModified)
+    {
+        return;
+    }
+
+    auto linksObject = jsonObject["links"].toObject();
+    for(auto it = linksObject.begin(); it != linksObject.end(); ++it)
+    {
+        // JSON has no NaN, it is stored as null
+        auto link = it.value().toArray();
+        m_storedLinks.insert(it.key(),
+                             TOCLink {
+                                 .pageNumber = link[0].toInt(-1),
+                                 .yOffset = static_cast<float>(
+                                     link[1].toDouble(qQNaN())),
+                             });
+    }
+}
+
+void TOCLinkResolver::saveToCache() const
+{
+    QJsonObject linksObject;
+    for(auto it = m_storedLinks.begin(); it != m_storedLinks.end(); ++it)
+    {
+        auto yOffset = it.value().yOffset;
+        linksObject.insert(it.key(),
+                           QJsonArray {
+                               it.value().pageNumber,
+                               qIsNaN(yOffset) ? QJsonValue()
+                                               : QJsonValue(yOffset),
+                           });
+    }
+
+    QFileInfo fileInfo(m_filePath);
+    QJsonObject jsonObject {
+        { "fileSize", fileInfo.size() },
+        { "lastModified", fileInfo.lastModified().toMSecsSinceEpoch() },
+        { "links", linksObject },
+    };
+
+    auto cacheFilePath = getCacheFilePath(m_cacheKey);
+    QSaveFile cacheFile(cacheFilePath);
+    if(!cacheFile.open(QFile::WriteOnly))
+    {
+        qWarning() << QString("Saving table of contents links failed. "
+                              "Failed opening file at: %1")
+                          .arg(cacheFilePath);
+        return;
+    }
+
+    cacheFile.write(QJsonDocument(jsonObject).toJson(QJsonDocument::Compact));
+    if(!cacheFile.commit())
+    {
+        qWarning() << QString("Saving table of contents links failed. "
+                              "Failed writing file at: %1")
+                          .arg(cacheFilePath);
+    }
+}
+
+void TOCLinkResolver::removeFromCache(const QString& cacheKey)
+{
+    QFile::remove(getCacheFilePath(cacheKey));
+}
+
+QString TOCLinkResolver::getCacheFilePath(const QString& cacheKey)
+{
+    QDir dir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+    dir.mkpath("toc");
+    dir.cd("toc");
+
+    // The key might contain characters which are not allowed in file names
+    auto hash = QCryptographicHash::hash(cacheKey.toUtf8(),
+                                         QCryptographicHash::Sha1);
+    return dir.filePath(QString::fromLatin1(hash.toHex()) + ".json");
+}
+
+}  // namespace application::core
@@ -0,0 +1,91 @@
+#pragma once
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <atomic>
+#include <optional>
+#include "application_export.hpp"
+#include "mupdf/classes.h"
+
+namespace application::core
+{
+
+/**
+ * Where a table of contents entry points to in the book.
+ */
+struct TOCLink
+{
+    int pageNumber = -1;
+    float yOffset = 0;
+};
+
+/**
+ * The TOCLinkResolver finds out which page the links of a book's table of
+ * contents point to without blocking the GUI thread.
+ *
+ * The entries of reflowable documents (e.g. EPUBs) only know the file and
+ * anchor they point to, getting the page requires laying out the chapter. So
+ * the links are only resolved when they are requested, which happens when
+ * their entry is shown. All links requested at the same time are resolved
+ * together on a background thread from a separate FzDocument.
+ *
+ * The resolved links are stored in a small file in the app's data directory,
+ * so that they are known right away the next time the book is opened. The
+ * stored links are invalidated when the book's file changes.
+ */
+class APPLICATION_EXPORT TOCLinkResolver : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * The cache key identifies the book's stored links, e.g. the file's hash.
+     */
+    TOCLinkResolver(const QString& filePath, const QString& cacheKey,
+                    QObject* parent = nullptr);
+    ~TOCLinkResolver();
+
+    std::optional<TOCLink> findResolvedLink(const QString& uri) const;
+
+    /**
+     * Resolves the link in the background, the result is reported through
+     * linksResolved(). Requesting the same link again does nothing.
+     */
+    void resolve(const QString& uri);
+
+    /**
+     * Removes the stored links of a book, e.g. once the book's file was
+     * removed.
+     */
+    static void removeFromCache(const QString& cacheKey);
+
+signals:
+    void linksResolved(const QHash<QString, application::core::TOCLink>& links);
+
+private:
+    void startResolving();
+    QHash<QString, TOCLink> resolveLinks(const QStringList& uris);
+    TOCLink resolveLink(const QString& uri);
+    void loadFromCache();
+    void saveToCache() const;
+    static QString getCacheFilePath(const QString& cacheKey);
+
+    QString m_filePath;
+    QString m_cacheKey;
+    QHash<QString, TOCLink> m_resolvedLinks;
+    QSet<QString> m_requestedUris;
+    QStringList m_pendingUris;
+    QThreadPool m_threadPool;
+    std::atomic<bool> m_stopped = false;
+
+    // Only used by the background thread
+    mupdf::FzDocument m_document;
+    QHash<QString, TOCLink> m_storedLinks;
+    bool m_storedLinksLoaded = false;
+    bool m_storedLinksChanged = false;
+};
+
+}  // namespace application::core
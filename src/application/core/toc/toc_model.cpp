@@ -1,18 +1,20 @@
 #include "toc/toc_model.hpp"
 #include <QDebug>
-#include <QStack>
 
 namespace application::core
 {
 
-TOCModel::TOCModel(fz_outline* outline, mupdf::FzDocument& document,
-                   QObject* parent) :
+TOCModel::TOCModel(mupdf::FzOutline outline, const QString& filePath,
+                   const QString& cacheKey, QObject* parent) :
     QAbstractItemModel(parent),
-    m_document(document)
+    m_outline(outline),
+    m_linkResolver(std::make_unique<TOCLinkResolver>(filePath, cacheKey))
 {
-    m_rootItem = new TOCItem(TOCItemData());
+    connect(m_linkResolver.get(), &TOCLinkResolver::linksResolved, this,
+            &TOCModel::setResolvedLinks);
 
-    setupModelData(outline);
+    m_rootItem = new TOCItem(TOCItemData());
+    appendChildren(m_rootItem, m_outline.m_internal);
 }
 
 TOCModel::~TOCModel()
@@ -26,6 +28,12 @@ QVariant TOCModel::data(const QModelIndex& index, int role) const
         return QVariant();
 
     auto item = static_cast<TOCItem*>(index.internalPointer());
+
+    // Only entries which are shown request their page, so this resolves the
+    // links of the visible entries.
+    if(role == PageNumberRole || role == YOffsetRole)
+        requestLink(item);
+
     switch(role)
     {
     case TitleRole:
@@ -111,72 +119,111 @@ int TOCModel::columnCount(const QModelIndex& parent) const
     return roleNames().count();
 }
 
-void TOCModel::setupModelData(fz_outline* outline)
+bool TOCModel::hasChildren(const QModelIndex& parent) const
 {
-    if(outline == nullptr)
-        return;
+    if(parent.column() > 0)
+        return false;
 
-    QStack<TOCItem*> stack;
-    stack.push(m_rootItem);
+    TOCItem* parentItem;
+    if(!parent.isValid())
+        parentItem = m_rootItem;
+    else
+        parentItem = static_cast<TOCItem*>(parent.internalPointer());
 
-    auto curr = getTOCItemFromOutline(outline);
-    while(true)
-    {
-        curr->setParent(stack.top());
-        curr->parentItem()->appendChild(curr);
+    return parentItem->hasChildren();
+}
 
-        while(outline->down != nullptr)
-        {
-            stack.push(curr);
+bool TOCModel::canFetchMore(const QModelIndex& parent) const
+{
+    if(!parent.isValid())
+        return false;
 
-            auto child = getTOCItemFromOutline(outline->down);
+    auto parentItem = static_cast<TOCItem*>(parent.internalPointer());
+    return parentItem->hasChildren() && parentItem->childCount() == 0;
+}
 
-            curr->appendChild(child);
-            child->setParent(curr);
+void TOCModel::fetchMore(const QModelIndex& parent)
+{
+    if(!canFetchMore(parent))
+        return;
 
-            curr = child;
-            outline = outline->down;
-        }
+    auto parentItem = static_cast<TOCItem*>(parent.internalPointer());
+    auto firstChild = parentItem->data().internal->down;
 
-        while(outline->next == nullptr)
-        {
-            if(stack.top() == m_rootItem)
-                return;
+    int count = 0;
+    for(auto child = firstChild; child != nullptr; child = child->next)
+        ++count;
 
-            curr = stack.pop();
-            outline = curr->data().internal;
-        }
+    beginInsertRows(parent, 0, count - 1);
+    appendChildren(parentItem, firstChild);
+    endInsertRows();
+}
 
-        curr = getTOCItemFromOutline(outline->next);
-        outline = outline->next;
+void TOCModel::appendChildren(TOCItem* parent, fz_outline* firstChild)
+{
+    for(auto child = firstChild; child != nullptr; child = child->next)
+    {
+        auto item = getTOCItemFromOutline(child);
+        item->setParent(parent);
+        parent->appendChild(item);
     }
 }
 
 TOCItem* TOCModel::getTOCItemFromOutline(fz_outline* outline)
 {
-    auto location = outline->page;
-    float yOffset = outline->y;
+    auto item = new TOCItem(TOCItemData {
+        .title = QString(outline->title),
+        .uri = QString(outline->uri),
+        .internal = outline,
+    });
 
     // Outlines come with the page number set to -1 if they are reflowable
     // documents (e.g. epub), because its quite expensive to get absolute page
-    // numbers for them. Since we need absolute page numbers, we need to resolve
-    // their links manually and then convert the location to page numbers.
-    if(location.page == -1)
+    // numbers for them. Fixed layout documents only have a single chapter, so
+    // their page numbers are absolute already.
+    auto location = outline->page;
+    if(location.chapter == 0 && location.page != -1)
+        item->setLink(location.page, outline->y);
+    else if(outline->uri == nullptr)
+        item->setLink(-1, 0);
+    else if(auto link = m_linkResolver->findResolvedLink(item->data().uri))
+        item->setLink(link->pageNumber, link->yOffset);
+
+    return item;
+}
+
+void TOCModel::requestLink(TOCItem* item) const
+{
+    auto data = item->data();
+    if(data.resolved || m_unresolvedItems.contains(data.uri, item))
+        return;
+
+    // Entries with the same link might have been resolved already
+    if(auto link = m_linkResolver->findResolvedLink(data.uri))
     {
-        location = *m_document.fz_resolve_link(outline->uri, nullptr, &yOffset)
-                        .internal();
+        item->setLink(link->pageNumber, link->yOffset);
+        return;
     }
 
-    auto pageNumber = m_document.fz_page_number_from_location(location);
+    m_unresolvedItems.insert(data.uri, item);
+    m_linkResolver->resolve(data.uri);
+}
 
-    TOCItemData data {
-        .title = QString(outline->title),
-        .pageNumber = pageNumber,
-        .yOffset = yOffset,
-        .internal = outline,
-    };
+void TOCModel::setResolvedLinks(const QHash<QString, TOCLink>& links)
+{
+    for(auto it = links.begin(); it != links.end(); ++it)
+    {
+        const auto items = m_unresolvedItems.values(it.key());
+        for(auto item : items)
+        {
+            item->setLink(it.value().pageNumber, it.value().yOffset);
 
-    return new TOCItem(data);
+            auto index = createIndex(item->row(), 0, item);
+            emit dataChanged(index, index, { PageNumberRole, YOffsetRole });
+        }
+
+        m_unresolvedItems.remove(it.key());
+    }
 }
 
-}  // namespace application::core
\ No newline at end of file
+}  // namespace application::core
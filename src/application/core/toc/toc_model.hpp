@@ -1,19 +1,35 @@
 #pragma once
 #include <QAbstractItemModel>
+#include <QMultiHash>
+#include <QString>
+#include <memory>
 #include "application_export.hpp"
 #include "mupdf/classes2.h"
 #include "toc_item.hpp"
+#include "toc_link_resolver.hpp"
 
 namespace application::core
 {
 
+/**
+ * The TOCModel provides the table of contents of a book as a tree.
+ *
+ * Outlines of reference books can have tens of thousands of entries, so the
+ * children of an entry are only added once it is expanded (see fetchMore()).
+ * The page an entry points to is resolved by the TOCLinkResolver once it is
+ * first requested, until then the entry's page number is -1.
+ */
 class APPLICATION_EXPORT TOCModel : public QAbstractItemModel
 {
     Q_OBJECT
 
 public:
-    explicit TOCModel(fz_outline* outline, mupdf::FzDocument& document,
-                      QObject* parent = nullptr);
+    /**
+     * The file path and cache key are the book's, the links are resolved from
+     * a separate document opened from them.
+     */
+    TOCModel(mupdf::FzOutline outline, const QString& filePath,
+             const QString& cacheKey, QObject* parent = nullptr);
     ~TOCModel();
 
     enum Roles
@@ -31,13 +47,20 @@ public:
     int rowCount(const QModelIndex& parent = QModelIndex()) const override;
     QHash<int, QByteArray> roleNames() const override;
     int columnCount(const QModelIndex& parent) const override;
+    bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
 
 private:
-    void setupModelData(fz_outline* outline);
+    void appendChildren(TOCItem* parent, fz_outline* firstChild);
     TOCItem* getTOCItemFromOutline(fz_outline* outline);
+    void requestLink(TOCItem* item) const;
+    void setResolvedLinks(const QHash<QString, TOCLink>& links);
 
     TOCItem* m_rootItem;
-    mupdf::FzDocument& m_document;
+    mupdf::FzOutline m_outline;
+    std::unique_ptr<TOCLinkResolver> m_linkResolver;
+    mutable QMultiHash<QString, TOCItem*> m_unresolvedItems;
 };
 
 }  // namespace application::core
@@ -1,153 +1,509 @@
 #include "book_searcher.hpp"
 #include <QDebug>
+#include <QMutexLocker>
+#include <QThread>
+#include <algorithm>
+#include "layout/layout_cache.hpp"
 #include "mupdf/fitz/geometry.h"
-#include "qnumeric.h"
 
 namespace application::core::utils
 {
 
-BookSearcher::BookSearcher(mupdf::FzDocument* fzDocument) :
-    m_fzDocument(fzDocument)
+BookSearcher::BookSearcher(const QString& filePath, const QString& cacheKey,
+                           TextPageCache* textPageCache, QObject* parent) :
+    QObject(parent),
+    m_filePath(filePath),
+    m_cacheKey(cacheKey),
+    m_textPageCache(textPageCache)
 {
+    m_threadPool.setMaxThreadCount(
+        std::min(QThread::idealThreadCount(), maxWorkerCount));
+
+    m_releaseDocumentsTimer.setSingleShot(true);
+    m_releaseDocumentsTimer.setInterval(30000);
+    connect(&m_releaseDocumentsTimer, &QTimer::timeout, this,
+            &BookSearcher::releaseIdleDocuments);
+
+    // Open the first document right away, so that it is ready when searching
+    m_threadPool.start(
+        [this]()
+        {
+            releaseDocument(acquireDocument());
+        });
+}
+
+BookSearcher::~BookSearcher()
+{
+    ++m_generation;
+    m_threadPool.waitForDone();
+}
+
+void BookSearcher::setSearchIndex(
+    std::shared_ptr<const SearchIndex> searchIndex)
+{
+    m_searchIndex = std::move(searchIndex);
 }
 
 void BookSearcher::search(const QString& text, SearchOptions options)
 {
     clearSearch();
-    extractSearchHitsFromBook(m_searchHits, text.toStdString().c_str(),
-                              options);
+    m_searching = true;
+    m_searchStartPage = options.fromStart ? 0 : options.currentPage;
+
+    // E.g. an invalid regular expression, which can't match anything
+    if(!TextMatcher(text, options).isValid())
+    {
+        finishSearch(m_generation);
+        return;
+    }
+
+    if(searchWithIndex(text, options, m_generation))
+        return;
+
+    auto run = std::make_shared<SearchRun>();
+    run->text = text;
+    run->options = options;
+    run->generation = m_generation;
+
+    // Pages that don't contain all terms of the text can't contain a match.
+    // This doesn't hold for regular expressions, whose text isn't the text
+    // they match.
+    if(m_searchIndex != nullptr && !options.regularExpression &&
+       !SearchIndex::splitIntoTerms(text).empty())
+    {
+        run->candidatePages = m_searchIndex->findCandidatePages(text);
+    }
+
+    m_releaseDocumentsTimer.stop();
+    auto workerCount = m_threadPool.maxThreadCount();
+    run->activeWorkers = workerCount;
+    for(int i = 0; i < workerCount; ++i)
+    {
+        m_threadPool.start(
+            [this, run]()
+            {
+                searchPages(run);
+            });
+    }
 }
 
 void BookSearcher::clearSearch()
 {
+    // Cancels the running search, its remaining hits are dropped
+    ++m_generation;
+    m_searching = false;
     m_searchHits.clear();
-    m_currentSearchHit = -1;
+    m_currentSearchHit = {};
+}
+
+bool BookSearcher::isSearching() const
+{
+    return m_searching;
+}
+
+bool BookSearcher::hasCurrentSearchHit() const
+{
+    return m_currentSearchHit.isValid();
+}
+
+const SearchHits& BookSearcher::getSearchHits() const
+{
+    return m_searchHits;
 }
 
 SearchHit BookSearcher::firstSearchHit()
 {
-    if(m_searchHits.empty())
-        return m_invalidSearchHit;
+    // The search started at this page, so its first hit is the next from it
+    m_currentSearchHit = m_searchHits.findFirstFrom(m_searchStartPage);
+    return m_searchHits.getHit(m_currentSearchHit);
+}
+
+SearchHit BookSearcher::nextSearchHit(int currentPage)
+{
+    if(!m_currentSearchHit.isValid())
+        return m_searchHits.getHit(m_currentSearchHit);
+
+    if(m_currentSearchHit.pageNumber == currentPage)
+        m_currentSearchHit = m_searchHits.findNext(m_currentSearchHit);
+    else
+        m_currentSearchHit = m_searchHits.findFirstFrom(currentPage);
+
+    return m_searchHits.getHit(m_currentSearchHit);
+}
+
+SearchHit BookSearcher::previousSearchHit(int currentPage)
+{
+    if(!m_currentSearchHit.isValid())
+        return m_searchHits.getHit(m_currentSearchHit);
 
-    auto hit = m_searchHits.front();
-    m_currentSearchHit = 0;
+    if(m_currentSearchHit.pageNumber == currentPage)
+        m_currentSearchHit = m_searchHits.findPrevious(m_currentSearchHit);
+    else
+        m_currentSearchHit = m_searchHits.findLastUpTo(currentPage);
 
-    return hit;
+    return m_searchHits.getHit(m_currentSearchHit);
 }
 
-SearchHit BookSearcher::nextSearchHit()
+SearchHit BookSearcher::peekNextSearchHit() const
 {
-    if(m_currentSearchHit == -1 || m_searchHits.empty())
-        return m_invalidSearchHit;
+    if(!m_currentSearchHit.isValid())
+        return m_searchHits.getHit(m_currentSearchHit);
 
-    // Wrap to the beginning once you are over the end
-    ++m_currentSearchHit;
-    if(m_currentSearchHit >= m_searchHits.size())
+    return m_searchHits.getHit(m_searchHits.findNext(m_currentSearchHit));
+}
+
+bool BookSearcher::searchWithIndex(const QString& text,
+                                   SearchOptions options, int generation)
+{
+    if(m_searchIndex == nullptr || !options.wholeWords ||
+       options.caseSensitive || options.regularExpression)
     {
-        m_currentSearchHit = 0;
+        return false;
     }
 
-    auto hit = m_searchHits.at(m_currentSearchHit);
-    return hit;
+    // The index only knows the positions of whole words, so it can only
+    // answer searches for a single one. Case sensitive searches need to
+    // compare the original text, which the index doesn't store.
+    auto word = text.trimmed();
+    auto terms = SearchIndex::splitIntoTerms(word);
+    if(terms.size() != 1 || terms.first() != SearchIndex::normalize(word))
+        return false;
+
+    int startPage = 0;
+    if(!options.fromStart)
+    {
+        startPage = std::clamp(options.currentPage, 0,
+                               std::max(m_searchIndex->getPageCount() - 1, 0));
+    }
+
+    // Start at the start page and wrap around, like when searching the pages
+    std::vector<SearchHit> hits;
+    auto occurrences = m_searchIndex->findWord(word);
+    std::ranges::stable_partition(occurrences,
+                                  [startPage](const auto& occurrence)
+                                  {
+                                      return occurrence.pageNumber >= startPage;
+                                  });
+    for(auto& occurrence : occurrences)
+    {
+        auto& rect = occurrence.rect;
+        fz_rect fzRect { static_cast<float>(rect.left()),
+                         static_cast<float>(rect.top()),
+                         static_cast<float>(rect.right()),
+                         static_cast<float>(rect.bottom()) };
+
+        hits.push_back(SearchHit {
+            .pageNumber = occurrence.pageNumber,
+            .rect = mupdf::FzQuad(mupdf::ll_fz_quad_from_rect(fzRect)),
+        });
+    }
+
+    // Delivered the same way as the hits of searching the pages
+    if(!hits.empty())
+        addSearchHits(std::move(hits), generation);
+    finishSearch(generation);
+
+    return true;
 }
 
-SearchHit BookSearcher::previousSearchHit()
+void BookSearcher::searchPages(const std::shared_ptr<SearchRun>& run)
 {
-    if(m_currentSearchHit == -1 || m_searchHits.empty())
-        return m_invalidSearchHit;
+    auto document = acquireDocument();
+    int pageCount = 0;
+    try
+    {
+        if(document != nullptr)
+            pageCount = document->fz_count_pages();
+    }
+    catch(...)
+    {
+        qWarning() << QString("Failed counting the pages of book at: %1")
+                          .arg(m_filePath);
+    }
 
-    // Wrap to the beginning once you are over the end
-    --m_currentSearchHit;
-    if(m_currentSearchHit <= 0)
+    // A worker without a document must not take pages from the others,
+    // whose hits would never be stored.
+    if(pageCount <= 0)
     {
-        m_currentSearchHit = m_searchHits.size() - 1;
+        releaseDocument(std::move(document));
+        if(--run->activeWorkers == 0)
+            finishSearch(run->generation);
+        return;
     }
 
-    auto hit = m_searchHits.at(m_currentSearchHit);
-    return hit;
+    int startPage = 0;
+    if(!run->options.fromStart)
+        startPage = std::clamp(run->options.currentPage, 0, pageCount - 1);
+
+    // Every worker has its own matcher, since it is not thread-safe
+    TextMatcher matcher(run->text, run->options);
+    while(run->generation == m_generation)
+    {
+        auto index = run->nextIndex++;
+        if(index >= pageCount)
+            break;
+
+        // Wrap around to the pages before the start page at the end
+        auto pageNumber = (startPage + index) % pageCount;
+        std::vector<SearchHit> hits;
+        if(run->candidatePages.has_value() &&
+           !run->candidatePages->contains(pageNumber))
+        {
+            storePageHits(*run, index, pageCount, std::move(hits));
+            continue;
+        }
+
+        try
+        {
+            hits = searchPage(*document, pageNumber, matcher);
+        }
+        catch(...)
+        {
+            qWarning() << QString("Failed searching page %1 for: %2")
+                              .arg(pageNumber)
+                              .arg(run->text);
+        }
+
+        // Also stored without hits, so that the following pages are delivered
+        storePageHits(*run, index, pageCount, std::move(hits));
+    }
+
+    releaseDocument(std::move(document));
+
+    // All hits were delivered by the time the last worker is done
+    if(--run->activeWorkers == 0)
+        finishSearch(run->generation);
 }
 
-void BookSearcher::extractSearchHitsFromBook(std::vector<SearchHit>& results,
-                                             const char* text,
-                                             SearchOptions options) const
+std::vector<SearchHit> BookSearcher::searchPage(
+    mupdf::FzDocument& document, int pageNumber,
+    const TextMatcher& matcher) const
 {
-    mupdf::FzStextOptions sTextOptions;
-    const int maxHits = 1000;
+    auto extractTextPage = [&document, pageNumber]()
+    {
+        mupdf::FzStextOptions sTextOptions;
+        return std::make_shared<mupdf::FzStextPage>(document, pageNumber,
+                                                    sTextOptions);
+    };
+
+    // Pages that were shown or searched before are not extracted again
+    auto textPage = m_textPageCache != nullptr
+                        ? m_textPageCache->getTextPage(pageNumber,
+                                                       extractTextPage)
+                        : extractTextPage();
 
-    for(int i = 0; i < m_fzDocument->fz_count_pages(); ++i)
+    // The text of the page, together with the character each of its code
+    // units belongs to. Lines are joined by spaces, which belong to none.
+    QString text;
+    std::vector<fz_stext_char*> characters;
+    for(auto block = textPage->m_internal->first_block; block != nullptr;
+        block = block->next)
     {
-        mupdf::FzStextPage textPage(*m_fzDocument, i, sTextOptions);
-        int hitMarks[maxHits];
-        auto hits = textPage.search_stext_page(text, hitMarks, maxHits);
+        if(block->type != FZ_STEXT_BLOCK_TEXT)
+            continue;
 
-        results.reserve(hits.size());
-        for(auto& hit : hits)
+        for(auto line = block->u.t.first_line; line != nullptr;
+            line = line->next)
         {
-            if(options.wholeWords && !isWholeWord(textPage, hit))
-                continue;
+            if(!text.isEmpty())
+            {
+                text.append(' ');
+                characters.push_back(nullptr);
+            }
 
-            if(options.caseSensitive && !isCaseSensitive(textPage, hit, text))
-                continue;
+            for(auto character = line->first_char; character != nullptr;
+                character = character->next)
+            {
+                auto codePoint = static_cast<char32_t>(character->c);
+                auto characterText = QString::fromUcs4(&codePoint, 1);
+                text.append(characterText);
+                characters.insert(characters.end(), characterText.size(),
+                                  character);
+            }
+        }
+    }
+
+    std::vector<SearchHit> results;
+    for(auto& match : matcher.findMatches(text))
+        addMatchHits(characters, match, pageNumber, results);
+
+    return results;
+}
 
-            SearchHit searchHit {
-                .pageNumber = i,
-                .rect = hit,
-            };
-            results.emplace_back(searchHit);
+void BookSearcher::addMatchHits(const std::vector<fz_stext_char*>& characters,
+                                const TextMatcher::Match& match,
+                                int pageNumber, std::vector<SearchHit>& hits)
+{
+    // A match that spans multiple lines gets a hit for each of them, which
+    // reaches from the first to the last of its characters on that line.
+    fz_stext_char* first = nullptr;
+    fz_stext_char* last = nullptr;
+    auto addHit = [&]()
+    {
+        if(first == nullptr)
+            return;
+
+        fz_quad quad {
+            .ul = first->quad.ul,
+            .ur = last->quad.ur,
+            .ll = first->quad.ll,
+            .lr = last->quad.lr,
+        };
+        hits.push_back(SearchHit {
+            .pageNumber = pageNumber,
+            .rect = mupdf::FzQuad(quad),
+        });
+        first = nullptr;
+    };
+
+    for(auto i = match.start; i < match.start + match.length; ++i)
+    {
+        auto character = characters.at(i);
+        if(character == nullptr)
+        {
+            addHit();
+            continue;
         }
+
+        if(first == nullptr)
+            first = character;
+        last = character;
     }
 
-    if(!options.fromStart)
-        results = sortHitsToStartFromCurrentPage(results, options.currentPage);
+    addHit();
 }
 
-bool BookSearcher::isWholeWord(const mupdf::FzStextPage& textPage,
-                               const mupdf::FzQuad& quad) const
+void BookSearcher::storePageHits(SearchRun& run, int index, int pageCount,
+                                 std::vector<SearchHit> hits)
 {
-    int yMiddle = quad.ul.y + (quad.ll.y - quad.ul.y) / 2;
-    mupdf::FzPoint begin(quad.ul.x, yMiddle);
-    mupdf::FzPoint end(quad.ur.x, yMiddle);
-    auto wholeWordQuad =
-        textPage.fz_snap_selection(begin, end, FZ_SELECT_WORDS);
+    QMutexLocker locker(&run.mutex);
+    if(run.pageSearched.empty())
+    {
+        run.pageHits.resize(pageCount);
+        run.pageSearched.resize(pageCount, false);
+    }
 
-    auto wholeWordQuadWidth = wholeWordQuad.ur.x - wholeWordQuad.ul.x;
-    auto quadWidth = quad.ur.x - quad.ul.x;
-    bool areTheSame = qFuzzyCompare(wholeWordQuadWidth, quadWidth);
+    run.pageHits[index] = std::move(hits);
+    run.pageSearched[index] = true;
+
+    // Deliver the hits of all pages that are now next in order. This happens
+    // under the lock, so that the deliveries are queued in order as well.
+    std::vector<SearchHit> hitsInOrder;
+    while(run.nextIndexToDeliver < pageCount &&
+          run.pageSearched[run.nextIndexToDeliver])
+    {
+        auto& pageHits = run.pageHits[run.nextIndexToDeliver];
+        hitsInOrder.insert(hitsInOrder.end(), pageHits.begin(),
+                           pageHits.end());
+        pageHits = {};
+        ++run.nextIndexToDeliver;
+    }
 
-    return areTheSame;
+    if(!hitsInOrder.empty())
+        addSearchHits(std::move(hitsInOrder), run.generation);
 }
 
-bool BookSearcher::isCaseSensitive(mupdf::FzStextPage& textPage,
-                                   const mupdf::FzQuad& quad,
-                                   const QString& needle) const
+void BookSearcher::addSearchHits(std::vector<SearchHit> hits, int generation)
 {
-    int yMiddle = quad.ul.y + (quad.ll.y - quad.ul.y) / 2;
-    mupdf::FzPoint begin(quad.ul.x, yMiddle);
-    mupdf::FzPoint end(quad.ur.x, yMiddle);
+    // The hits are stored on the thread the searcher lives in, they are
+    // dropped if the search was cancelled in the meantime.
+    QMetaObject::invokeMethod(
+        this,
+        [this, hits = std::move(hits), generation]()
+        {
+            if(generation != m_generation)
+                return;
+
+            // The hits might span multiple pages, announce every page
+            auto pageBegin = hits.begin();
+            while(pageBegin != hits.end())
+            {
+                auto pageEnd = std::find_if(
+                    pageBegin, hits.end(),
+                    [pageBegin](const SearchHit& hit)
+                    {
+                        return hit.pageNumber != pageBegin->pageNumber;
+                    });
 
-    auto text = textPage.fz_copy_selection(begin, end, 1);
-    return QString::fromStdString(text) == needle;
+                std::vector<mupdf::FzQuad> quads;
+                quads.reserve(pageEnd - pageBegin);
+                for(auto it = pageBegin; it != pageEnd; ++it)
+                    quads.push_back(it->rect);
+
+                m_searchHits.addPageHits(pageBegin->pageNumber,
+                                         std::move(quads));
+                emit searchHitsFound(pageBegin->pageNumber,
+                                     static_cast<int>(pageEnd - pageBegin));
+                pageBegin = pageEnd;
+            }
+        },
+        Qt::QueuedConnection);
 }
 
-std::vector<SearchHit> BookSearcher::sortHitsToStartFromCurrentPage(
-    const std::vector<SearchHit>& hits, int currentPage) const
+void BookSearcher::finishSearch(int generation)
+{
+    QMetaObject::invokeMethod(
+        this,
+        [this, generation]()
+        {
+            // Also for cancelled searches, their workers are done as well
+            if(!m_searching || generation == m_generation)
+                m_releaseDocumentsTimer.start();
+
+            if(generation != m_generation)
+                return;
+
+            m_searching = false;
+            emit searchFinished(m_searchHits.getHitCount());
+        },
+        Qt::QueuedConnection);
+}
+
+std::unique_ptr<mupdf::FzDocument> BookSearcher::acquireDocument()
 {
-    std::vector<SearchHit> sortedHits;
-    // Hits at current page and after -> To the beginning
-    for(auto& hit : hits)
     {
-        if(hit.pageNumber >= currentPage)
-            sortedHits.push_back(hit);
+        QMutexLocker locker(&m_documentsMutex);
+        if(!m_documents.empty())
+        {
+            auto document = std::move(m_documents.back());
+            m_documents.pop_back();
+            return document;
+        }
     }
 
-    // Hits before the current page -> To the end
-    for(auto& hit : hits)
+    // Every document gets the context of the thread it is used on, which the
+    // MuPDF bindings clone from the main context for each thread.
+    try
     {
-        if(hit.pageNumber < currentPage)
-            sortedHits.push_back(hit);
+        return std::make_unique<mupdf::FzDocument>(
+            LayoutCache::openDocument(m_filePath, m_cacheKey));
     }
+    catch(...)
+    {
+        qWarning() << QString("Failed opening book for searching at: %1")
+                          .arg(m_filePath);
+        return nullptr;
+    }
+}
+
+void BookSearcher::releaseDocument(std::unique_ptr<mupdf::FzDocument> document)
+{
+    if(document == nullptr)
+        return;
+
+    QMutexLocker locker(&m_documentsMutex);
+    m_documents.push_back(std::move(document));
+}
+
+void BookSearcher::releaseIdleDocuments()
+{
+    if(m_searching)
+        return;
 
-    return sortedHits;
+    // One is kept, so that the next search doesn't need to open the book
+    QMutexLocker locker(&m_documentsMutex);
+    if(m_documents.size() > 1)
+        m_documents.resize(1);
 }
 
 }  // namespace application::core::utils
\ No newline at end of file
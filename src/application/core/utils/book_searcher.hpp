@@ -1,48 +1,141 @@
 #pragma once
 #include <mupdf/classes2.h>
+#include <QMutex>
+#include <QObject>
 #include <QString>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "application_export.hpp"
+#include "search_hits.hpp"
+#include "search_index.hpp"
 #include "search_options.hpp"
+#include "text_matcher.hpp"
+#include "text_page_cache.hpp"
 
 namespace application::core::utils
 {
 
-struct SearchHit
-{
-    int pageNumber;
-    mupdf::FzQuad rect;
-};
-
 /**
  * The BookSearcher class searches for text in a book and provides the search
  * results.
+ *
+ * Searching extracts the text of every page, which takes seconds for large
+ * books, so it is done on background threads. Pages are independent of each
+ * other, so they are distributed over a few workers, each of which uses its
+ * own FzDocument, since a document must not be used by multiple threads at
+ * once (the book's own one only from the GUI thread). The documents are kept
+ * for the next search, but all except one are closed once searching stopped
+ * for a while, since every one of them holds a copy of the book.
+ *
+ * The pages are searched starting at the current page (or the first page,
+ * when searching from the start) and wrapping around. The hits are delivered
+ * in that order, as soon as a page and all pages before it were searched, so
+ * that the first hit can be shown right away. Starting a new search or
+ * clearing it cancels the running one.
+ *
+ * The text of every page is matched by a TextMatcher, and the matches are
+ * then mapped back to the positions of their characters on the page. The
+ * text of the pages is taken from the TextPageCache, if one is given, so
+ * pages that were already shown or searched are not extracted again.
+ *
+ * Once the book's SearchIndex is available, whole-word searches are answered
+ * from it directly. Other searches still need the exact positions of the
+ * matches, but only the pages the index names as candidates are searched.
  */
-class BookSearcher
+class APPLICATION_EXPORT BookSearcher : public QObject
 {
+    Q_OBJECT
+
 public:
-    BookSearcher(mupdf::FzDocument* fzDocument);
+    BookSearcher(const QString& filePath, const QString& cacheKey,
+                 TextPageCache* textPageCache = nullptr,
+                 QObject* parent = nullptr);
+    ~BookSearcher();
 
+    void setSearchIndex(std::shared_ptr<const SearchIndex> searchIndex);
     void search(const QString& text, SearchOptions options);
     void clearSearch();
+    bool isSearching() const;
+    bool hasCurrentSearchHit() const;
+    const SearchHits& getSearchHits() const;
     SearchHit firstSearchHit();
-    SearchHit nextSearchHit();
-    SearchHit previousSearchHit();
+
+    /**
+     * Moves to the hit after (or before) the current one. If the user went
+     * to a different page since, it moves to the first hit from that page on
+     * (or the last one up to it) instead.
+     */
+    SearchHit nextSearchHit(int currentPage);
+    SearchHit previousSearchHit(int currentPage);
+    SearchHit peekNextSearchHit() const;
+
+signals:
+    void searchHitsFound(int pageNumber, int hitCount);
+    void searchFinished(int hitCount);
 
 private:
-    void extractSearchHitsFromBook(std::vector<SearchHit>& results,
-                                   const char* text,
-                                   SearchOptions options) const;
-    bool isWholeWord(const mupdf::FzStextPage& textPage,
-                     const mupdf::FzQuad& quad) const;
-    bool isCaseSensitive(mupdf::FzStextPage& textPage,
-                         const mupdf::FzQuad& quad,
-                         const QString& needle) const;
-    std::vector<SearchHit> sortHitsToStartFromCurrentPage(
-        const std::vector<SearchHit>& hits, int currentPage) const;
-
-    mupdf::FzDocument* m_fzDocument;
-    std::vector<SearchHit> m_searchHits;
-    SearchHit m_invalidSearchHit { -1, mupdf::FzQuad() };
-    int m_currentSearchHit;
+    /**
+     * The state of a search, shared between the workers taking part in it.
+     * Pages are handed out by their index in the search order, under which
+     * their hits are stored until all previous pages were delivered.
+     */
+    struct SearchRun
+    {
+        QString text;
+        SearchOptions options;
+        int generation;
+        std::optional<QSet<int>> candidatePages;
+        std::atomic<int> nextIndex = 0;
+        std::atomic<int> activeWorkers = 0;
+
+        QMutex mutex;
+        std::vector<std::vector<SearchHit>> pageHits;
+        std::vector<bool> pageSearched;
+        int nextIndexToDeliver = 0;
+    };
+
+    bool searchWithIndex(const QString& text, SearchOptions options,
+                         int generation);
+    void searchPages(const std::shared_ptr<SearchRun>& run);
+    std::vector<SearchHit> searchPage(mupdf::FzDocument& document,
+                                      int pageNumber,
+                                      const TextMatcher& matcher) const;
+    static void addMatchHits(const std::vector<fz_stext_char*>& characters,
+                             const TextMatcher::Match& match, int pageNumber,
+                             std::vector<SearchHit>& hits);
+    void storePageHits(SearchRun& run, int index, int pageCount,
+                       std::vector<SearchHit> hits);
+    void addSearchHits(std::vector<SearchHit> hits, int generation);
+    void finishSearch(int generation);
+    std::unique_ptr<mupdf::FzDocument> acquireDocument();
+    void releaseDocument(std::unique_ptr<mupdf::FzDocument> document);
+    void releaseIdleDocuments();
+
+    // Searching is mostly limited by memory bandwidth, more workers than this
+    // hardly make it faster but each needs its own document.
+    static constexpr int maxWorkerCount = 4;
+
+    // Documents are reused between searches, since opening (and laying out)
+    // a book is expensive. Every worker holds one while it is searching.
+    QString m_filePath;
+    QString m_cacheKey;
+    TextPageCache* m_textPageCache;
+    std::vector<std::unique_ptr<mupdf::FzDocument>> m_documents;
+    QMutex m_documentsMutex;
+    QTimer m_releaseDocumentsTimer;
+
+    QThreadPool m_threadPool;
+    std::atomic<int> m_generation = 0;
+    bool m_searching = false;
+    std::shared_ptr<const SearchIndex> m_searchIndex;
+
+    SearchHits m_searchHits;
+    SearchHits::Position m_currentSearchHit;
+    int m_searchStartPage = 0;
 };
 
-}  // namespace application::core::utils
\ No newline at end of file
+}  // namespace application::core::utils
@@ -1,7 +1,6 @@
 #pragma once
 #include <mupdf/classes.h>
 #include <mupdf/classes2.h>
-#include <QImage>
 #include <QPointF>
 #include <QRectF>
 #include "mupdf/fitz/geometry.h"
@@ -13,12 +12,6 @@ namespace application::core::utils
 namespace
 {
 
-void imageCleanupHandler(void* data)
-{
-    unsigned char* samples = static_cast<unsigned char*>(data);
-    delete[] samples;
-}
-
 QRectF fzRectToQRectF(const mupdf::FzRect& rect)
 {
     return QRectF(rect.x0, rect.y0, rect.x1 - rect.x0, rect.y1 - rect.y0);
@@ -76,23 +69,6 @@ inline QRectF fzQuadToQRectF(const mupdf::FzQuad& rect)
     return QRectF(rect.ul.x, rect.ul.y, width, height);
 }
 
-inline QImage qImageFromPixmap(mupdf::FzPixmap pixmap)
-{
-    int width = pixmap.w();
-    int height = pixmap.h();
-    int stride = pixmap.stride();
-    auto samples = pixmap.samples();
-
-    // Copy samples
-    std::size_t length = stride * height;
-    unsigned char* destination = new unsigned char[length + 1];
-    std::copy(samples, samples + length + 1, destination);
-
-    QImage image(destination, width, height, stride, QImage::Format_RGB888,
-                 imageCleanupHandler, destination);
-    return image;
-}
-
 inline mupdf::FzPoint qPointToFzPoint(const QPointF& qPoint, double scaler = 1)
 {
     return mupdf::FzPoint(qPoint.x() * scaler, qPoint.y() * scaler);
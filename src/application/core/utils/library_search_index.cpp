@@ -0,0 +1,178 @@
+#include "library_search_index.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace application::core::utils
+{
+
+void LibrarySearchIndex::addBook(const QUuid& uuid, const QString& fileHash,
+                                 const SearchIndex& index)
+{
+    removeBook(uuid);
+
+    // Book numbers only ever increase, so the postings stay sorted by them
+    auto bookNumber = m_nextBookNumber++;
+    m_books.insert(bookNumber, BookEntry { uuid, fileHash });
+    m_bookNumbers.insert(uuid, bookNumber);
+
+    auto frequencies = index.getTermFrequencies();
+    for(auto it = frequencies.cbegin(); it != frequencies.cend(); ++it)
+        m_terms[it.key()].append(Posting { bookNumber, it.value() });
+}
+
+void LibrarySearchIndex::removeBook(const QUuid& uuid)
+{
+    auto bookNumber = m_bookNumbers.value(uuid, -1);
+    if(bookNumber == -1)
+        return;
+
+    m_bookNumbers.remove(uuid);
+    m_books.remove(bookNumber);
+
+    for(auto it = m_terms.begin(); it != m_terms.end();)
+    {
+        it.value().removeIf(
+            [bookNumber](const Posting& posting)
+            {
+                return posting.bookNumber == bookNumber;
+            });
+
+        if(it.value().isEmpty())
+            it = m_terms.erase(it);
+        else
+            ++it;
+    }
+}
+
+bool LibrarySearchIndex::containsBook(const QUuid& uuid,
+                                      const QString& fileHash) const
+{
+    auto bookNumber = m_bookNumbers.value(uuid, -1);
+    if(bookNumber == -1)
+        return false;
+
+    return m_books.value(bookNumber).fileHash == fileHash;
+}
+
+int LibrarySearchIndex::getBookCount() const
+{
+    return m_books.size();
+}
+
+void LibrarySearchIndex::clear()
+{
+    m_books.clear();
+    m_bookNumbers.clear();
+    m_terms.clear();
+    m_nextBookNumber = 0;
+}
+
+QList<LibrarySearchIndex::BookMatch> LibrarySearchIndex::search(
+    const QString& text, int maxResults) const
+{
+    auto terms = SearchIndex::splitIntoTerms(text);
+    if(terms.isEmpty())
+        return {};
+
+    // A book needs to contain every term to match
+    auto scores = scoreTerm(terms.first());
+    for(int i = 1; i < terms.size() && !scores.isEmpty(); ++i)
+    {
+        auto termScores = scoreTerm(terms.at(i));
+        for(auto it = scores.begin(); it != scores.end();)
+        {
+            if(!termScores.contains(it.key()))
+            {
+                it = scores.erase(it);
+                continue;
+            }
+
+            it.value() += termScores.value(it.key());
+            ++it;
+        }
+    }
+
+    QList<BookMatch> result;
+    result.reserve(scores.size());
+    for(auto it = scores.cbegin(); it != scores.cend(); ++it)
+        result.append(BookMatch { m_books.value(it.key()).uuid, it.value() });
+
+    std::ranges::sort(result,
+                      [](const BookMatch& a, const BookMatch& b)
+                      {
+                          return a.score > b.score;
+                      });
+
+    if(result.size() > maxResults)
+        result.resize(maxResults);
+
+    return result;
+}
+
+QHash<int, double> LibrarySearchIndex::scoreTerm(const QString& term) const
+{
+    // Sum up the occurrences of all words starting with the term per book
+    QHash<int, int> counts;
+    for(auto it = m_terms.lowerBound(term);
+        it != m_terms.cend() && it.key().startsWith(term); ++it)
+    {
+        for(auto& posting : it.value())
+            counts[posting.bookNumber] += posting.count;
+    }
+
+    // Terms which occur in few books tell more about a book than terms which
+    // occur in most of them, so they are weighted higher.
+    auto inverseFrequency =
+        std::log(1.0 + static_cast<double>(m_books.size()) / counts.size());
+
+    QHash<int, double> scores;
+    for(auto it = counts.cbegin(); it != counts.cend(); ++it)
+    {
+        auto termFrequency = 1.0 + std::log(it.value());
+        scores.insert(it.key(), termFrequency * inverseFrequency);
+    }
+
+    return scores;
+}
+
+QDataStream& operator<<(QDataStream& stream, const LibrarySearchIndex& index)
+{
+    return stream << index.m_nextBookNumber << index.m_books << index.m_terms;
+}
+
+QDataStream& operator>>(QDataStream& stream, LibrarySearchIndex& index)
+{
+    index.clear();
+    stream >> index.m_nextBookNumber >> index.m_books >> index.m_terms;
+
+    for(auto it = index.m_books.cbegin(); it != index.m_books.cend(); ++it)
+        index.m_bookNumbers.insert(it.value().uuid, it.key());
+
+    return stream;
+}
+
+QDataStream& operator<<(QDataStream& stream,
+                        const LibrarySearchIndex::BookEntry& book)
+{
+    return stream << book.uuid << book.fileHash;
+}
+
+QDataStream& operator>>(QDataStream& stream,
+                        LibrarySearchIndex::BookEntry& book)
+{
+    return stream >> book.uuid >> book.fileHash;
+}
+
+QDataStream& operator<<(QDataStream& stream,
+                        const LibrarySearchIndex::Posting& posting)
+{
+    return stream << posting.bookNumber << posting.count;
+}
+
+QDataStream& operator>>(QDataStream& stream,
+                        LibrarySearchIndex::Posting& posting)
+{
+    return stream >> posting.bookNumber >> posting.count;
+}
+
+}  // namespace application::core::utils
@@ -0,0 +1,83 @@
+#pragma once
+#include <QDataStream>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QUuid>
+#include "application_export.hpp"
+#include "search_index.hpp"
+
+namespace application::core::utils
+{
+
+/**
+ * The LibrarySearchIndex is an inverted index over all books of the library.
+ * It maps every term to the books it occurs in and how often it does, which
+ * is enough to find and rank the books that match a search without opening
+ * any of them.
+ *
+ * Where in a book the terms are is left to the book's own TermPageIndex,
+ * which only needs to be read for the few books that are shown as results.
+ */
+class APPLICATION_EXPORT LibrarySearchIndex
+{
+public:
+    struct BookMatch
+    {
+        QUuid uuid;
+        double score;
+    };
+
+    /**
+     * Adds the terms of a book, replacing the ones it was added with before.
+     * The file hash is kept to tell whether the book changed since.
+     */
+    void addBook(const QUuid& uuid, const QString& fileHash,
+                 const SearchIndex& index);
+    void removeBook(const QUuid& uuid);
+    bool containsBook(const QUuid& uuid, const QString& fileHash) const;
+    int getBookCount() const;
+    void clear();
+
+    /**
+     * Returns the books containing every term of the text, either as a word
+     * or as the start of one, ranked by how relevant they are (tf-idf).
+     */
+    QList<BookMatch> search(const QString& text, int maxResults) const;
+
+    friend QDataStream& operator<<(QDataStream& stream,
+                                   const LibrarySearchIndex& index);
+    friend QDataStream& operator>>(QDataStream& stream,
+                                   LibrarySearchIndex& index);
+
+private:
+    struct BookEntry
+    {
+        QUuid uuid;
+        QString fileHash;
+    };
+
+    struct Posting
+    {
+        int bookNumber;
+        int count;
+    };
+
+    QHash<int, double> scoreTerm(const QString& term) const;
+
+    friend QDataStream& operator<<(QDataStream& stream, const BookEntry& book);
+    friend QDataStream& operator>>(QDataStream& stream, BookEntry& book);
+    friend QDataStream& operator<<(QDataStream& stream,
+                                   const Posting& posting);
+    friend QDataStream& operator>>(QDataStream& stream, Posting& posting);
+
+    // Books are referred to by a number in the postings, since storing their
+    // uuid for every term would make the index a lot bigger.
+    QHash<int, BookEntry> m_books;
+    QHash<QUuid, int> m_bookNumbers;
+    QMap<QString, QList<Posting>> m_terms;
+    int m_nextBookNumber = 0;
+};
+
+}  // namespace application::core::utils
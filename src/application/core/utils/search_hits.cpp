@@ -0,0 +1,185 @@
+#include "search_hits.hpp"
+#include <algorithm>
+#include "fz_utils.hpp"
+
+namespace application::core::utils
+{
+
+bool SearchHits::Position::isValid() const
+{
+    return pageNumber != -1;
+}
+
+void SearchHits::addPageHits(int pageNumber, std::vector<mupdf::FzQuad> quads)
+{
+    if(quads.empty())
+        return;
+
+    m_hitCount += static_cast<int>(quads.size());
+
+    // Pages mostly arrive in order, so this is usually an append
+    auto it = std::ranges::lower_bound(m_pages, pageNumber, {},
+                                       &PageHits::pageNumber);
+    if(it != m_pages.end() && it->pageNumber == pageNumber)
+    {
+        it->quads.insert(it->quads.end(), quads.begin(), quads.end());
+        return;
+    }
+
+    m_pages.insert(it, PageHits { pageNumber, std::move(quads) });
+}
+
+void SearchHits::clear()
+{
+    m_pages.clear();
+    m_hitCount = 0;
+}
+
+bool SearchHits::isEmpty() const
+{
+    return m_pages.empty();
+}
+
+int SearchHits::getHitCount() const
+{
+    return m_hitCount;
+}
+
+const std::vector<mupdf::FzQuad>& SearchHits::getPageHits(int pageNumber) const
+{
+    static const std::vector<mupdf::FzQuad> noHits;
+
+    auto it = findPage(pageNumber);
+    if(it == m_pages.end())
+        return noHits;
+
+    return it->quads;
+}
+
+SearchHit SearchHits::getHit(Position position) const
+{
+    auto it = findPage(position.pageNumber);
+    if(it == m_pages.end() || position.index < 0 ||
+       position.index >= std::ssize(it->quads))
+    {
+        return SearchHit { -1, mupdf::FzQuad() };
+    }
+
+    return SearchHit { position.pageNumber, it->quads.at(position.index) };
+}
+
+QList<QRectF> SearchHits::getPageHitRects(int pageNumber, QPoint pageOffset,
+                                          float zoom) const
+{
+    QList<QRectF> rects;
+    for(auto& quad : getPageHits(pageNumber))
+    {
+        // The hits are in the page's coordinates at a zoom of 1
+        auto movedQuad = moveQuad(*quad.internal(), pageOffset.x(),
+                                  pageOffset.y());
+        auto rect = fzQuadToQRectF(mupdf::FzQuad(movedQuad));
+        scaleQRectFToZoom(rect, zoom);
+
+        rects.append(rect);
+    }
+
+    return rects;
+}
+
+SearchHits::Position SearchHits::findFirstFrom(int pageNumber) const
+{
+    if(m_pages.empty())
+        return {};
+
+    auto it = std::ranges::lower_bound(m_pages, pageNumber, {},
+                                       &PageHits::pageNumber);
+    if(it == m_pages.end())
+        it = m_pages.begin();
+
+    return Position { it->pageNumber, 0 };
+}
+
+SearchHits::Position SearchHits::findLastUpTo(int pageNumber) const
+{
+    if(m_pages.empty())
+        return {};
+
+    auto it = std::ranges::upper_bound(m_pages, pageNumber, {},
+                                       &PageHits::pageNumber);
+    if(it == m_pages.begin())
+        it = m_pages.end();
+    --it;
+
+    return Position { it->pageNumber, static_cast<int>(it->quads.size()) - 1 };
+}
+
+SearchHits::Position SearchHits::findNext(Position position) const
+{
+    auto it = findPage(position.pageNumber);
+    if(it == m_pages.end())
+        return findFirstFrom(position.pageNumber);
+
+    if(position.index + 1 < std::ssize(it->quads))
+        return Position { position.pageNumber, position.index + 1 };
+
+    // Wrap to the first page once you are over the end
+    ++it;
+    if(it == m_pages.end())
+        it = m_pages.begin();
+
+    return Position { it->pageNumber, 0 };
+}
+
+SearchHits::Position SearchHits::findPrevious(Position position) const
+{
+    auto it = findPage(position.pageNumber);
+    if(it == m_pages.end())
+        return findLastUpTo(position.pageNumber);
+
+    if(position.index > 0)
+        return Position { position.pageNumber, position.index - 1 };
+
+    // Wrap to the last page once you are over the beginning
+    if(it == m_pages.begin())
+        it = m_pages.end();
+    --it;
+
+    return Position { it->pageNumber, static_cast<int>(it->quads.size()) - 1 };
+}
+
+QList<qreal> SearchHits::getDensity(int pageCount, int bucketCount) const
+{
+    if(pageCount <= 0 || bucketCount <= 0)
+        return {};
+
+    QList<qreal> buckets(bucketCount, 0);
+    for(auto& page : m_pages)
+    {
+        auto bucket = static_cast<qint64>(page.pageNumber) * bucketCount /
+                      pageCount;
+        bucket = std::clamp<qint64>(bucket, 0, bucketCount - 1);
+        buckets[bucket] += page.quads.size();
+    }
+
+    auto maxHits = *std::ranges::max_element(buckets);
+    if(maxHits > 0)
+    {
+        for(auto& bucket : buckets)
+            bucket /= maxHits;
+    }
+
+    return buckets;
+}
+
+std::vector<SearchHits::PageHits>::const_iterator SearchHits::findPage(
+    int pageNumber) const
+{
+    auto it = std::ranges::lower_bound(m_pages, pageNumber, {},
+                                       &PageHits::pageNumber);
+    if(it == m_pages.end() || it->pageNumber != pageNumber)
+        return m_pages.end();
+
+    return it;
+}
+
+}  // namespace application::core::utils
@@ -0,0 +1,88 @@
+#pragma once
+#include <mupdf/classes2.h>
+#include <QList>
+#include <QPoint>
+#include <QRectF>
+#include <vector>
+#include "application_export.hpp"
+
+namespace application::core::utils
+{
+
+struct SearchHit
+{
+    int pageNumber;
+    mupdf::FzQuad rect;
+};
+
+/**
+ * The SearchHits are the hits of a search, bucketed by the page they are on.
+ *
+ * The pages with hits are kept sorted, so that finding the hits of a page or
+ * the first hit after a page is a binary search, no matter in which order
+ * the pages were searched. A hit is referred to by its Position, i.e. its
+ * page and its index among the page's hits, which stays valid while more
+ * pages are added.
+ */
+class APPLICATION_EXPORT SearchHits
+{
+public:
+    struct Position
+    {
+        int pageNumber = -1;
+        int index = 0;
+
+        bool isValid() const;
+        bool operator==(const Position& other) const = default;
+    };
+
+    void addPageHits(int pageNumber, std::vector<mupdf::FzQuad> quads);
+    void clear();
+    bool isEmpty() const;
+    int getHitCount() const;
+
+    const std::vector<mupdf::FzQuad>& getPageHits(int pageNumber) const;
+    SearchHit getHit(Position position) const;
+
+    /**
+     * The page's hits in the coordinates it is shown in, i.e. relative to the
+     * top left corner of its crop box (see the page offsets) and at the zoom.
+     */
+    QList<QRectF> getPageHitRects(int pageNumber, QPoint pageOffset,
+                                  float zoom) const;
+
+    /**
+     * The first hit on the page or on one of the following ones, wrapping
+     * around to the first page with hits. Invalid if there are no hits.
+     */
+    Position findFirstFrom(int pageNumber) const;
+
+    /**
+     * The last hit on the page or on one of the previous ones, wrapping
+     * around to the last page with hits. Invalid if there are no hits.
+     */
+    Position findLastUpTo(int pageNumber) const;
+    Position findNext(Position position) const;
+    Position findPrevious(Position position) const;
+
+    /**
+     * Splits the pages into equally sized buckets and returns how many hits
+     * each of them has, relative to the bucket with the most hits (0 to 1).
+     */
+    QList<qreal> getDensity(int pageCount, int bucketCount) const;
+
+private:
+    struct PageHits
+    {
+        int pageNumber;
+        std::vector<mupdf::FzQuad> quads;
+    };
+
+    std::vector<PageHits>::const_iterator findPage(int pageNumber) const;
+
+    // Sorted by page number, pages without hits are not stored
+    std::vector<PageHits> m_pages;
+    int m_hitCount = 0;
+};
+
+}  // namespace application::core::utils
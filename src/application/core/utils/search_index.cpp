@@ -0,0 +1,236 @@
+#include "search_index.hpp"
+#include <algorithm>
+
+namespace application::core::utils
+{
+
+void SearchIndex::addWord(int pageNumber, const QString& word,
+                          const QRectF& rect)
+{
+    auto term = normalize(word);
+    if(term.isEmpty())
+        return;
+
+    m_terms[term].append(Occurrence { pageNumber, rect });
+}
+
+void SearchIndex::setPageText(int pageNumber, const QString& text)
+{
+    if(m_pageTexts.size() <= pageNumber)
+        m_pageTexts.resize(pageNumber + 1);
+
+    m_pageTexts[pageNumber] = text.simplified();
+}
+
+QString SearchIndex::getPageText(int pageNumber) const
+{
+    return m_pageTexts.value(pageNumber);
+}
+
+QString SearchIndex::getSnippet(int pageNumber, const QString& text,
+                                int contextLength) const
+{
+    return createSnippet(m_pageTexts.value(pageNumber), text, contextLength);
+}
+
+QString SearchIndex::createSnippet(const QString& pageText,
+                                   const QString& text, int contextLength)
+{
+    auto position = pageText.indexOf(text, 0, Qt::CaseInsensitive);
+    auto length = text.size();
+
+    // The words of the text don't need to be next to each other on the page
+    auto terms = splitIntoTerms(text);
+    for(int i = 0; position == -1 && i < terms.size(); ++i)
+    {
+        position = pageText.indexOf(terms.at(i), 0, Qt::CaseInsensitive);
+        length = terms.at(i).size();
+    }
+
+    if(position == -1)
+    {
+        position = 0;
+        length = 0;
+    }
+
+    auto start = std::max<qsizetype>(position - contextLength, 0);
+    auto end = std::min<qsizetype>(position + length + contextLength,
+                                   pageText.size());
+
+    // Don't cut off words at the edges of the snippet, unless the text has no
+    // spaces to break at (e.g. in some scripts)
+    const int maxWordLength = 20;
+    for(int i = 0; i < maxWordLength && start > 0 &&
+                   !pageText.at(start - 1).isSpace();
+        ++i)
+    {
+        --start;
+    }
+    for(int i = 0; i < maxWordLength && end < pageText.size() &&
+                   !pageText.at(end).isSpace();
+        ++i)
+    {
+        ++end;
+    }
+
+    auto snippet = pageText.mid(start, end - start);
+    if(start > 0)
+        snippet.prepend("...");
+    if(end < pageText.size())
+        snippet.append("...");
+
+    return snippet;
+}
+
+void SearchIndex::setPageCount(int pageCount)
+{
+    m_pageCount = pageCount;
+}
+
+int SearchIndex::getPageCount() const
+{
+    return m_pageCount;
+}
+
+int SearchIndex::getTermCount() const
+{
+    return m_terms.size();
+}
+
+QStringList SearchIndex::getTerms() const
+{
+    return m_terms.keys();
+}
+
+bool SearchIndex::isEmpty() const
+{
+    return m_pageCount == 0;
+}
+
+QMap<QString, int> SearchIndex::getTermFrequencies() const
+{
+    QMap<QString, int> frequencies;
+    for(auto it = m_terms.cbegin(); it != m_terms.cend(); ++it)
+        frequencies.insert(it.key(), it.value().size());
+
+    return frequencies;
+}
+
+QList<SearchIndex::Occurrence> SearchIndex::findWord(const QString& word) const
+{
+    return m_terms.value(normalize(word));
+}
+
+QList<SearchIndex::Occurrence> SearchIndex::findPrefix(
+    const QString& prefix) const
+{
+    auto term = normalize(prefix);
+    if(term.isEmpty())
+        return {};
+
+    // The terms starting with the prefix are next to each other
+    QList<Occurrence> result;
+    for(auto it = m_terms.lowerBound(term);
+        it != m_terms.cend() && it.key().startsWith(term); ++it)
+    {
+        result.append(it.value());
+    }
+
+    sortByPosition(result);
+    return result;
+}
+
+QSet<int> SearchIndex::findCandidatePages(const QString& text) const
+{
+    auto terms = splitIntoTerms(text);
+    if(terms.isEmpty())
+        return {};
+
+    auto pages = findPagesContainingTerm(terms.first());
+    for(int i = 1; i < terms.size() && !pages.isEmpty(); ++i)
+        pages.intersect(findPagesContainingTerm(terms.at(i)));
+
+    return pages;
+}
+
+QString SearchIndex::normalize(const QString& word)
+{
+    return word.toCaseFolded();
+}
+
+QStringList SearchIndex::splitIntoTerms(const QString& text)
+{
+    QStringList terms;
+    QString term;
+    for(auto character : text)
+    {
+        if(character.isLetterOrNumber())
+        {
+            term.append(character);
+        }
+        else if(!term.isEmpty())
+        {
+            terms.append(normalize(term));
+            term.clear();
+        }
+    }
+
+    if(!term.isEmpty())
+        terms.append(normalize(term));
+
+    return terms;
+}
+
+QSet<int> SearchIndex::findPagesContainingTerm(const QString& term) const
+{
+    // Terms of the text that are not whole words (e.g. the start of a longer
+    // word) can be anywhere in a word, so all terms need to be checked.
+    QSet<int> pages;
+    for(auto it = m_terms.cbegin(); it != m_terms.cend(); ++it)
+    {
+        if(!it.key().contains(term))
+            continue;
+
+        for(auto& occurrence : it.value())
+            pages.insert(occurrence.pageNumber);
+    }
+
+    return pages;
+}
+
+void SearchIndex::sortByPosition(QList<Occurrence>& occurrences)
+{
+    std::ranges::stable_sort(occurrences,
+                             [](const Occurrence& a, const Occurrence& b)
+                             {
+                                 if(a.pageNumber != b.pageNumber)
+                                     return a.pageNumber < b.pageNumber;
+                                 if(a.rect.top() != b.rect.top())
+                                     return a.rect.top() < b.rect.top();
+                                 return a.rect.left() < b.rect.left();
+                             });
+}
+
+QDataStream& operator<<(QDataStream& stream, const SearchIndex& index)
+{
+    return stream << index.m_pageCount << index.m_terms << index.m_pageTexts;
+}
+
+QDataStream& operator>>(QDataStream& stream, SearchIndex& index)
+{
+    return stream >> index.m_pageCount >> index.m_terms >> index.m_pageTexts;
+}
+
+QDataStream& operator<<(QDataStream& stream,
+                        const SearchIndex::Occurrence& occurrence)
+{
+    return stream << occurrence.pageNumber << occurrence.rect;
+}
+
+QDataStream& operator>>(QDataStream& stream,
+                        SearchIndex::Occurrence& occurrence)
+{
+    return stream >> occurrence.pageNumber >> occurrence.rect;
+}
+
+}  // namespace application::core::utils
@@ -0,0 +1,91 @@
+#pragma once
+#include <QDataStream>
+#include <QList>
+#include <QMap>
+#include <QRectF>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include "application_export.hpp"
+
+namespace application::core::utils
+{
+
+/**
+ * The SearchIndex is an inverted index of a book's text. It maps every term
+ * (a word, normalized to be case insensitive) to the positions at which it
+ * occurs, so that searching a book doesn't require extracting the text of
+ * every page again.
+ *
+ * Terms are kept sorted, which allows looking up all terms starting with a
+ * prefix, as well as narrowing a search down to the pages that can contain a
+ * match at all, by scanning the terms instead of the pages.
+ *
+ * The plain text of every page is kept as well, to show the context of a
+ * match (e.g. in the results of searching the whole library).
+ */
+class APPLICATION_EXPORT SearchIndex
+{
+public:
+    struct Occurrence
+    {
+        int pageNumber;
+        QRectF rect;
+
+        bool operator==(const Occurrence& other) const = default;
+    };
+
+    void addWord(int pageNumber, const QString& word, const QRectF& rect);
+    void setPageText(int pageNumber, const QString& text);
+    QString getPageText(int pageNumber) const;
+    QString getSnippet(int pageNumber, const QString& text,
+                       int contextLength = 60) const;
+    void setPageCount(int pageCount);
+    int getPageCount() const;
+    int getTermCount() const;
+    QStringList getTerms() const;
+    bool isEmpty() const;
+
+    /**
+     * Returns how often every term occurs in the book.
+     */
+    QMap<QString, int> getTermFrequencies() const;
+
+    QList<Occurrence> findWord(const QString& word) const;
+    QList<Occurrence> findPrefix(const QString& prefix) const;
+
+    /**
+     * Returns the pages on which the text can occur, which are the pages that
+     * contain every term of the text as a part of one of their words.
+     */
+    QSet<int> findCandidatePages(const QString& text) const;
+
+    static QString normalize(const QString& word);
+    static QStringList splitIntoTerms(const QString& text);
+
+    /**
+     * Returns the part of the page's text around the first match of the text,
+     * or of one of its terms.
+     */
+    static QString createSnippet(const QString& pageText, const QString& text,
+                                 int contextLength = 60);
+
+    friend QDataStream& operator<<(QDataStream& stream,
+                                   const SearchIndex& index);
+    friend QDataStream& operator>>(QDataStream& stream, SearchIndex& index);
+
+private:
+    QSet<int> findPagesContainingTerm(const QString& term) const;
+    static void sortByPosition(QList<Occurrence>& occurrences);
+
+    QMap<QString, QList<Occurrence>> m_terms;
+    QStringList m_pageTexts;
+    int m_pageCount = 0;
+};
+
+QDataStream& operator<<(QDataStream& stream,
+                        const SearchIndex::Occurrence& occurrence);
+QDataStream& operator>>(QDataStream& stream,
+                        SearchIndex::Occurrence& occurrence);
+
+}  // namespace application::core::utils
@@ -0,0 +1,416 @@
+#include "search_indexer.hpp"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <algorithm>
+#include "layout/layout_cache.hpp"
+
+namespace application::core::utils
+{
+
+SearchIndexer::SearchIndexer(QObject* parent) :
+    QObject(parent)
+{
+    // Indexing two books at the same time is never useful
+    m_threadPool.setMaxThreadCount(1);
+}
+
+SearchIndexer::~SearchIndexer()
+{
+    cancel();
+    m_threadPool.waitForDone();
+}
+
+void SearchIndexer::load(const QString& filePath, const QString& cacheKey)
+{
+    auto generation = ++m_generation;
+
+    m_threadPool.start(
+        [this, filePath, cacheKey, generation]()
+        {
+            // Indexing must not slow down rendering or searching
+            QThread::currentThread()->setPriority(QThread::LowestPriority);
+
+            auto index = loadOrBuildIndex(filePath, cacheKey,
+                                          [this, generation]()
+                                          {
+                                              return generation !=
+                                                     m_generation;
+                                          });
+            if(index == nullptr)
+                return;
+
+            // Deliver the result on the thread the indexer lives in. It is
+            // dropped if a different book was loaded in the meantime.
+            QMetaObject::invokeMethod(
+                this,
+                [this, index, generation]()
+                {
+                    if(generation == m_generation)
+                        emit searchIndexLoaded(index);
+                },
+                Qt::QueuedConnection);
+        });
+}
+
+void SearchIndexer::cancel()
+{
+    ++m_generation;
+}
+
+std::shared_ptr<SearchIndex> SearchIndexer::loadOrBuildIndex(
+    const QString& filePath, const QString& cacheKey,
+    const std::function<bool()>& isCancelled)
+{
+    auto cacheFilePath = getCacheFilePath(cacheKey);
+    auto index = std::make_shared<SearchIndex>();
+    if(loadFromCache(filePath, cacheFilePath, *index))
+        return index;
+
+    // The stored index is outdated, it must not be left behind in case
+    // building the new one is cancelled.
+    removeFromCache(cacheKey);
+    *index = SearchIndex();
+    if(!buildIndex(filePath, cacheKey, isCancelled, *index))
+        return nullptr;
+
+    saveToCache(*index, filePath, cacheKey);
+    return index;
+}
+
+std::shared_ptr<SearchIndex> SearchIndexer::loadStoredIndex(
+    const QString& filePath, const QString& cacheKey)
+{
+    auto index = std::make_shared<SearchIndex>();
+    if(!loadFromCache(filePath, getCacheFilePath(cacheKey), *index))
+        return nullptr;
+
+    return index;
+}
+
+std::optional<SearchIndexer::BestMatch> SearchIndexer::findBestMatch(
+    const QString& filePath, const QString& cacheKey, const QString& text)
+{
+    auto termPageFilePath = getCacheFilePath(cacheKey, "pages");
+    QFile termPageFile(termPageFilePath);
+    TermPageIndex termPageIndex;
+    if(!openTermPageIndex(termPageFile, filePath, termPageIndex))
+    {
+        // Indexes that were stored before there were TermPageIndexes get one
+        // the first time they are searched.
+        auto index = loadStoredIndex(filePath, cacheKey);
+        if(index == nullptr)
+            return std::nullopt;
+
+        saveTermPageIndex(*index, filePath, termPageFilePath);
+        if(!openTermPageIndex(termPageFile, filePath, termPageIndex))
+            return std::nullopt;
+    }
+
+    // The page on which the terms of the text occur most often
+    QHash<int, int> occurrencesPerPage;
+    for(auto& term : SearchIndex::splitIntoTerms(text))
+    {
+        auto pageCounts = termPageIndex.findPrefix(term);
+        for(auto it = pageCounts.cbegin(); it != pageCounts.cend(); ++it)
+            occurrencesPerPage[it.key()] += it.value();
+    }
+
+    int bestPage = 0;
+    int bestCount = 0;
+    for(auto it = occurrencesPerPage.cbegin(); it != occurrencesPerPage.cend();
+        ++it)
+    {
+        if(it.value() > bestCount ||
+           (it.value() == bestCount && it.key() < bestPage))
+        {
+            bestPage = it.key();
+            bestCount = it.value();
+        }
+    }
+
+    auto pageText = termPageIndex.getPageText(bestPage);
+    return BestMatch {
+        .pageNumber = bestPage,
+        .snippet = SearchIndex::createSnippet(pageText, text),
+    };
+}
+
+void SearchIndexer::addPageToIndex(mupdf::FzStextPage& textPage,
+                                   int pageNumber, SearchIndex& index)
+{
+    QString pageText;
+    for(auto block = textPage.m_internal->first_block; block != nullptr;
+        block = block->next)
+    {
+        if(block->type != FZ_STEXT_BLOCK_TEXT)
+            continue;
+
+        for(auto line = block->u.t.first_line; line != nullptr;
+            line = line->next)
+        {
+            if(!pageText.isEmpty())
+                pageText.append(' ');
+
+            // Words are runs of letters and numbers, the same way the text of
+            // a search is split into terms. They end at the end of a line.
+            QString word;
+            fz_rect wordRect = fz_empty_rect;
+            for(auto character = line->first_char;; character = character->next)
+            {
+                auto codePoint = character != nullptr
+                                     ? static_cast<char32_t>(character->c)
+                                     : U' ';
+                if(character != nullptr)
+                    pageText.append(QString::fromUcs4(&codePoint, 1));
+
+                if(QChar::isLetterOrNumber(codePoint))
+                {
+                    word.append(QString::fromUcs4(&codePoint, 1));
+                    auto characterRect = mupdf::ll_fz_rect_from_quad(
+                        character->quad);
+                    wordRect =
+                        mupdf::ll_fz_union_rect(wordRect, characterRect);
+                }
+                else if(!word.isEmpty())
+                {
+                    index.addWord(pageNumber, word,
+                                  QRectF(wordRect.x0, wordRect.y0,
+                                         wordRect.x1 - wordRect.x0,
+                                         wordRect.y1 - wordRect.y0));
+                    word.clear();
+                    wordRect = fz_empty_rect;
+                }
+
+                if(character == nullptr)
+                    break;
+            }
+        }
+    }
+
+    index.setPageText(pageNumber, pageText);
+}
+
+bool SearchIndexer::loadFromCache(const QString& filePath,
+                                  const QString& cacheFilePath,
+                                  SearchIndex& index)
+{
+    QFile cacheFile(cacheFilePath);
+    if(!cacheFile.open(QFile::ReadOnly))
+        return false;
+
+    QDataStream stream(&cacheFile);
+    stream.setVersion(QDataStream::Qt_6_0);
+    if(!readHeader(stream, filePath))
+        return false;
+
+    stream >> index;
+    if(stream.status() != QDataStream::Ok || index.isEmpty())
+        return false;
+
+    // Mark the index as recently used, so that it is evicted last
+    cacheFile.close();
+    if(cacheFile.open(QFile::ReadWrite))
+    {
+        cacheFile.setFileTime(QDateTime::currentDateTime(),
+                              QFileDevice::FileModificationTime);
+    }
+
+    return true;
+}
+
+void SearchIndexer::saveToCache(const SearchIndex& index,
+                                const QString& filePath,
+                                const QString& cacheKey)
+{
+    // Written to a temporary file first, so that no partial index is read
+    auto cacheFilePath = getCacheFilePath(cacheKey);
+    QSaveFile cacheFile(cacheFilePath);
+    if(!cacheFile.open(QFile::WriteOnly))
+    {
+        qWarning() << QString("Saving search index failed. "
+                              "Failed opening file at: %1")
+                          .arg(cacheFilePath);
+        return;
+    }
+
+    QDataStream stream(&cacheFile);
+    stream.setVersion(QDataStream::Qt_6_0);
+    writeHeader(stream, filePath);
+    stream << index;
+
+    if(!cacheFile.commit())
+    {
+        qWarning() << QString("Saving search index failed. "
+                              "Failed writing file at: %1")
+                          .arg(cacheFilePath);
+        return;
+    }
+
+    saveTermPageIndex(index, filePath, getCacheFilePath(cacheKey, "pages"));
+    evictIndexes(cacheFilePath);
+}
+
+void SearchIndexer::saveTermPageIndex(const SearchIndex& index,
+                                      const QString& filePath,
+                                      const QString& termPageFilePath)
+{
+    QSaveFile termPageFile(termPageFilePath);
+    if(!termPageFile.open(QFile::WriteOnly))
+    {
+        qWarning() << QString("Saving term page index failed. "
+                              "Failed opening file at: %1")
+                          .arg(termPageFilePath);
+        return;
+    }
+
+    QDataStream stream(&termPageFile);
+    stream.setVersion(QDataStream::Qt_6_0);
+    writeHeader(stream, filePath);
+    TermPageIndex::write(index, stream);
+
+    if(!termPageFile.commit())
+    {
+        qWarning() << QString("Saving term page index failed. "
+                              "Failed writing file at: %1")
+                          .arg(termPageFilePath);
+    }
+}
+
+void SearchIndexer::writeHeader(QDataStream& stream, const QString& filePath)
+{
+    QFileInfo fileInfo(filePath);
+    stream << formatVersion << fileInfo.size()
+           << fileInfo.lastModified().toMSecsSinceEpoch();
+}
+
+bool SearchIndexer::readHeader(QDataStream& stream, const QString& filePath)
+{
+    int version = 0;
+    qint64 fileSize = 0;
+    qint64 lastModified = 0;
+    stream >> version >> fileSize >> lastModified;
+
+    // The stored file is outdated if the book's file changed since
+    QFileInfo fileInfo(filePath);
+    return version == formatVersion && fileSize == fileInfo.size() &&
+           lastModified == fileInfo.lastModified().toMSecsSinceEpoch();
+}
+
+bool SearchIndexer::openTermPageIndex(QFile& file, const QString& filePath,
+                                      TermPageIndex& termPageIndex)
+{
+    file.close();
+    if(!file.open(QFile::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    return readHeader(stream, filePath) && termPageIndex.open(&file);
+}
+
+bool SearchIndexer::buildIndex(const QString& filePath,
+                               const QString& cacheKey,
+                               const std::function<bool()>& isCancelled,
+                               SearchIndex& index)
+{
+    try
+    {
+        auto document = LayoutCache::openDocument(filePath, cacheKey);
+
+        // Same options as when searching, so that the text is the same
+        mupdf::FzStextOptions options;
+        auto pageCount = document.fz_count_pages();
+        for(int i = 0; i < pageCount; ++i)
+        {
+            if(isCancelled())
+                return false;
+
+            mupdf::FzStextPage textPage(document, i, options);
+            addPageToIndex(textPage, i, index);
+        }
+
+        index.setPageCount(pageCount);
+    }
+    catch(...)
+    {
+        qWarning() << QString("Failed building search index of book at: %1")
+                          .arg(filePath);
+        return false;
+    }
+
+    return !index.isEmpty();
+}
+
+void SearchIndexer::removeFromCache(const QString& cacheKey)
+{
+    QFile::remove(getCacheFilePath(cacheKey));
+    QFile::remove(getCacheFilePath(cacheKey, "pages"));
+}
+
+void SearchIndexer::evictIndexes(const QString& keptCacheFilePath)
+{
+    QDir dir(QFileInfo(keptCacheFilePath).path());
+    auto files = dir.entryInfoList({ "*.idx", "*.pages" }, QDir::Files);
+
+    qint64 totalSize = 0;
+    for(auto& fileInfo : files)
+        totalSize += fileInfo.size();
+
+    if(totalSize <= capacity)
+        return;
+
+    // An index and its TermPageIndex are removed together, the index tells
+    // when both of them were last used.
+    std::erase_if(files,
+                  [](const QFileInfo& fileInfo)
+                  {
+                      return fileInfo.suffix() != "idx";
+                  });
+    std::ranges::sort(files, {},
+                      [](const QFileInfo& fileInfo)
+                      {
+                          return fileInfo.lastModified();
+                      });
+
+    // Evict a bit more than needed, so that the next indexes don't have to
+    // walk the files again right away.
+    auto targetSize = capacity / 10 * 9;
+    for(auto& fileInfo : files)
+    {
+        if(totalSize <= targetSize)
+            break;
+
+        if(fileInfo.filePath() == keptCacheFilePath)
+            continue;
+
+        QFileInfo termPageFileInfo(
+            dir.filePath(fileInfo.completeBaseName() + ".pages"));
+        auto termPageFileSize = termPageFileInfo.size();
+        if(QFile::remove(fileInfo.filePath()))
+            totalSize -= fileInfo.size();
+        if(QFile::remove(termPageFileInfo.filePath()))
+            totalSize -= termPageFileSize;
+    }
+}
+
+QString SearchIndexer::getCacheFilePath(const QString& cacheKey,
+                                        const QString& extension)
+{
+    QDir dir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+    dir.mkpath("search_index");
+    dir.cd("search_index");
+
+    // The key might contain characters which are not allowed in file names
+    auto hash = QCryptographicHash::hash(cacheKey.toUtf8(),
+                                         QCryptographicHash::Sha1);
+    return dir.filePath(QString::fromLatin1(hash.toHex()) + "." + extension);
+}
+
+}  // namespace application::core::utils
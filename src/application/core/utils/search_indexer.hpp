@@ -0,0 +1,119 @@
+#pragma once
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include "application_export.hpp"
+#include "mupdf/classes.h"
+#include "search_index.hpp"
+#include "term_page_index.hpp"
+
+namespace application::core::utils
+{
+
+/**
+ * The SearchIndexer provides the SearchIndex of a book without blocking the
+ * GUI thread.
+ *
+ * Building the index extracts the text of every page, which takes a while, so
+ * it is done once, with low priority on a background thread, and stored in
+ * the app's data directory. It is read from there the next time the book is
+ * opened, unless the book's file changed since, in which case it is rebuilt.
+ *
+ * A TermPageIndex is stored next to the index, from which the best matching
+ * page of a book is found without loading its whole index.
+ *
+ * The size of all stored indexes together is bounded, once it is exceeded
+ * the least recently used ones are removed.
+ */
+class APPLICATION_EXPORT SearchIndexer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SearchIndexer(QObject* parent = nullptr);
+    ~SearchIndexer();
+
+    /**
+     * The cache key identifies the book's index file, e.g. the file's hash.
+     * Indexing a new book cancels indexing the previous one.
+     */
+    void load(const QString& filePath, const QString& cacheKey);
+    void cancel();
+
+    /**
+     * Loads the stored index of a book or, if there is none that is up to
+     * date, builds and stores it. Blocks until done, or until it is cancelled
+     * by the given function returning true, in which case nothing is returned.
+     */
+    static std::shared_ptr<SearchIndex> loadOrBuildIndex(
+        const QString& filePath, const QString& cacheKey,
+        const std::function<bool()>& isCancelled);
+
+    /**
+     * Only loads the stored index of a book, returns nothing if there is none
+     * that is up to date.
+     */
+    static std::shared_ptr<SearchIndex> loadStoredIndex(
+        const QString& filePath, const QString& cacheKey);
+
+    struct BestMatch
+    {
+        int pageNumber;
+        QString snippet;
+    };
+
+    /**
+     * Finds the page on which the terms of the text occur most often, using
+     * the stored TermPageIndex of a book. Returns nothing if the book has no
+     * stored index that is up to date.
+     */
+    static std::optional<BestMatch> findBestMatch(const QString& filePath,
+                                                  const QString& cacheKey,
+                                                  const QString& text);
+
+    static void addPageToIndex(mupdf::FzStextPage& textPage, int pageNumber,
+                               SearchIndex& index);
+
+    /**
+     * Removes the stored index of a book, e.g. once the book's file was
+     * removed.
+     */
+    static void removeFromCache(const QString& cacheKey);
+
+signals:
+    void searchIndexLoaded(
+        std::shared_ptr<const application::core::utils::SearchIndex> index);
+
+private:
+    static bool loadFromCache(const QString& filePath,
+                              const QString& cacheFilePath, SearchIndex& index);
+    static void saveToCache(const SearchIndex& index, const QString& filePath,
+                            const QString& cacheKey);
+    static void saveTermPageIndex(const SearchIndex& index,
+                                  const QString& filePath,
+                                  const QString& termPageFilePath);
+    static void writeHeader(QDataStream& stream, const QString& filePath);
+    static bool readHeader(QDataStream& stream, const QString& filePath);
+    static bool openTermPageIndex(QFile& file, const QString& filePath,
+                                  TermPageIndex& termPageIndex);
+    static bool buildIndex(const QString& filePath, const QString& cacheKey,
+                           const std::function<bool()>& isCancelled,
+                           SearchIndex& index);
+    static void evictIndexes(const QString& keptCacheFilePath);
+    static QString getCacheFilePath(const QString& cacheKey,
+                                    const QString& extension = "idx");
+
+    // Identifies the layout of the index files, increase it when changing it
+    static constexpr int formatVersion = 2;
+    static constexpr qint64 capacity = 512 * 1024 * 1024;
+
+    QThreadPool m_threadPool;
+    std::atomic<int> m_generation = 0;
+};
+
+}  // namespace application::core::utils
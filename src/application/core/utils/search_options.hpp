@@ -11,6 +11,7 @@ struct SearchOptions
 
     bool wholeWords = false;
     bool caseSensitive = false;
+    bool regularExpression = false;
 };
 
 }  // namespace application::core::utils
\ No newline at end of file
@@ -0,0 +1,133 @@
+#pragma once
+#include <QHash>
+#include <QList>
+#include <QPoint>
+#include <QPointF>
+#include <QRectF>
+#include <cmath>
+#include <optional>
+#include <vector>
+
+namespace application::core::utils
+{
+
+/**
+ * A uniform grid over rects, used to find the item at a point (e.g. the glyph
+ * or link below the mouse) without checking every item.
+ *
+ * Every item is stored in all cells that its rect overlaps, so a point query
+ * only needs to look at the few items in the point's cell. The cells are kept
+ * in a hash, so the grid does not need to know the bounds of the page upfront
+ * and empty areas don't take up any memory.
+ *
+ * An item can consist of multiple rects (e.g. a highlight spanning multiple
+ * lines), they are all inserted with the same id.
+ */
+template<typename Id>
+class SpatialGrid
+{
+public:
+    explicit SpatialGrid(qreal cellSize = 32) :
+        m_cellSize(cellSize)
+    {
+    }
+
+    void insert(const Id& id, const QRectF& rect)
+    {
+        if(rect.isEmpty() || !std::isfinite(rect.width()) ||
+           !std::isfinite(rect.height()))
+        {
+            return;
+        }
+
+        auto first = getCell(rect.topLeft());
+        auto last = getCell(rect.bottomRight());
+        auto& cellsOfItem = m_cellsOfItems[id];
+        for(int y = first.y(); y <= last.y(); ++y)
+        {
+            for(int x = first.x(); x <= last.x(); ++x)
+            {
+                QPoint cell(x, y);
+                m_cells[cell].push_back({ id, rect });
+                if(!cellsOfItem.contains(cell))
+                    cellsOfItem.append(cell);
+            }
+        }
+    }
+
+    void remove(const Id& id)
+    {
+        auto cellsOfItem = m_cellsOfItems.constFind(id);
+        if(cellsOfItem == m_cellsOfItems.cend())
+            return;
+
+        for(auto& cell : *cellsOfItem)
+        {
+            auto& entries = m_cells[cell];
+            std::erase_if(entries,
+                          [&id](const Entry& entry)
+                          {
+                              return entry.id == id;
+                          });
+
+            if(entries.empty())
+                m_cells.remove(cell);
+        }
+
+        m_cellsOfItems.erase(cellsOfItem);
+    }
+
+    /**
+     * Returns the item with a rect containing the point. If there are multiple,
+     * the one that was inserted first is returned.
+     */
+    std::optional<Id> itemAt(const QPointF& point) const
+    {
+        auto cell = m_cells.constFind(getCell(point));
+        if(cell == m_cells.cend())
+            return std::nullopt;
+
+        for(auto& entry : *cell)
+        {
+            if(entry.rect.contains(point))
+                return entry.id;
+        }
+
+        return std::nullopt;
+    }
+
+    bool containsItemAt(const QPointF& point) const
+    {
+        return itemAt(point).has_value();
+    }
+
+    bool isEmpty() const
+    {
+        return m_cellsOfItems.isEmpty();
+    }
+
+    void clear()
+    {
+        m_cells.clear();
+        m_cellsOfItems.clear();
+    }
+
+private:
+    struct Entry
+    {
+        Id id;
+        QRectF rect;
+    };
+
+    QPoint getCell(const QPointF& point) const
+    {
+        return QPoint(std::floor(point.x() / m_cellSize),
+                      std::floor(point.y() / m_cellSize));
+    }
+
+    qreal m_cellSize;
+    QHash<QPoint, std::vector<Entry>> m_cells;
+    QHash<Id, QList<QPoint>> m_cellsOfItems;
+};
+
+}  // namespace application::core::utils
@@ -0,0 +1,106 @@
+#include "term_page_index.hpp"
+#include <QMap>
+#include <algorithm>
+
+namespace application::core::utils
+{
+
+void TermPageIndex::write(const SearchIndex& index, QDataStream& stream)
+{
+    // The pages of the terms and the texts of the pages are collected first,
+    // so that where each of them starts is known before writing them.
+    QByteArray data;
+    QDataStream dataStream(&data, QIODevice::WriteOnly);
+    dataStream.setVersion(stream.version());
+
+    auto terms = index.getTerms();
+    QList<qint64> termOffsets;
+    termOffsets.reserve(terms.size());
+    for(auto& term : terms)
+    {
+        QMap<int, int> pageCounts;
+        for(auto& occurrence : index.findWord(term))
+            ++pageCounts[occurrence.pageNumber];
+
+        termOffsets.append(dataStream.device()->pos());
+        dataStream << pageCounts;
+    }
+
+    QList<qint64> pageTextOffsets;
+    pageTextOffsets.reserve(index.getPageCount());
+    for(int i = 0; i < index.getPageCount(); ++i)
+    {
+        pageTextOffsets.append(dataStream.device()->pos());
+        dataStream << index.getPageText(i);
+    }
+
+    stream << terms << termOffsets << pageTextOffsets;
+    stream.writeRawData(data.constData(), data.size());
+}
+
+bool TermPageIndex::open(QIODevice* device)
+{
+    QDataStream stream(device);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream >> m_terms >> m_termOffsets >> m_pageTextOffsets;
+    if(stream.status() != QDataStream::Ok ||
+       m_terms.size() != m_termOffsets.size())
+    {
+        return false;
+    }
+
+    m_device = device;
+    m_dataStart = device->pos();
+    return true;
+}
+
+QHash<int, int> TermPageIndex::findPrefix(const QString& prefix)
+{
+    auto term = SearchIndex::normalize(prefix);
+    if(term.isEmpty())
+        return {};
+
+    // The terms starting with the prefix are next to each other
+    QHash<int, int> pageCounts;
+    auto it = std::lower_bound(m_terms.cbegin(), m_terms.cend(), term);
+    for(; it != m_terms.cend() && it->startsWith(term); ++it)
+    {
+        if(!seek(m_termOffsets.at(it - m_terms.cbegin())))
+            continue;
+
+        QMap<int, int> termPageCounts;
+        QDataStream stream(m_device);
+        stream.setVersion(QDataStream::Qt_6_0);
+        stream >> termPageCounts;
+
+        for(auto page = termPageCounts.cbegin(); page != termPageCounts.cend();
+            ++page)
+        {
+            pageCounts[page.key()] += page.value();
+        }
+    }
+
+    return pageCounts;
+}
+
+QString TermPageIndex::getPageText(int pageNumber)
+{
+    if(pageNumber < 0 || pageNumber >= m_pageTextOffsets.size() ||
+       !seek(m_pageTextOffsets.at(pageNumber)))
+    {
+        return QString();
+    }
+
+    QString pageText;
+    QDataStream stream(m_device);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream >> pageText;
+    return pageText;
+}
+
+bool TermPageIndex::seek(qint64 offset)
+{
+    return m_device != nullptr && m_device->seek(m_dataStart + offset);
+}
+
+}  // namespace application::core::utils
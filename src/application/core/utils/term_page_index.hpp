@@ -0,0 +1,54 @@
+#pragma once
+#include <QDataStream>
+#include <QHash>
+#include <QIODevice>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include "application_export.hpp"
+#include "search_index.hpp"
+
+namespace application::core::utils
+{
+
+/**
+ * The TermPageIndex tells on which pages of a book the terms occur and what
+ * the text of these pages is, without loading the book's whole SearchIndex.
+ * It is stored in a small file next to the SearchIndex, e.g. to find the best
+ * page and the snippet of every result of searching the whole library.
+ *
+ * Only the sorted terms and the positions of everything else are read when
+ * opening it. The pages of a term and the text of a page are read from the
+ * device once they are looked up.
+ */
+class APPLICATION_EXPORT TermPageIndex
+{
+public:
+    /**
+     * Writes the index in the layout that open() expects.
+     */
+    static void write(const SearchIndex& index, QDataStream& stream);
+
+    /**
+     * The device must stay open while the TermPageIndex is used, it is read
+     * from its current position on.
+     */
+    bool open(QIODevice* device);
+
+    /**
+     * Returns how often the terms starting with the prefix occur on each page.
+     */
+    QHash<int, int> findPrefix(const QString& prefix);
+    QString getPageText(int pageNumber);
+
+private:
+    bool seek(qint64 offset);
+
+    QIODevice* m_device = nullptr;
+    QStringList m_terms;
+    QList<qint64> m_termOffsets;
+    QList<qint64> m_pageTextOffsets;
+    qint64 m_dataStart = 0;
+};
+
+}  // namespace application::core::utils
@@ -0,0 +1,103 @@
+#include "text_matcher.hpp"
+
+namespace application::core::utils
+{
+
+TextMatcher::TextMatcher(const QString& text, SearchOptions options) :
+    m_text(text),
+    m_options(options)
+{
+    if(!m_options.regularExpression)
+        return;
+
+    auto patternOptions = QRegularExpression::UseUnicodePropertiesOption;
+    if(!m_options.caseSensitive)
+        patternOptions |= QRegularExpression::CaseInsensitiveOption;
+
+    m_regularExpression.setPatternOptions(patternOptions);
+    m_regularExpression.setPattern(text);
+    m_regularExpression.optimize();
+}
+
+bool TextMatcher::isValid() const
+{
+    if(m_options.regularExpression)
+        return !m_text.isEmpty() && m_regularExpression.isValid();
+
+    return !m_text.isEmpty();
+}
+
+QList<TextMatcher::Match> TextMatcher::findMatches(const QString& text) const
+{
+    if(!isValid())
+        return {};
+
+    if(m_options.regularExpression)
+        return findRegularExpressionMatches(text);
+
+    return findPlainMatches(text);
+}
+
+QList<TextMatcher::Match> TextMatcher::findPlainMatches(
+    const QString& text) const
+{
+    auto caseSensitivity =
+        m_options.caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    QList<Match> matches;
+    auto position = text.indexOf(m_text, 0, caseSensitivity);
+    while(position != -1)
+    {
+        if(!m_options.wholeWords ||
+           isWholeWord(text, position, m_text.size()))
+        {
+            matches.append(Match { position, m_text.size() });
+            position += m_text.size();
+        }
+        else
+        {
+            ++position;
+        }
+
+        position = text.indexOf(m_text, position, caseSensitivity);
+    }
+
+    return matches;
+}
+
+QList<TextMatcher::Match> TextMatcher::findRegularExpressionMatches(
+    const QString& text) const
+{
+    QList<Match> matches;
+    auto iterator = m_regularExpression.globalMatch(text);
+    while(iterator.hasNext())
+    {
+        auto match = iterator.next();
+
+        // Empty matches (e.g. of "a*") can't be shown, so they are skipped
+        if(match.capturedLength() == 0)
+            continue;
+
+        if(m_options.wholeWords &&
+           !isWholeWord(text, match.capturedStart(), match.capturedLength()))
+        {
+            continue;
+        }
+
+        matches.append(Match { match.capturedStart(), match.capturedLength() });
+    }
+
+    return matches;
+}
+
+bool TextMatcher::isWholeWord(const QString& text, qsizetype start,
+                              qsizetype length)
+{
+    auto end = start + length;
+    bool startsWord = start == 0 || !text.at(start - 1).isLetterOrNumber();
+    bool endsWord = end == text.size() || !text.at(end).isLetterOrNumber();
+
+    return startsWord && endsWord;
+}
+
+}  // namespace application::core::utils
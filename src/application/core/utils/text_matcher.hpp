@@ -0,0 +1,52 @@
+#pragma once
+#include <QList>
+#include <QRegularExpression>
+#include <QString>
+#include "application_export.hpp"
+#include "search_options.hpp"
+
+namespace application::core::utils
+{
+
+/**
+ * The TextMatcher finds the matches of a search in the text of a page. It
+ * handles case sensitivity, whole words and regular expressions itself, so
+ * that every match is found in a single pass over the text, without asking
+ * MuPDF about every candidate.
+ *
+ * Words are runs of letters and numbers, the same as for the SearchIndex.
+ * Matching is reentrant, but a TextMatcher should not be shared between
+ * threads, since the regular expression is not thread-safe.
+ */
+class APPLICATION_EXPORT TextMatcher
+{
+public:
+    struct Match
+    {
+        qsizetype start;
+        qsizetype length;
+
+        bool operator==(const Match& other) const = default;
+    };
+
+    TextMatcher(const QString& text, SearchOptions options);
+
+    /**
+     * Returns false if there is nothing to search for, e.g. if the regular
+     * expression is not valid.
+     */
+    bool isValid() const;
+    QList<Match> findMatches(const QString& text) const;
+
+private:
+    QList<Match> findPlainMatches(const QString& text) const;
+    QList<Match> findRegularExpressionMatches(const QString& text) const;
+    static bool isWholeWord(const QString& text, qsizetype start,
+                            qsizetype length);
+
+    QString m_text;
+    SearchOptions m_options;
+    QRegularExpression m_regularExpression;
+};
+
+}  // namespace application::core::utils
@@ -0,0 +1,184 @@
+#include "text_page_cache.hpp"
+#include <QMutexLocker>
+
+namespace application::core::utils
+{
+
+TextPageCache::TextPageCache(qint64 budget) :
+    m_budget(budget)
+{
+}
+
+std::shared_ptr<mupdf::FzStextPage> TextPageCache::getTextPage(
+    int pageNumber, const TextPageFactory& createTextPage)
+{
+    return getTextPage(pageNumber, createTextPage, true);
+}
+
+std::shared_ptr<mupdf::FzStextPage> TextPageCache::getTextPageWithoutWaiting(
+    int pageNumber, const TextPageFactory& createTextPage)
+{
+    return getTextPage(pageNumber, createTextPage, false);
+}
+
+std::shared_ptr<mupdf::FzStextPage> TextPageCache::getTextPage(
+    int pageNumber, const TextPageFactory& createTextPage, bool wait)
+{
+    QMutexLocker locker(&m_mutex);
+    while(wait && m_pagesBeingExtracted.contains(pageNumber))
+        m_pageExtracted.wait(&m_mutex);
+
+    auto textPage = lookUp(pageNumber);
+    if(textPage != nullptr)
+        return textPage;
+
+    // The other thread's result is cached once it finishes, whichever copy
+    // of the page comes last replaces the other one.
+    if(m_pagesBeingExtracted.contains(pageNumber))
+    {
+        auto generation = m_generation;
+        locker.unlock();
+
+        textPage = createTextPage();
+
+        locker.relock();
+        if(textPage != nullptr && generation == m_generation)
+            insert(pageNumber, textPage);
+
+        return textPage;
+    }
+
+    // Extracting the text takes a while, other pages can be accessed meanwhile
+    m_pagesBeingExtracted.insert(pageNumber);
+    auto generation = m_generation;
+    locker.unlock();
+
+    try
+    {
+        textPage = createTextPage();
+    }
+    catch(...)
+    {
+        locker.relock();
+        m_pagesBeingExtracted.remove(pageNumber);
+        m_pageExtracted.wakeAll();
+        throw;
+    }
+
+    locker.relock();
+    m_pagesBeingExtracted.remove(pageNumber);
+    m_pageExtracted.wakeAll();
+    if(textPage != nullptr && generation == m_generation)
+        insert(pageNumber, textPage);
+
+    return textPage;
+}
+
+std::shared_ptr<mupdf::FzStextPage> TextPageCache::findTextPage(int pageNumber)
+{
+    QMutexLocker locker(&m_mutex);
+    return lookUp(pageNumber);
+}
+
+void TextPageCache::setBudget(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_budget = bytes;
+    evict();
+}
+
+qint64 TextPageCache::getBudget() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_budget;
+}
+
+qint64 TextPageCache::getCacheSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cacheSize;
+}
+
+int TextPageCache::getPageCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_lookup.size();
+}
+
+void TextPageCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    m_lookup.clear();
+    m_cacheSize = 0;
+    ++m_generation;
+}
+
+qint64 TextPageCache::estimateSize(const mupdf::FzStextPage& textPage)
+{
+    // MuPDF does not expose the size of a text page, but nearly all of it is
+    // taken up by its blocks, lines and characters.
+    qint64 size = sizeof(fz_stext_page);
+    auto* page = textPage.m_internal;
+    if(page == nullptr)
+        return size;
+
+    for(auto block = page->first_block; block != nullptr; block = block->next)
+    {
+        size += sizeof(fz_stext_block);
+        if(block->type != FZ_STEXT_BLOCK_TEXT)
+            continue;
+
+        for(auto line = block->u.t.first_line; line != nullptr;
+            line = line->next)
+        {
+            size += sizeof(fz_stext_line);
+            for(auto ch = line->first_char; ch != nullptr; ch = ch->next)
+                size += sizeof(fz_stext_char);
+        }
+    }
+
+    return size;
+}
+
+std::shared_ptr<mupdf::FzStextPage> TextPageCache::lookUp(int pageNumber)
+{
+    auto it = m_lookup.find(pageNumber);
+    if(it == m_lookup.end())
+        return nullptr;
+
+    // Mark the entry as the most recently used one
+    m_entries.splice(m_entries.begin(), m_entries, it.value());
+    return it.value()->textPage;
+}
+
+void TextPageCache::insert(int pageNumber,
+                           std::shared_ptr<mupdf::FzStextPage> textPage)
+{
+    auto it = m_lookup.find(pageNumber);
+    if(it != m_lookup.end())
+    {
+        m_cacheSize -= it.value()->size;
+        m_entries.erase(it.value());
+    }
+
+    auto size = estimateSize(*textPage);
+    m_entries.push_front({ pageNumber, std::move(textPage), size });
+    m_lookup.insert(pageNumber, m_entries.begin());
+    m_cacheSize += size;
+
+    evict();
+}
+
+void TextPageCache::evict()
+{
+    while(m_cacheSize > m_budget && !m_entries.empty())
+    {
+        auto& leastRecentlyUsed = m_entries.back();
+        m_cacheSize -= leastRecentlyUsed.size;
+        m_lookup.remove(leastRecentlyUsed.pageNumber);
+        m_entries.pop_back();
+    }
+}
+
+}  // namespace application::core::utils
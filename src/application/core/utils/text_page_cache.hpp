@@ -0,0 +1,97 @@
+#pragma once
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QWaitCondition>
+#include <functional>
+#include <list>
+#include <memory>
+#include "application_export.hpp"
+#include "mupdf/classes.h"
+
+namespace application::core::utils
+{
+
+/**
+ * The TextPageCache holds the structured text (FzStextPage) of a document's
+ * pages, so that the text of a page is extracted only once, no matter if it
+ * is needed for selecting text, looking up a word or searching the book.
+ *
+ * The text pages are handed out as shared pointers, so a page that is evicted
+ * stays alive until whoever is still using it lets go of it. Pages are evicted
+ * in least-recently-used order once their estimated size exceeds the budget.
+ *
+ * The cache may be accessed from multiple threads. If several threads ask for
+ * the same page at once, only the first one extracts it while the others wait
+ * for its result, unless they must not wait (e.g. the GUI thread). Text pages
+ * must only be read after they were handed out.
+ */
+class APPLICATION_EXPORT TextPageCache
+{
+public:
+    using TextPageFactory =
+        std::function<std::shared_ptr<mupdf::FzStextPage>()>;
+
+    TextPageCache(qint64 budget = 64 * 1024 * 1024);
+
+    /**
+     * Returns the cached text page, or extracts it by calling createTextPage
+     * and caches the result. Exceptions thrown while extracting the page are
+     * passed on to the caller.
+     */
+    std::shared_ptr<mupdf::FzStextPage> getTextPage(
+        int pageNumber, const TextPageFactory& createTextPage);
+
+    /**
+     * Same as getTextPage(), but if another thread is extracting the page,
+     * the page is extracted again instead of waiting for it. Meant for the
+     * GUI thread, which must not stall behind e.g. a low priority search.
+     */
+    std::shared_ptr<mupdf::FzStextPage> getTextPageWithoutWaiting(
+        int pageNumber, const TextPageFactory& createTextPage);
+
+    /**
+     * Returns the cached text page or nullptr, it never extracts the page.
+     */
+    std::shared_ptr<mupdf::FzStextPage> findTextPage(int pageNumber);
+
+    void setBudget(qint64 bytes);
+    qint64 getBudget() const;
+    qint64 getCacheSize() const;
+    int getPageCount() const;
+
+    void clear();
+
+    static qint64 estimateSize(const mupdf::FzStextPage& textPage);
+
+private:
+    struct Entry
+    {
+        int pageNumber;
+        std::shared_ptr<mupdf::FzStextPage> textPage;
+        qint64 size;
+    };
+
+    std::shared_ptr<mupdf::FzStextPage> getTextPage(
+        int pageNumber, const TextPageFactory& createTextPage, bool wait);
+    std::shared_ptr<mupdf::FzStextPage> lookUp(int pageNumber);
+    void insert(int pageNumber, std::shared_ptr<mupdf::FzStextPage> textPage);
+    void evict();
+
+    // Ordered from the most to the least recently used entry, the hash points
+    // into it for constant time lookups.
+    std::list<Entry> m_entries;
+    QHash<int, std::list<Entry>::iterator> m_lookup;
+    QSet<int> m_pagesBeingExtracted;
+    QWaitCondition m_pageExtracted;
+
+    mutable QMutex m_mutex;
+    qint64 m_budget;
+    qint64 m_cacheSize = 0;
+
+    // Increased when clearing the cache, pages that were being extracted
+    // before are not cached, since they might belong to a different document.
+    int m_generation = 0;
+};
+
+}  // namespace application::core::utils
@@ -9,8 +9,13 @@
 #include "bookmark.hpp"
 #include "highlight.hpp"
 #include "i_book_getter.hpp"
+#include "layout/page_geometry.hpp"
 #include "mupdf/classes.h"
+#include "rendering/render_cache.hpp"
+#include "rendering/render_scheduler.hpp"
+#include "search_hits.hpp"
 #include "search_options.hpp"
+#include "text_page_cache.hpp"
 #include "toc/filtered_toc_model.hpp"
 
 namespace application
@@ -27,14 +32,26 @@ class APPLICATION_EXPORT IBookService : public QObject
 public:
     virtual ~IBookService() noexcept = default;
 
+    /**
+     * The book's document is loaded in the background, getFzDocument()
+     * returns nullptr until loadingFinished() was emitted.
+     */
     virtual void setUp(std::unique_ptr<IBookGetter> bookGetter) = 0;
+    virtual void cancelLoading() = 0;
+    virtual bool isLoading() const = 0;
+    virtual double getLoadingProgress() const = 0;
     virtual mupdf::FzDocument* getFzDocument() = 0;
+    virtual core::RenderScheduler* getRenderScheduler() = 0;
+    virtual core::RenderCache* getRenderCache() = 0;
+    virtual core::utils::TextPageCache* getTextPageCache() = 0;
+    virtual const core::PageGeometry& getPageGeometry() const = 0;
 
     virtual void search(const QString& text,
                         core::utils::SearchOptions searchOptions) = 0;
     virtual void clearSearch() = 0;
     virtual void goToNextSearchHit() = 0;
     virtual void goToPreviousSearchHit() = 0;
+    virtual const core::utils::SearchHits& getSearchHits() const = 0;
 
     virtual const QList<domain::entities::Highlight>& getHighlights() const = 0;
     virtual void addHighlight(const domain::entities::Highlight& highlight) = 0;
@@ -44,6 +61,13 @@ public:
     virtual void updateBook() = 0;
     virtual const domain::entities::Highlight* getHighlightAtPoint(
         const QPointF& point, int page) const = 0;
+    virtual QList<const domain::entities::Highlight*> getHighlightsOfPage(
+        int page) const = 0;
+    /**
+     * Needs to be called when the book's highlights were changed without the
+     * BookService, e.g. by syncing the library.
+     */
+    virtual void reloadHighlights() = 0;
 
     virtual const QList<domain::entities::Bookmark>& getBookmarks() const = 0;
     virtual void addBookmark(const domain::entities::Bookmark& bookmark) = 0;
@@ -52,12 +76,17 @@ public:
 
     virtual void followLink(const char* uri) = 0;
 
+    virtual void prefetchPages(int currentPage, float pagesPerSecond) = 0;
+    virtual void prefetchPage(int pageNumber) = 0;
+    virtual void prefetchLinkTarget(const char* uri) = 0;
+
     virtual QString getFilePath() const = 0;
     virtual int getPageCount() const = 0;
     virtual void setCurrentPage(int newCurrentPage) = 0;
     virtual int getCurrentPage() const = 0;
     virtual float getZoom() const = 0;
     virtual void setZoom(float newZoom) = 0;
+    virtual void setDevicePixelRatio(double dpr) = 0;
 
     virtual QString getColorTheme() = 0;
     virtual void setColorTheme(const QString& colorTheme) = 0;
@@ -65,9 +94,15 @@ public:
     virtual core::FilteredTOCModel* getTableOfContents() = 0;
 
 signals:
+    void loadingStarted();
+    void loadingProgressChanged(double progress);
+    void loadingFinished();
+    void loadingFailed();
     void goToPosition(int pageNumber, int y);
     void highlightText(int pageNumber, mupdf::FzQuad quad);
     void noSearchHitsFound();
+    void searchHitsChanged();
+    void pageGeometryChanged();
 
     void bookmarkInsertionStarted(int index);
     void bookmarkInsertionEnded();
@@ -0,0 +1,39 @@
+#pragma once
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QUuid>
+#include "application_export.hpp"
+
+namespace application
+{
+
+struct LibrarySearchResult
+{
+    QUuid bookUuid;
+    QString title;
+    int pageNumber;
+    QString snippet;
+    double score;
+};
+
+/**
+ *  The LibrarySearchService searches the text of all downloaded books.
+ */
+class APPLICATION_EXPORT ILibrarySearchService : public QObject
+{
+    Q_OBJECT
+
+public:
+    virtual ~ILibrarySearchService() noexcept = default;
+
+    virtual void search(const QString& text) = 0;
+    virtual int getIndexedBookCount() const = 0;
+
+signals:
+    void searchResultsReady(
+        const QString& text,
+        const QList<application::LibrarySearchResult>& results);
+};
+
+}  // namespace application
@@ -72,6 +72,8 @@ signals:
     void syncingLibraryFinished();
     void downloadingBookMediaProgressChanged(int index);
     void downloadedProjectGutenbergIdsReady(const std::set<int>& ids);
+    void bookFileAvailable(const QUuid& uuid);
+    void bookFileRemoved(const QUuid& uuid);
 };
 
 }  // namespace application
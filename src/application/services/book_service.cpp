@@ -1,6 +1,5 @@
 #include "book_service.hpp"
 #include <mupdf/classes.h>
-#include <QApplication>
 #include <QDebug>
 #include <QDesktopServices>
 #include <string>
@@ -14,17 +13,134 @@ using domain::entities::Highlight;
 namespace application::services
 {
 
+BookService::BookService()
+{
+    connect(&m_pageGeometryLoader,
+            &core::PageGeometryLoader::pageGeometryLoaded, this,
+            &BookService::setPageGeometry);
+    connect(&m_searchIndexer, &core::utils::SearchIndexer::searchIndexLoaded,
+            this, &BookService::setSearchIndex);
+    connect(&m_documentLoader, &core::DocumentLoader::documentLoaded, this,
+            &BookService::setDocument);
+    connect(&m_documentLoader, &core::DocumentLoader::loadingProgressChanged,
+            this, &BookService::setLoadingProgress);
+    connect(&m_documentLoader, &core::DocumentLoader::loadingFailed, this,
+            [this]()
+            {
+                m_loading = false;
+                emit loadingFailed();
+            });
+
+    m_renderCache.setDiskCache(&m_diskRenderCache);
+    m_storePagesTimer.setSingleShot(true);
+    m_storePagesTimer.setInterval(1000);
+    connect(&m_storePagesTimer, &QTimer::timeout, this,
+            &BookService::storePagesOnDisk);
+}
+
 void BookService::setUp(std::unique_ptr<IBookGetter> bookGetter)
 {
     // Clean up previous book data first
+    if(m_storePagesTimer.isActive())
+    {
+        m_storePagesTimer.stop();
+        storePagesOnDisk();
+    }
     m_TOCModel = nullptr;
+    m_renderScheduler.cancelAllRenders();
+    m_renderCache.clear();
+
+    // The searcher must be gone before clearing the text pages, otherwise it
+    // might still add pages of the previous book
+    m_bookSearcher = nullptr;
+    m_textPageCache.clear();
+    m_pageGeometry = PageGeometry();
+
+    // Nothing may use the previous book's document while the next one loads
+    m_documentLoader.cancel();
+    m_pageGeometryLoader.cancel();
+    m_searchIndexer.cancel();
+    m_pagePrefetcher.setUp(QString(), QString(), 0);
+    m_fzDocument = nullptr;
+    m_pageCount = 0;
 
     m_bookGetter = std::move(bookGetter);
     auto book = m_bookGetter->getBook();
-    auto stdFilePath = book->getFilePath().toStdString();
-    m_fzDocument = std::make_unique<mupdf::FzDocument>(stdFilePath.c_str());
 
-    m_bookSearcher = std::make_unique<BookSearcher>(m_fzDocument.get());
+    m_bookSearcher = std::make_unique<BookSearcher>(
+        book->getFilePath(), getCacheKey(), &m_textPageCache);
+    connect(m_bookSearcher.get(), &BookSearcher::searchHitsFound, this,
+            &BookService::showFirstSearchHit);
+    connect(m_bookSearcher.get(), &BookSearcher::searchHitsFound, this,
+            &BookService::searchHitsChanged);
+    connect(m_bookSearcher.get(), &BookSearcher::searchFinished, this,
+            [this](int hitCount)
+            {
+                if(hitCount == 0)
+                    emit noSearchHitsFound();
+            });
+    m_pagePrefetcher.setRenderParameters(m_zoom, m_dpr);
+    setupHighlightIndex();
+    m_diskRenderCache.setUp(getCacheKey(), book->getFilePath());
+
+    m_loading = true;
+    m_loadingProgress = 0;
+    m_documentLoader.load(book->getFilePath(), getCacheKey(),
+                          book->getCurrentPage());
+    emit loadingStarted();
+}
+
+void BookService::cancelLoading()
+{
+    if(!m_loading)
+        return;
+
+    m_documentLoader.cancel();
+    m_loading = false;
+}
+
+bool BookService::isLoading() const
+{
+    return m_loading;
+}
+
+double BookService::getLoadingProgress() const
+{
+    return m_loadingProgress;
+}
+
+void BookService::setDocument(const LoadedDocument& loadedDocument)
+{
+    m_fzDocument = std::make_unique<mupdf::FzDocument>(loadedDocument.document);
+    m_pageCount = loadedDocument.pageCount;
+    m_renderCache.insertDisplayList(loadedDocument.firstPage,
+                                    loadedDocument.firstPageDisplayList);
+    m_pagePrefetcher.setUp(getFilePath(), getCacheKey(), m_pageCount);
+
+    m_loading = false;
+    m_loadingProgress = 1;
+    emit loadingFinished();
+
+    // Both are checked against the document's page count once they arrive
+    m_pageGeometryLoader.load(getFilePath(), getCacheKey());
+    m_searchIndexer.load(getFilePath(), getCacheKey());
+}
+
+void BookService::setLoadingProgress(double progress)
+{
+    m_loadingProgress = progress;
+    emit loadingProgressChanged(progress);
+}
+
+QString BookService::getCacheKey() const
+{
+    // Books without a file hash (e.g. external ones) are identified by path
+    auto book = m_bookGetter->getBook();
+    auto cacheKey = book->getFileHash();
+    if(cacheKey.isEmpty())
+        cacheKey = book->getFilePath();
+
+    return cacheKey;
 }
 
 mupdf::FzDocument* BookService::getFzDocument()
@@ -32,46 +148,114 @@ mupdf::FzDocument* BookService::getFzDocument()
     return m_fzDocument.get();
 }
 
-void BookService::search(const QString& text, SearchOptions searchOptions)
+RenderScheduler* BookService::getRenderScheduler()
 {
-    QApplication::setOverrideCursor(Qt::WaitCursor);
-    m_bookSearcher->search(text, searchOptions);
-    QApplication::restoreOverrideCursor();
+    return &m_renderScheduler;
+}
 
-    auto searchHit = m_bookSearcher->firstSearchHit();
-    if(searchHit.pageNumber == -1)
+RenderCache* BookService::getRenderCache()
+{
+    return &m_renderCache;
+}
+
+TextPageCache* BookService::getTextPageCache()
+{
+    return &m_textPageCache;
+}
+
+const PageGeometry& BookService::getPageGeometry() const
+{
+    return m_pageGeometry;
+}
+
+void BookService::setPageGeometry(const PageGeometry& pageGeometry)
+{
+    // The document might have been laid out differently (e.g. for reflowable
+    // formats) when the geometry was computed, in which case it is useless.
+    if(pageGeometry.getPageCount() != m_pageCount)
+    {
+        qWarning() << QString("Discarding page geometry of book at: %1, its "
+                              "page count does not match the document's")
+                          .arg(getFilePath());
+        return;
+    }
+
+    m_pageGeometry = pageGeometry;
+    emit pageGeometryChanged();
+}
+
+void BookService::setSearchIndex(
+    std::shared_ptr<const core::utils::SearchIndex> searchIndex)
+{
+    // Same as for the page geometry, an index of a different layout of the
+    // document would point to the wrong pages.
+    if(searchIndex->getPageCount() != m_pageCount)
     {
-        emit noSearchHitsFound();
+        qWarning() << QString("Discarding search index of book at: %1, its "
+                              "page count does not match the document's")
+                          .arg(getFilePath());
         return;
     }
 
+    m_bookSearcher->setSearchIndex(std::move(searchIndex));
+}
+
+void BookService::search(const QString& text, SearchOptions searchOptions)
+{
+    // The hits arrive page by page, the first one is shown once it is found
+    m_bookSearcher->search(text, searchOptions);
+    emit searchHitsChanged();
+}
+
+void BookService::showFirstSearchHit()
+{
+    // Only jump to the search's first hit, later ones are navigated to by
+    // the user.
+    if(m_bookSearcher->hasCurrentSearchHit())
+        return;
+
+    auto searchHit = m_bookSearcher->firstSearchHit();
     emit goToPosition(searchHit.pageNumber, searchHit.rect.ul.y);
     emit highlightText(searchHit.pageNumber, searchHit.rect);
+    prefetchNextSearchHit();
 }
 
 void BookService::clearSearch()
 {
     m_bookSearcher->clearSearch();
+    emit searchHitsChanged();
 }
 
 void BookService::goToNextSearchHit()
 {
-    auto searchHit = m_bookSearcher->nextSearchHit();
+    auto searchHit = m_bookSearcher->nextSearchHit(getCurrentPage());
     if(searchHit.pageNumber == -1)
         return;
 
     emit goToPosition(searchHit.pageNumber, searchHit.rect.ul.y);
     emit highlightText(searchHit.pageNumber, searchHit.rect);
+    prefetchNextSearchHit();
+}
+
+const SearchHits& BookService::getSearchHits() const
+{
+    // There are no hits before a book was set up
+    static const SearchHits noSearchHits;
+    if(m_bookSearcher == nullptr)
+        return noSearchHits;
+
+    return m_bookSearcher->getSearchHits();
 }
 
 void BookService::goToPreviousSearchHit()
 {
-    auto searchHit = m_bookSearcher->previousSearchHit();
+    auto searchHit = m_bookSearcher->previousSearchHit(getCurrentPage());
     if(searchHit.pageNumber == -1)
         return;
 
     emit goToPosition(searchHit.pageNumber, searchHit.rect.ul.y);
     emit highlightText(searchHit.pageNumber, searchHit.rect);
+    prefetchNextSearchHit();
 }
 
 const QList<domain::entities::Highlight>& BookService::getHighlights() const
@@ -84,6 +268,7 @@ void BookService::addHighlight(const domain::entities::Highlight& highlight)
 {
     auto book = m_bookGetter->getBook();
     book->addHighlight(highlight);
+    setupHighlightIndex();
 
     updateBook();
 }
@@ -92,6 +277,7 @@ void BookService::removeHighlight(const QUuid& uuid)
 {
     auto book = m_bookGetter->getBook();
     book->removeHighlight(uuid);
+    setupHighlightIndex();
 
     updateBook();
 }
@@ -100,6 +286,7 @@ void BookService::changeHighlightColor(const QUuid& uuid, const QColor& color)
 {
     auto book = m_bookGetter->getBook();
     book->changeHighlightColor(uuid, color);
+    setupHighlightIndex();
 
     updateBook();
 }
@@ -114,20 +301,56 @@ void BookService::updateBook()
 const Highlight* BookService::getHighlightAtPoint(const QPointF& point,
                                                   int page) const
 {
-    auto book = m_bookGetter->getBook();
-    for(auto& highlight : book->getHighlights())
+    auto pageIndex = m_highlightIndex.constFind(page);
+    if(pageIndex == m_highlightIndex.cend())
+        return nullptr;
+
+    auto position = pageIndex->rects.itemAt(point);
+    if(!position.has_value())
+        return nullptr;
+
+    auto& highlights = getHighlights();
+    if(*position >= highlights.size())
+        return nullptr;
+
+    return &highlights[*position];
+}
+
+QList<const Highlight*> BookService::getHighlightsOfPage(int page) const
+{
+    auto pageIndex = m_highlightIndex.constFind(page);
+    if(pageIndex == m_highlightIndex.cend())
+        return {};
+
+    auto& highlights = getHighlights();
+    QList<const Highlight*> pageHighlights;
+    for(auto position : pageIndex->positions)
     {
-        if(highlight.getPageNumber() != page)
-            continue;
+        if(position < highlights.size())
+            pageHighlights.append(&highlights[position]);
+    }
+
+    return pageHighlights;
+}
+
+void BookService::reloadHighlights()
+{
+    setupHighlightIndex();
+}
 
+void BookService::setupHighlightIndex()
+{
+    m_highlightIndex.clear();
+
+    auto& highlights = getHighlights();
+    for(qsizetype i = 0; i < highlights.size(); ++i)
+    {
+        auto& highlight = highlights[i];
+        auto& pageIndex = m_highlightIndex[highlight.getPageNumber()];
+        pageIndex.positions.append(i);
         for(auto& rect : highlight.getRects())
-        {
-            if(rect.getQRect().contains(point))
-                return &highlight;
-        }
+            pageIndex.rects.insert(i, rect.getQRect());
     }
-
-    return nullptr;
 }
 
 const QList<domain::entities::Bookmark>& BookService::getBookmarks() const
@@ -177,13 +400,52 @@ void BookService::followLink(const char* uri)
     else
     {
         float yp = 0;
-        auto location = m_fzDocument->fz_resolve_link(uri, nullptr, &yp);
-        int pageNumber = m_fzDocument->fz_page_number_from_location(location);
+        int pageNumber = getPageNumberOfLink(uri, &yp);
+        if(pageNumber == -1)
+            return;
 
         emit goToPosition(pageNumber, yp);
     }
 }
 
+void BookService::prefetchPages(int currentPage, float pagesPerSecond)
+{
+    m_pagePrefetcher.prefetchAround(currentPage, pagesPerSecond);
+}
+
+void BookService::prefetchPage(int pageNumber)
+{
+    m_pagePrefetcher.prefetchPage(pageNumber);
+}
+
+void BookService::prefetchLinkTarget(const char* uri)
+{
+    if(uri == nullptr || mupdf::ll_fz_is_external_link(uri))
+        return;
+
+    auto pageNumber = getPageNumberOfLink(uri);
+    if(pageNumber != -1)
+        m_pagePrefetcher.prefetchPage(pageNumber);
+}
+
+int BookService::getPageNumberOfLink(const char* uri, float* yp)
+{
+    // Links can only be resolved once the document was loaded
+    if(m_fzDocument == nullptr)
+        return -1;
+
+    auto location = m_fzDocument->fz_resolve_link(uri, nullptr, yp);
+    return m_fzDocument->fz_page_number_from_location(location);
+}
+
+void BookService::prefetchNextSearchHit()
+{
+    // The user is likely to jump to the next search hit soon
+    auto nextSearchHit = m_bookSearcher->peekNextSearchHit();
+    if(nextSearchHit.pageNumber != -1)
+        m_pagePrefetcher.prefetchPage(nextSearchHit.pageNumber);
+}
+
 QString BookService::getFilePath() const
 {
     auto book = m_bookGetter->getBook();
@@ -192,6 +454,10 @@ QString BookService::getFilePath() const
 
 int BookService::getPageCount() const
 {
+    // The stored page count is a good guess until the document was laid out
+    if(m_fzDocument != nullptr)
+        return m_pageCount;
+
     auto book = m_bookGetter->getBook();
     return book->getPageCount();
 }
@@ -206,6 +472,25 @@ void BookService::setCurrentPage(int newCurrentPage)
 {
     auto book = m_bookGetter->getBook();
     book->setCurrentPage(newCurrentPage);
+
+    m_storePagesTimer.start();
+}
+
+void BookService::storePagesOnDisk()
+{
+    // Only pages that were already rendered are stored, the disk cache skips
+    // the ones it already contains.
+    auto currentPage = getCurrentPage();
+    for(int page = currentPage - 1; page <= currentPage + 1; ++page)
+    {
+        if(page < 0 || page >= m_pageCount)
+            continue;
+
+        auto key = m_pagePrefetcher.getRenderCacheKey(page);
+        auto image = m_renderCache.getImage(key);
+        if(!image.isNull())
+            m_diskRenderCache.storeImage(key, image);
+    }
 }
 
 float BookService::getZoom() const
@@ -216,6 +501,13 @@ float BookService::getZoom() const
 void BookService::setZoom(float newZoom)
 {
     m_zoom = newZoom;
+    m_pagePrefetcher.setRenderParameters(m_zoom, m_dpr);
+}
+
+void BookService::setDevicePixelRatio(double dpr)
+{
+    m_dpr = dpr;
+    m_pagePrefetcher.setRenderParameters(m_zoom, m_dpr);
 }
 
 QString BookService::getColorTheme()
@@ -233,11 +525,14 @@ void BookService::setColorTheme(const QString& colorTheme)
 
 core::FilteredTOCModel* BookService::getTableOfContents()
 {
+    // The outline is only available once the document was loaded
+    if(m_fzDocument == nullptr)
+        return nullptr;
+
     if(m_TOCModel == nullptr)
     {
-        auto data = m_fzDocument->fz_load_outline();
-        m_TOCModel =
-            std::make_unique<TOCModel>(data.m_internal, *m_fzDocument.get());
+        m_TOCModel = std::make_unique<TOCModel>(
+            m_fzDocument->fz_load_outline(), getFilePath(), getCacheKey());
         m_filteredTOCModel = std::make_unique<FilteredTOCModel>();
         m_filteredTOCModel->setSourceModel(m_TOCModel.get());
     }
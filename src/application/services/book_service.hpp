@@ -1,11 +1,21 @@
 #pragma once
+#include <QTimer>
 #include <memory>
 #include "i_book_getter.hpp"
 #include "i_book_service.hpp"
+#include "layout/document_loader.hpp"
+#include "layout/page_geometry.hpp"
+#include "layout/page_geometry_loader.hpp"
 #include "mupdf/classes.h"
+#include "rendering/disk_render_cache.hpp"
+#include "rendering/page_prefetcher.hpp"
+#include "rendering/render_cache.hpp"
+#include "rendering/render_scheduler.hpp"
 #include "toc/filtered_toc_model.hpp"
 #include "toc/toc_model.hpp"
 #include "utils/book_searcher.hpp"
+#include "utils/search_indexer.hpp"
+#include "utils/spatial_grid.hpp"
 
 namespace application::services
 {
@@ -13,14 +23,24 @@ namespace application::services
 class BookService : public IBookService
 {
 public:
+    BookService();
+
     void setUp(std::unique_ptr<IBookGetter> bookGetter) override;
+    void cancelLoading() override;
+    bool isLoading() const override;
+    double getLoadingProgress() const override;
     mupdf::FzDocument* getFzDocument() override;
+    core::RenderScheduler* getRenderScheduler() override;
+    core::RenderCache* getRenderCache() override;
+    core::utils::TextPageCache* getTextPageCache() override;
+    const core::PageGeometry& getPageGeometry() const override;
 
     void search(const QString& text,
                 core::utils::SearchOptions searchOptions) override;
     void clearSearch() override;
     void goToNextSearchHit() override;
     void goToPreviousSearchHit() override;
+    const core::utils::SearchHits& getSearchHits() const override;
 
     const QList<domain::entities::Highlight>& getHighlights() const override;
     void addHighlight(const domain::entities::Highlight& highlight) override;
@@ -28,6 +48,9 @@ public:
     void changeHighlightColor(const QUuid& uuid, const QColor& color) override;
     const domain::entities::Highlight* getHighlightAtPoint(
         const QPointF& point, int page) const override;
+    QList<const domain::entities::Highlight*> getHighlightsOfPage(
+        int page) const override;
+    void reloadHighlights() override;
 
     const QList<domain::entities::Bookmark>& getBookmarks() const override;
     void addBookmark(const domain::entities::Bookmark& bookmark) override;
@@ -36,12 +59,17 @@ public:
 
     void followLink(const char* uri) override;
 
+    void prefetchPages(int currentPage, float pagesPerSecond) override;
+    void prefetchPage(int pageNumber) override;
+    void prefetchLinkTarget(const char* uri) override;
+
     QString getFilePath() const override;
     int getPageCount() const override;
     int getCurrentPage() const override;
     void setCurrentPage(int newCurrentPage) override;
     float getZoom() const override;
     void setZoom(float newZoom) override;
+    void setDevicePixelRatio(double dpr) override;
 
     QString getColorTheme() override;
     void setColorTheme(const QString& colorTheme) override;
@@ -52,11 +80,63 @@ public:
 
 private:
     int getIndexOfBookmark(const QUuid& uuid) const;
+    void setupHighlightIndex();
+    int getPageNumberOfLink(const char* uri, float* yp = nullptr);
+    void prefetchNextSearchHit();
+    void showFirstSearchHit();
+    void setDocument(const core::LoadedDocument& loadedDocument);
+    void setLoadingProgress(double progress);
+    void setSearchIndex(
+        std::shared_ptr<const core::utils::SearchIndex> searchIndex);
+    void setPageGeometry(const core::PageGeometry& pageGeometry);
+    void storePagesOnDisk();
+    QString getCacheKey() const;
 
     std::unique_ptr<IBookGetter> m_bookGetter;
     std::unique_ptr<mupdf::FzDocument> m_fzDocument = nullptr;
+    int m_pageCount = 0;
+
+    // Opens the document in the background, the book is loading until the
+    // document was handed over.
+    core::DocumentLoader m_documentLoader;
+    bool m_loading = false;
+    double m_loadingProgress = 0;
+
+    // Declared before the searcher, whose workers use it until it is destroyed
+    core::utils::TextPageCache m_textPageCache;
     std::unique_ptr<core::utils::BookSearcher> m_bookSearcher = nullptr;
+    core::RenderScheduler m_renderScheduler;
+    core::DiskRenderCache m_diskRenderCache;
+    core::RenderCache m_renderCache;
+    core::PagePrefetcher m_pagePrefetcher { &m_renderScheduler,
+                                            &m_renderCache };
+
+    // The size of every page, it is loaded in the background once the book
+    // was opened and stays empty until then.
+    core::PageGeometry m_pageGeometry;
+    core::PageGeometryLoader m_pageGeometryLoader;
+
+    // Built in the background the first time a book is opened, searches
+    // scan the pages until it is available.
+    core::utils::SearchIndexer m_searchIndexer;
+
+    // The pages around the reading position are stored on disk once the user
+    // stopped moving through the book, so that reopening it is instant.
+    QTimer m_storePagesTimer;
+
+    // Per page index of the highlights, so that drawing a page or hit-testing
+    // a point doesn't look at every highlight of the book. It refers to the
+    // highlights by their position in the book's list of highlights, so it is
+    // rebuilt whenever that list changes.
+    struct PageHighlights
+    {
+        QList<qsizetype> positions;
+        core::utils::SpatialGrid<qsizetype> rects;
+    };
+
+    QHash<int, PageHighlights> m_highlightIndex;
     float m_zoom = 1;
+    double m_dpr = 1;
 
     std::unique_ptr<core::TOCModel> m_TOCModel;
     std::unique_ptr<core::FilteredTOCModel> m_filteredTOCModel;
@@ -0,0 +1,315 @@
+#include "library_search_service.hpp"
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <limits>
+#include "layout/layout_cache.hpp"
+#include "layout/page_geometry_loader.hpp"
+#include "search_indexer.hpp"
+#include "toc/toc_link_resolver.hpp"
+
+namespace application::services
+{
+
+using namespace core::utils;
+
+LibrarySearchService::LibrarySearchService(ILibraryService* libraryService) :
+    m_libraryService(libraryService)
+{
+    // Indexing runs in the background while the app is used, so it only takes
+    // up one thread. Changes to the index are applied in the order they were
+    // made, since there is only one thread to apply them.
+    m_indexingThreadPool.setMaxThreadCount(1);
+    m_searchThreadPool.setMaxThreadCount(1);
+
+    // Don't write the index after every book, e.g. when indexing the whole
+    // library for the first time
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(5000);
+    connect(&m_saveTimer, &QTimer::timeout, this,
+            [this]()
+            {
+                m_indexingThreadPool.start(
+                    [this]()
+                    {
+                        saveLibraryIndex();
+                    });
+            });
+
+    connect(m_libraryService, &ILibraryService::bookFileAvailable, this,
+            &LibrarySearchService::indexBook);
+    connect(m_libraryService, &ILibraryService::bookFileRemoved, this,
+            &LibrarySearchService::removeBook);
+    connect(m_libraryService, &ILibraryService::bookClearingEnded, this,
+            &LibrarySearchService::removeAllBooks);
+
+    m_indexingThreadPool.start(
+        [this]()
+        {
+            loadLibraryIndex();
+        });
+}
+
+LibrarySearchService::~LibrarySearchService()
+{
+    m_stopping = true;
+    ++m_searchGeneration;
+    m_searchThreadPool.waitForDone();
+    m_indexingThreadPool.waitForDone();
+
+    if(m_hasUnsavedChanges)
+        saveLibraryIndex();
+}
+
+void LibrarySearchService::search(const QString& text)
+{
+    auto generation = ++m_searchGeneration;
+    if(SearchIndex::splitIntoTerms(text).isEmpty())
+    {
+        emit searchResultsReady(text, {});
+        return;
+    }
+
+    // The book files are copied, since they are changed on this thread
+    m_searchThreadPool.start(
+        [this, text, generation, bookFiles = m_bookFiles]()
+        {
+            if(generation != m_searchGeneration)
+                return;
+
+            auto results = findResults(text, bookFiles);
+
+            // Deliver the results on the thread the service lives in. They are
+            // dropped if a different search was started in the meantime.
+            QMetaObject::invokeMethod(
+                this,
+                [this, text, results, generation]()
+                {
+                    if(generation == m_searchGeneration)
+                        emit searchResultsReady(text, results);
+                },
+                Qt::QueuedConnection);
+        });
+}
+
+int LibrarySearchService::getIndexedBookCount() const
+{
+    QReadLocker locker(&m_libraryIndexLock);
+    return m_libraryIndex.getBookCount();
+}
+
+void LibrarySearchService::indexBook(const QUuid& uuid)
+{
+    const auto* book = m_libraryService->getBook(uuid);
+    if(book == nullptr || !book->isDownloaded() ||
+       book->getFilePath().isEmpty())
+    {
+        return;
+    }
+
+    // Same key as when opening the book, so that the book's index is shared
+    auto cacheKey = book->getFileHash();
+    if(cacheKey.isEmpty())
+        cacheKey = book->getFilePath();
+
+    BookFile bookFile {
+        .filePath = book->getFilePath(),
+        .cacheKey = cacheKey,
+        .title = book->getTitle(),
+    };
+    m_bookFiles.insert(uuid, bookFile);
+
+    m_indexingThreadPool.start(
+        [this, uuid, bookFile]()
+        {
+            {
+                QReadLocker locker(&m_libraryIndexLock);
+                if(m_libraryIndex.containsBook(uuid, bookFile.cacheKey))
+                    return;
+            }
+
+            // Indexing must not slow down rendering or searching
+            QThread::currentThread()->setPriority(QThread::LowestPriority);
+            auto index = SearchIndexer::loadOrBuildIndex(
+                bookFile.filePath, bookFile.cacheKey,
+                [this]()
+                {
+                    return m_stopping.load();
+                });
+            if(index == nullptr)
+                return;
+
+            {
+                QWriteLocker locker(&m_libraryIndexLock);
+                m_libraryIndex.addBook(uuid, bookFile.cacheKey, *index);
+            }
+
+            scheduleSave();
+        });
+}
+
+void LibrarySearchService::removeBook(const QUuid& uuid)
+{
+    auto bookFile = m_bookFiles.take(uuid);
+
+    // Removed after the book was indexed, in case it is still being indexed
+    m_indexingThreadPool.start(
+        [this, uuid, bookFile]()
+        {
+            {
+                QWriteLocker locker(&m_libraryIndexLock);
+                m_libraryIndex.removeBook(uuid);
+            }
+
+            if(!bookFile.cacheKey.isEmpty())
+                removeStoredBookData(bookFile.cacheKey);
+
+            scheduleSave();
+        });
+}
+
+void LibrarySearchService::removeStoredBookData(const QString& cacheKey)
+{
+    // What was stored to open the book faster is useless once its file is
+    // gone. Stored page images are not removed here, the DiskRenderCache
+    // bounds their size itself.
+    SearchIndexer::removeFromCache(cacheKey);
+    core::PageGeometryLoader::removeFromCache(cacheKey);
+    core::TOCLinkResolver::removeFromCache(cacheKey);
+    core::LayoutCache::removeLayouts(cacheKey);
+}
+
+void LibrarySearchService::removeAllBooks()
+{
+    m_bookFiles.clear();
+
+    m_indexingThreadPool.start(
+        [this]()
+        {
+            {
+                QWriteLocker locker(&m_libraryIndexLock);
+                m_libraryIndex.clear();
+            }
+
+            scheduleSave();
+        });
+}
+
+QList<LibrarySearchResult> LibrarySearchService::findResults(
+    const QString& text, const QHash<QUuid, BookFile>& bookFiles) const
+{
+    // The index might still contain books which were removed while the app
+    // was closed, those are skipped.
+    QList<LibrarySearchIndex::BookMatch> matches;
+    {
+        QReadLocker locker(&m_libraryIndexLock);
+        matches = m_libraryIndex.search(text, std::numeric_limits<int>::max());
+    }
+
+    QList<LibrarySearchResult> results;
+    for(auto& match : matches)
+    {
+        if(results.size() == maxResults || m_stopping)
+            break;
+
+        if(!bookFiles.contains(match.uuid))
+            continue;
+
+        auto bookFile = bookFiles.value(match.uuid);
+        auto bestMatch = SearchIndexer::findBestMatch(bookFile.filePath,
+                                                      bookFile.cacheKey, text);
+        if(!bestMatch.has_value())
+            continue;
+
+        results.append(LibrarySearchResult {
+            .bookUuid = match.uuid,
+            .title = bookFile.title,
+            .pageNumber = bestMatch->pageNumber,
+            .snippet = bestMatch->snippet,
+            .score = match.score,
+        });
+    }
+
+    return results;
+}
+
+void LibrarySearchService::scheduleSave()
+{
+    m_hasUnsavedChanges = true;
+    QMetaObject::invokeMethod(
+        this,
+        [this]()
+        {
+            m_saveTimer.start();
+        },
+        Qt::QueuedConnection);
+}
+
+void LibrarySearchService::loadLibraryIndex()
+{
+    QFile file(getLibraryIndexFilePath());
+    if(!file.open(QFile::ReadOnly))
+        return;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    int version = 0;
+    stream >> version;
+    if(version != formatVersion)
+        return;
+
+    LibrarySearchIndex libraryIndex;
+    stream >> libraryIndex;
+    if(stream.status() != QDataStream::Ok)
+    {
+        qWarning() << QString("Failed loading library search index at: %1")
+                          .arg(file.fileName());
+        return;
+    }
+
+    QWriteLocker locker(&m_libraryIndexLock);
+    m_libraryIndex = std::move(libraryIndex);
+}
+
+void LibrarySearchService::saveLibraryIndex()
+{
+    m_hasUnsavedChanges = false;
+
+    // Written to a temporary file first, so that no partial index is read
+    QSaveFile file(getLibraryIndexFilePath());
+    if(!file.open(QFile::WriteOnly))
+    {
+        qWarning() << QString("Saving library search index failed. "
+                              "Failed opening file at: %1")
+                          .arg(file.fileName());
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    {
+        QReadLocker locker(&m_libraryIndexLock);
+        stream << formatVersion << m_libraryIndex;
+    }
+
+    if(!file.commit())
+    {
+        qWarning() << QString("Saving library search index failed. "
+                              "Failed writing file at: %1")
+                          .arg(file.fileName());
+    }
+}
+
+QString LibrarySearchService::getLibraryIndexFilePath() const
+{
+    QDir dir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+    dir.mkpath(".");
+    return dir.filePath("library_search_index.bin");
+}
+
+}  // namespace application::services
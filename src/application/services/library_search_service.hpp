@@ -0,0 +1,73 @@
+#pragma once
+#include <QHash>
+#include <QReadWriteLock>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include "i_library_search_service.hpp"
+#include "i_library_service.hpp"
+#include "library_search_index.hpp"
+#include "search_index.hpp"
+
+namespace application::services
+{
+
+/**
+ * Searches all downloaded books using a LibrarySearchIndex, which is kept up
+ * to date in the background as books are added, downloaded or removed.
+ *
+ * The LibrarySearchIndex only tells which books match, the page and snippet
+ * of a result are taken from the TermPageIndex stored next to the book's own
+ * SearchIndex. Only the parts of it that are needed are read, instead of
+ * loading the whole SearchIndex of every result. The SearchIndex is built
+ * the same way as when opening the book, so that both share their files.
+ */
+class APPLICATION_EXPORT LibrarySearchService : public ILibrarySearchService
+{
+    Q_OBJECT
+
+public:
+    LibrarySearchService(ILibraryService* libraryService);
+    ~LibrarySearchService();
+
+    void search(const QString& text) override;
+    int getIndexedBookCount() const override;
+
+private slots:
+    void indexBook(const QUuid& uuid);
+    void removeBook(const QUuid& uuid);
+    void removeAllBooks();
+
+private:
+    struct BookFile
+    {
+        QString filePath;
+        QString cacheKey;
+        QString title;
+    };
+
+    QList<LibrarySearchResult> findResults(
+        const QString& text, const QHash<QUuid, BookFile>& bookFiles) const;
+    void removeStoredBookData(const QString& cacheKey);
+    void scheduleSave();
+    void loadLibraryIndex();
+    void saveLibraryIndex();
+    QString getLibraryIndexFilePath() const;
+
+    // Identifies the layout of the index file, increase it when changing it
+    static constexpr int formatVersion = 1;
+    static constexpr int maxResults = 20;
+
+    ILibraryService* m_libraryService;
+    QHash<QUuid, BookFile> m_bookFiles;
+    core::utils::LibrarySearchIndex m_libraryIndex;
+    mutable QReadWriteLock m_libraryIndexLock;
+    QThreadPool m_indexingThreadPool;
+    QThreadPool m_searchThreadPool;
+    QTimer m_saveTimer;
+    std::atomic<int> m_searchGeneration = 0;
+    std::atomic<bool> m_hasUnsavedChanges = false;
+    std::atomic<bool> m_stopping = false;
+};
+
+}  // namespace application::services
@@ -151,6 +151,7 @@ BookOperationStatus LibraryService::addBook(const QString& filePath,
     addBookToLibrary(book);
 
     m_libraryStorageManager->addBook(book);
+    emit bookFileAvailable(book.getUuid());
     return BookOperationStatus::Success;
 }
 
@@ -189,6 +190,7 @@ BookOperationStatus LibraryService::deleteBook(const QUuid& uuid)
     m_books.erase(bookPosition);
     emit bookDeletionEnded();
 
+    emit bookFileRemoved(bookToDelete.uuid);
     m_libraryStorageManager->deleteBook(std::move(bookToDelete));
     return BookOperationStatus::Success;
 }
@@ -212,6 +214,7 @@ BookOperationStatus LibraryService::uninstallBook(const QUuid& uuid)
 
     m_libraryStorageManager->uninstallBook(*book);
     book->setDownloaded(false);
+    emit bookFileRemoved(uuid);
 
     refreshUIForBook(uuid);
     return BookOperationStatus::Success;
@@ -591,6 +594,7 @@ void LibraryService::processDownloadedBook(const QUuid& uuid,
 
     // The book meta-data file does not exist locally, so create it
     m_libraryStorageManager->addBookLocally(*book);
+    emit bookFileAvailable(uuid);
 
     refreshUIForBook(uuid);
 }
@@ -632,6 +636,9 @@ void LibraryService::loadLocalBooks()
     {
         uninstallBookIfTheBookFileIsInvalid(book);
         addBookToLibrary(book);
+
+        if(book.isDownloaded())
+            emit bookFileAvailable(book.getUuid());
     }
 }
 
@@ -752,6 +759,7 @@ void LibraryService::deleteBookLocally(const domain::entities::Book& book)
     m_books.erase(bookPosition);
     emit bookDeletionEnded();
 
+    emit bookFileRemoved(bookToDelete.uuid);
     m_libraryStorageManager->deleteBookLocally(std::move(bookToDelete));
 }
 
@@ -22,7 +22,9 @@
 #include "book_dto.hpp"
 #include "book_operation_status.hpp"
 #include "book_service.hpp"
+#include "color_themes.hpp"
 #include "dependency_injection.hpp"
+#include "document_canvas.hpp"
 #include "external_book_controller.hpp"
 #include "folder_dto.hpp"
 #include "free_books_model.hpp"
@@ -31,8 +33,9 @@
 #include "i_user_service.hpp"
 #include "key_sequence_recorder.hpp"
 #include "library_proxy_model.hpp"
+#include "library_search_controller.hpp"
+#include "library_search_service.hpp"
 #include "message_handler.hpp"
-#include "page_view.hpp"
 #include "setting_groups.hpp"
 #include "setting_keys.hpp"
 #include "shortcuts_proxy_model.hpp"
@@ -80,7 +83,15 @@ int main(int argc, char* argv[])
     qmlRegisterType<adapters::data_models::FreeBooksModel>("Librum.models", 1, 0, "FreeBooksModel");
     qmlRegisterType<adapters::data_models::ShortcutsProxyModel>("Librum.models", 1, 0, "ShortcutsProxyModel");
     qmlRegisterType<cpp_elements::KeySequenceRecorder>("Librum.elements", 1, 0, "KeySequenceRecorder");
-    qmlRegisterType<cpp_elements::PageView>("Librum.elements", 1, 0, "PageView");
+    qmlRegisterType<cpp_elements::DocumentCanvas>("Librum.elements", 1, 0, "DocumentCanvas");
+    qmlRegisterSingletonType("Librum.elements", 1, 0, "ColorThemes",
+                             [](QQmlEngine*, QJSEngine* engine) -> QJSValue
+                             {
+                                 auto colorThemes = engine->newObject();
+                                 colorThemes.setProperty("themes", engine->toScriptValue(
+                                     cpp_elements::color_themes::getColorThemesForQml()));
+                                 return colorThemes;
+                             });
     qRegisterMetaType<adapters::dtos::BookDto>();
     qRegisterMetaType<adapters::dtos::TagDto>();
     qRegisterMetaType<adapters::dtos::FolderDto>();
@@ -167,6 +178,12 @@ int main(int argc, char* argv[])
     qmlRegisterSingletonInstance("Librum.controllers", 1, 0, "ToolsController",
                                  toolsController.get());
 
+    // Library Search Stack
+    auto librarySearchService = std::make_unique<application::services::LibrarySearchService>(libraryService);
+    auto librarySearchController = std::make_unique<LibrarySearchController>(librarySearchService.get());
+    qmlRegisterSingletonInstance("Librum.controllers", 1, 0, "LibrarySearchController",
+                                 librarySearchController.get());
+
     // Enums
     qmlRegisterUncreatableMetaObject(application::book_operation_status::staticMetaObject, "Librum.controllers",
                                      1, 0, "BookOperationStatus",
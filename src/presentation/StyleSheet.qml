@@ -96,6 +96,7 @@ Item {
     property color colorDefaultProfilePicture
     property color colorTextSelection
     property color colorScrollBarHandle
+    property color colorScrollBarSearchHit
     property color colorDefaultFolderIcon
     property color colorFolderIconSelection
 
@@ -391,6 +392,10 @@ Item {
                 target: styleSheet
                 colorScrollBarHandle: "#999999"
             }
+            PropertyChanges {
+                target: styleSheet
+                colorScrollBarSearchHit: "#E6B800"
+            }
             PropertyChanges {
                 target: styleSheet
                 colorDefaultFolderIcon: "#78788E"
@@ -688,6 +693,10 @@ Item {
                 target: styleSheet
                 colorScrollBarHandle: "#999999"
             }
+            PropertyChanges {
+                target: styleSheet
+                colorScrollBarSearchHit: "#C9A227"
+            }
             PropertyChanges {
                 target: styleSheet
                 colorDefaultFolderIcon: "#989898"
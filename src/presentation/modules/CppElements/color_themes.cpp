@@ -0,0 +1,117 @@
+#include "color_themes.hpp"
+#include <QVariantMap>
+#include <QVector4D>
+#include <algorithm>
+
+namespace cpp_elements::color_themes
+{
+
+namespace
+{
+
+QList<ColorTheme> createBuiltInColorThemes()
+{
+    // The matrices are given row by row
+    return {
+        ColorTheme {
+            .name = "Normal",
+            .label = QT_TRANSLATE_NOOP("ColorThemes", "Normal"),
+            .colorMatrix = QMatrix4x4(),
+        },
+        ColorTheme {
+            .name = "Sepia",
+            .label = QT_TRANSLATE_NOOP("ColorThemes", "Sepia"),
+            .colorMatrix = QMatrix4x4(0.393, 0.769, 0.189, 0,  //
+                                      0.349, 0.686, 0.168, 0,  //
+                                      0.272, 0.534, 0.131, 0,  //
+                                      0, 0, 0, 1),
+        },
+        ColorTheme {
+            .name = "Dimmed",
+            .label = QT_TRANSLATE_NOOP("ColorThemes", "Dimmed"),
+            .colorMatrix = QMatrix4x4(0.75, 0, 0, 0,  //
+                                      0, 0.72, 0, 0,  //
+                                      0, 0, 0.65, 0,  //
+                                      0, 0, 0, 1),
+        },
+        ColorTheme {
+            .name = "Inverted",
+            .label = QT_TRANSLATE_NOOP("ColorThemes", "Inverted"),
+            .colorMatrix = QMatrix4x4(-1, 0, 0, 1,  //
+                                      0, -1, 0, 1,  //
+                                      0, 0, -1, 1,  //
+                                      0, 0, 0, 1),
+        },
+    };
+}
+
+QList<ColorTheme>& colorThemes()
+{
+    static QList<ColorTheme> themes = createBuiltInColorThemes();
+    return themes;
+}
+
+QColor applyColorMatrix(const QMatrix4x4& colorMatrix, qreal value)
+{
+    // Same as the shader does, the result is clamped to valid colors
+    auto color = colorMatrix.map(QVector4D(value, value, value, 1));
+    return QColor::fromRgbF(std::clamp(color.x(), 0.0f, 1.0f),
+                            std::clamp(color.y(), 0.0f, 1.0f),
+                            std::clamp(color.z(), 0.0f, 1.0f));
+}
+
+}  // namespace
+
+void registerColorTheme(const ColorTheme& colorTheme)
+{
+    auto& themes = colorThemes();
+    auto existingTheme = std::ranges::find(themes, colorTheme.name,
+                                           &ColorTheme::name);
+    if(existingTheme != themes.end())
+        *existingTheme = colorTheme;
+    else
+        themes.append(colorTheme);
+}
+
+const QList<ColorTheme>& getColorThemes()
+{
+    return colorThemes();
+}
+
+QMatrix4x4 getColorMatrix(const QString& themeName)
+{
+    auto& themes = colorThemes();
+    auto theme = std::ranges::find(themes, themeName, &ColorTheme::name);
+    if(theme == themes.end())
+        return QMatrix4x4();
+
+    return theme->colorMatrix;
+}
+
+QColor getBackgroundColor(const ColorTheme& colorTheme)
+{
+    return applyColorMatrix(colorTheme.colorMatrix, 1);
+}
+
+QColor getForegroundColor(const ColorTheme& colorTheme)
+{
+    return applyColorMatrix(colorTheme.colorMatrix, 0);
+}
+
+QVariantList getColorThemesForQml()
+{
+    QVariantList result;
+    for(auto& theme : colorThemes())
+    {
+        result.append(QVariantMap {
+            { "name", theme.name },
+            { "label", theme.label },
+            { "background", getBackgroundColor(theme) },
+            { "foreground", getForegroundColor(theme) },
+        });
+    }
+
+    return result;
+}
+
+}  // namespace cpp_elements::color_themes
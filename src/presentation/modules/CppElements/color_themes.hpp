@@ -0,0 +1,58 @@
+#pragma once
+#include <QColor>
+#include <QList>
+#include <QMatrix4x4>
+#include <QString>
+#include <QVariantList>
+
+namespace cpp_elements::color_themes
+{
+
+/**
+ * Color themes are applied to the rendered pages by a shader, which multiplies
+ * each pixel's color (r, g, b, 1) with the theme's color matrix. The last
+ * column of the matrix is thus added to the color as an offset.
+ *
+ * The name identifies the theme, e.g. in a book's settings. The label is
+ * shown to the user and translated in the "ColorThemes" context.
+ */
+struct ColorTheme
+{
+    QString name;
+    QString label;
+    QMatrix4x4 colorMatrix;
+};
+
+/**
+ * Adds a theme to the ones the user can choose from, or replaces the theme
+ * with the same name. Themes need to be registered before the QML engine is
+ * loaded, since the theme selector reads them only once.
+ */
+void registerColorTheme(const ColorTheme& colorTheme);
+
+/**
+ * The built-in themes ("Normal", "Sepia", "Dimmed" and "Inverted") followed
+ * by the registered ones.
+ */
+const QList<ColorTheme>& getColorThemes();
+
+/**
+ * Returns the color matrix for the theme with the given name, unknown themes
+ * fall back to "Normal".
+ */
+QMatrix4x4 getColorMatrix(const QString& themeName);
+
+/**
+ * The colors that white and black are shown in with the theme, e.g. to
+ * preview it.
+ */
+QColor getBackgroundColor(const ColorTheme& colorTheme);
+QColor getForegroundColor(const ColorTheme& colorTheme);
+
+/**
+ * The themes in the form the QML theme selector expects them, a list of maps
+ * with a name, a label, a background and a foreground.
+ */
+QVariantList getColorThemesForQml();
+
+}  // namespace cpp_elements::color_themes
@@ -0,0 +1,1206 @@
+#include "document_canvas.hpp"
+#include <QClipboard>
+#include <QDebug>
+#include <QGuiApplication>
+#include <QQuickWindow>
+#include <QRectF>
+#include <QtWidgets/QApplication>
+#include <algorithm>
+#include <limits>
+#include "color_themes.hpp"
+#include "document_node.hpp"
+#include "fz_utils.hpp"
+#include "highlight.hpp"
+#include "page_controller.hpp"
+
+using adapters::IBookController;
+using adapters::controllers::PageController;
+using domain::entities::Highlight;
+using namespace application::core;
+
+namespace cpp_elements
+{
+
+DocumentCanvas::DocumentCanvas()
+{
+    setFlag(QQuickItem::ItemHasContents, true);
+    setFlag(QQuickItem::ItemIsFocusScope, true);
+    setAcceptedMouseButtons(Qt::AllButtons);
+    setAcceptHoverEvents(true);
+    setClip(true);
+
+    m_tripleClickTimer.setInterval(400);
+    m_tripleClickTimer.setSingleShot(true);
+
+    // While zooming, the current images are just scaled to the new size. They
+    // are only rendered again once the zoom did not change for a moment.
+    m_zoomSettleTimer.setInterval(150);
+    m_zoomSettleTimer.setSingleShot(true);
+    connect(&m_zoomSettleTimer, &QTimer::timeout, this,
+            &DocumentCanvas::requestPageImages);
+
+    // Pages are rendered in draft quality while scrolling fast, they are
+    // rendered again in full quality once the scrolling slowed down.
+    m_scrollSettleTimer.setInterval(150);
+    m_scrollSettleTimer.setSingleShot(true);
+    connect(&m_scrollSettleTimer, &QTimer::timeout, this,
+            [this]()
+            {
+                m_scrollingFast = false;
+                requestPageImages();
+            });
+}
+
+void DocumentCanvas::setBookController(IBookController* newBookController)
+{
+    m_bookController = newBookController;
+    m_zoom = m_bookController->getZoom();
+    m_bookController->setDevicePixelRatio(getDevicePixelRatio());
+
+    connect(m_bookController, &IBookController::zoomChanged, this,
+            &DocumentCanvas::updateZoom);
+    connect(m_bookController, &IBookController::goToPosition, this,
+            &DocumentCanvas::goToPosition);
+    connect(m_bookController, &IBookController::selectText, this,
+            &DocumentCanvas::selectText);
+    connect(m_bookController, &IBookController::pageGeometryChanged, this,
+            &DocumentCanvas::updatePageGeometry);
+    connect(m_bookController, &IBookController::searchHitsChanged, this,
+            &QQuickItem::update);
+    connect(m_bookController, &IBookController::loadingFinished, this,
+            &DocumentCanvas::showLoadedBook);
+
+    polish();
+}
+
+qreal DocumentCanvas::getContentX() const
+{
+    return m_contentX;
+}
+
+void DocumentCanvas::setContentX(qreal newContentX)
+{
+    auto maxContentX = qMax(0.0, m_contentWidth - width());
+    newContentX = qBound(0.0, newContentX, maxContentX);
+    if(newContentX == m_contentX)
+        return;
+
+    m_contentX = newContentX;
+    emit contentXChanged();
+
+    polish();
+    update();
+}
+
+qreal DocumentCanvas::getContentY() const
+{
+    return m_contentY;
+}
+
+void DocumentCanvas::setContentY(qreal newContentY)
+{
+    auto oldContentY = m_contentY;
+    moveContentY(newContentY);
+    updateScrollSpeed(m_contentY - oldContentY);
+}
+
+void DocumentCanvas::moveContentY(qreal newContentY)
+{
+    auto maxContentY = qMax(0.0, m_contentHeight - height());
+    newContentY = qBound(0.0, newContentY, maxContentY);
+    if(newContentY == m_contentY)
+        return;
+
+    m_contentY = newContentY;
+    emit contentYChanged();
+
+    updateCurrentPage();
+    polish();
+    update();
+}
+
+qreal DocumentCanvas::getContentWidth() const
+{
+    return m_contentWidth;
+}
+
+qreal DocumentCanvas::getContentHeight() const
+{
+    return m_contentHeight;
+}
+
+int DocumentCanvas::getPageSpacing() const
+{
+    return m_pageSpacing;
+}
+
+void DocumentCanvas::setPageSpacing(int newPageSpacing)
+{
+    if(newPageSpacing == m_pageSpacing)
+        return;
+
+    m_pageSpacing = newPageSpacing;
+    updateLayout();
+}
+
+void DocumentCanvas::setPage(int pageNumber, float yOffset)
+{
+    ensureLayout();
+    if(pageNumber < 0 || pageNumber >= m_pageGeometry.getPageCount())
+        return;
+
+    moveContentY(getPageTop(pageNumber) + yOffset * m_zoom);
+    m_bookController->setCurrentPage(pageNumber);
+}
+
+float DocumentCanvas::getYOffset() const
+{
+    if(m_bookController == nullptr)
+        return 0;
+
+    auto currentPage = m_bookController->getCurrentPage();
+    if(currentPage < 0 || currentPage >= m_pageGeometry.getPageCount())
+        return 0;
+
+    return m_contentY - getPageTop(currentPage);
+}
+
+void DocumentCanvas::updateZoom(float newZoom)
+{
+    auto oldZoom = m_zoom;
+    m_zoom = newZoom;
+
+    for(auto& [pageNumber, page] : m_pageControllers)
+        page->setZoom(newZoom);
+
+    // Update selection positions to match new zoom
+    if(m_selectionPage != -1 && !m_selectionStart.isNull() &&
+       !m_selectionEnd.isNull())
+    {
+        m_selectionStart =
+            utils::scalePointToCurrentZoom(m_selectionStart, oldZoom, newZoom);
+        m_selectionEnd =
+            utils::scalePointToCurrentZoom(m_selectionEnd, oldZoom, newZoom);
+
+        auto page = getPageController(m_selectionPage);
+        if(page != nullptr)
+            page->generateSelectionRects(m_selectionStart, m_selectionEnd);
+    }
+
+    // Keep the same part of the page at the top of the viewport
+    if(!m_pageGeometry.isEmpty())
+    {
+        auto anchorPage = getPageAtY(m_contentY);
+        auto offset = (m_contentY - getPageTop(anchorPage)) / oldZoom;
+        updateLayout();
+
+        setContentX(m_contentX * newZoom / oldZoom);
+        moveContentY(getPageTop(anchorPage) + offset * newZoom);
+    }
+
+    m_zoomSettleTimer.start();
+    update();
+}
+
+void DocumentCanvas::goToPosition(int pageNumber, int y)
+{
+    auto page = getPageController(pageNumber);
+    if(page == nullptr)
+        return;
+
+    setPage(pageNumber, y - page->getYOffset());
+}
+
+void DocumentCanvas::selectText(int pageNumber, QPointF left, QPointF right)
+{
+    auto page = getPageController(pageNumber);
+    if(page == nullptr)
+        return;
+
+    if(pageNumber != m_selectionPage)
+        removeSelection();
+    m_selectionPage = pageNumber;
+
+    auto xOffset = page->getXOffset();
+    auto yOffset = page->getYOffset();
+    left = QPoint(left.x() - xOffset, left.y() - yOffset);
+    right = QPoint(right.x() - xOffset, right.y() - yOffset);
+
+    // The points received from this signal are relative to a zoom of 1, but
+    // all of the methods in this class handle points as if they have the
+    // current zoom applied, so we need to scale them.
+    left = utils::scalePointToCurrentZoom(left, 1, m_zoom);
+    right = utils::scalePointToCurrentZoom(right, 1, m_zoom);
+
+    m_selectionStart = left;
+    m_selectionEnd = right;
+
+    createSelection();
+}
+
+void DocumentCanvas::geometryChange(const QRectF& newGeometry,
+                                    const QRectF& oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if(newGeometry.size() == oldGeometry.size())
+        return;
+
+    // The pages are centered horizontally and more or fewer of them fit into
+    // the viewport now.
+    clampContentPosition();
+    updateCurrentPage();
+    polish();
+    update();
+}
+
+void DocumentCanvas::itemChange(ItemChange change, const ItemChangeData& data)
+{
+    if(change == ItemSceneChange && data.window != nullptr &&
+       m_bookController != nullptr)
+    {
+        m_bookController->setDevicePixelRatio(data.window->devicePixelRatio());
+    }
+
+    if(change == ItemSceneChange || change == ItemVisibleHasChanged)
+        polish();
+
+    QQuickItem::itemChange(change, data);
+}
+
+void DocumentCanvas::updatePolish()
+{
+    updateActivePages();
+    requestPageImages();
+}
+
+QSGNode* DocumentCanvas::updatePaintNode(QSGNode* node,
+                                         UpdatePaintNodeData* nodeData)
+{
+    Q_UNUSED(nodeData);
+
+    auto documentNode = static_cast<DocumentNode*>(node);
+    if(!documentNode)
+        documentNode = new DocumentNode();
+
+    auto dpr = window()->devicePixelRatio();
+    QRectF viewport(m_contentX, m_contentY, width(), height());
+
+    documentNode->beginUpdate();
+    for(auto& [pageNumber, page] : m_pageControllers)
+    {
+        // Until a page was rendered for the first time, there is nothing to
+        // show. Afterwards, the last rendered image is shown (scaled to the
+        // current size) until the new one arrives from the render workers.
+        auto pageRect = getPageRect(pageNumber);
+        auto& image = page->getPageImage();
+        if(image.isNull() || !pageRect.intersects(viewport))
+            continue;
+
+        auto pageNode = documentNode->getPageNode(
+            pageNumber, pageRect.topLeft() - viewport.topLeft());
+        pageNode->setColorMatrix(m_colorMatrix);
+        pageNode->setPageImage(window(), image,
+                               QRectF(QPointF(0, 0), pageRect.size()));
+
+        QList<PageNodeTile> tiles;
+        for(auto& tile : page->getTiles())
+        {
+            if(tile.image.isNull())
+                continue;
+
+            QRectF tileRect(QPointF(tile.rect.topLeft()) / dpr,
+                            QSizeF(tile.rect.size()) / dpr);
+            tiles.append({ tile.image, tileRect });
+        }
+        pageNode->setTiles(window(), tiles);
+
+        // The search hits only change the overlay's vertices, so all hits of
+        // the visible pages are shown, not just the current one.
+        auto overlayRects = getHighlightOverlayRects(pageNumber);
+        overlayRects.append(getSearchHitOverlayRects(pageNumber));
+        pageNode->setHighlightRects(overlayRects);
+        pageNode->setSelectionRects(getSelectionOverlayRects(pageNumber));
+    }
+    documentNode->endUpdate();
+
+    return documentNode;
+}
+
+void DocumentCanvas::mouseDoubleClickEvent(QMouseEvent* event)
+{
+    if(event->button() == Qt::RightButton)
+        return;
+
+    if(m_startedMousePressOnHighlight || m_pressedPage == -1)
+        return;
+
+    auto point = mapToPage(m_pressedPage, event->position());
+    m_selectionPage = m_pressedPage;
+    m_selectionStart = point;
+    m_selectionEnd = point;
+    selectSingleWord();
+
+    m_tripleClickTimer.start();
+    m_doubleClickHold = true;
+}
+
+void DocumentCanvas::mousePressEvent(QMouseEvent* event)
+{
+    if(event->button() == Qt::RightButton)
+        return;
+
+    forceActiveFocus();
+
+    m_pressedPage = getPageAtPoint(event->position());
+    if(m_pressedPage == -1)
+        return;
+
+    auto page = getPageController(m_pressedPage);
+    if(page == nullptr)
+    {
+        m_pressedPage = -1;
+        return;
+    }
+
+    auto point = mapToPage(m_pressedPage, event->position());
+    if(page->pointIsAboveLink(point))
+        m_startedMousePressOnLink = true;
+
+    auto highlight =
+        m_bookController->getHighlightAtPoint(point, m_pressedPage);
+    if(highlight != nullptr)
+    {
+        handleClickingOnHighlight(m_pressedPage, highlight);
+        return;
+    }
+    m_startedMousePressOnHighlight = false;
+
+    // There is only a single selection, so starting one on another page
+    // removes the old one.
+    if(m_pressedPage != m_selectionPage)
+        removeSelection();
+    m_selectionPage = m_pressedPage;
+
+    // Select line when left mouse button is pressed 3 times
+    if(m_tripleClickTimer.isActive())
+    {
+        selectLine();
+        return;
+    }
+
+    m_selectionStart = point;
+}
+
+void DocumentCanvas::handleClickingOnHighlight(int pageNumber,
+                                               const Highlight* highlight)
+{
+    // Scale the highlight rects (initially zoom of 1) to the current zoom and
+    // get the center x and bottom y position of the highlight.
+    auto rects = highlight->getRects();
+    QList<QRectF> qRects;
+    qRects.reserve(rects.size());
+    for(auto& rect : rects)
+    {
+        auto qRectF = rect.getQRect();
+        utils::scaleQRectFToZoom(qRectF, m_zoom);
+        qRects.append(qRectF);
+    }
+    auto positions = getCenterXAndBottomYFromRects(qRects);
+    auto position =
+        mapFromPage(pageNumber, QPointF(positions.first, positions.second));
+
+    auto uuidAsString = highlight->getUuid().toString(QUuid::WithoutBraces);
+    m_bookController->highlightSelected(position.x(), position.y(),
+                                        uuidAsString);
+    m_startedMousePressOnHighlight = true;
+}
+
+void DocumentCanvas::mouseReleaseEvent(QMouseEvent* event)
+{
+    if(m_pressedPage == -1)
+        return;
+
+    auto page = getPageController(m_pressedPage);
+    if(page == nullptr)
+    {
+        m_startedMousePressOnLink = false;
+        m_doubleClickHold = false;
+        m_pressedPage = -1;
+        return;
+    }
+
+    auto point = mapToPage(m_pressedPage, event->position());
+    if(m_startedMousePressOnLink && page->pointIsAboveLink(point))
+    {
+        auto uri = page->getLinkUriAtPoint(point);
+        m_bookController->followLink(uri);
+    }
+    m_startedMousePressOnLink = false;
+
+    // This gets triggered when the user simply clicks on the page, without
+    // dragging the mouse, so on a normal click. In this case we want to
+    // reset the selection.
+    if(m_selectionStart == point && !m_tripleClickTimer.isActive())
+    {
+        removeSelection();
+
+        // Restart it since some actions are checking if it is active to e.g.
+        // prevent removing the line select on mouse release
+        m_tripleClickTimer.start();
+    }
+    else if(!m_startedMousePressOnHighlight)
+    {
+        auto rects = page->getBufferedSelectionRects();
+        QList<QRectF> restoredRects;
+        restoredRects.reserve(rects.size());
+        for(auto rect : rects)
+        {
+            utils::restoreQRect(rect, page->getZoom());
+            utils::scaleQRectFToZoom(rect, m_zoom);
+            restoredRects.push_back(rect);
+        }
+
+        auto positions = getCenterXAndBottomYFromRects(restoredRects);
+        auto position = mapFromPage(m_pressedPage,
+                                    QPointF(positions.first, positions.second));
+
+        emit m_bookController->textSelectionFinished(position.x(),
+                                                     position.y());
+    }
+
+    m_doubleClickHold = false;
+    m_pressedPage = -1;
+}
+
+QPair<float, float> DocumentCanvas::getCenterXAndBottomYFromRects(
+    const QList<QRectF>& rects)
+{
+    float mostLeftX = std::numeric_limits<float>::max();
+    float mostRightX = 0;
+    float bottomY = 0;
+    for(auto& rect : rects)
+    {
+        if(rect.x() < mostLeftX)
+            mostLeftX = rect.x();
+
+        if(rect.x() + rect.width() > mostRightX)
+            mostRightX = rect.x() + rect.width();
+
+        if(rect.bottom() > bottomY)
+            bottomY = rect.bottom();
+    }
+
+    auto centerX = (mostLeftX + mostRightX) / 2;
+    return { centerX, bottomY };
+}
+
+void DocumentCanvas::mouseMoveEvent(QMouseEvent* event)
+{
+    if(event->buttons() == Qt::RightButton)
+        return;
+
+    if(m_startedMousePressOnHighlight || m_pressedPage == -1)
+        return;
+
+    // 'hoverMoveEvent' is not triggered when the left mouse button is pressed,
+    // thus the cursor will not change correctly. Make sure to handle it here.
+    setCorrectCursor(event->position());
+
+    m_selectionEnd = mapToPage(m_pressedPage, event->position());
+    if(m_doubleClickHold)
+        selectMultipleWords();
+    else
+        createSelection();
+}
+
+void DocumentCanvas::hoverMoveEvent(QHoverEvent* event)
+{
+    setCorrectCursor(event->position());
+
+    emit mouseHoverMoved();
+}
+
+void DocumentCanvas::keyPressEvent(QKeyEvent* event)
+{
+    if(event->key() == Qt::Key_C && event->modifiers() == Qt::ControlModifier)
+    {
+        copySelectedText();
+    }
+}
+
+void DocumentCanvas::hoverLeaveEvent(QHoverEvent* event)
+{
+    m_hoveredLinkUri.clear();
+    resetCursorToDefault();
+}
+
+void DocumentCanvas::ensureLayout()
+{
+    if(!m_pageGeometry.isEmpty() || m_bookController == nullptr)
+        return;
+
+    // The book's document is still being loaded in the background
+    if(m_bookController->getFzDocument() == nullptr)
+        return;
+
+    // The exact page sizes are loaded in the background when the book is
+    // opened. Until they are known, all pages are assumed to have the same
+    // size as the page the book was opened at.
+    m_pageGeometry = m_bookController->getPageGeometry();
+    if(m_pageGeometry.isEmpty())
+    {
+        auto pageCount = m_bookController->getPageCount();
+        if(pageCount <= 0)
+            return;
+
+        auto currentPage =
+            qBound(0, m_bookController->getCurrentPage(), pageCount - 1);
+        auto page = createPageController(currentPage);
+        m_pageGeometry =
+            PageGeometry(QList<QSize>(pageCount, page->getPageSize()));
+    }
+
+    updateLayout();
+}
+
+void DocumentCanvas::showLoadedBook()
+{
+    // Nothing could be shown while the book was loading, start out at the
+    // page the book was opened at.
+    if(m_pageGeometry.isEmpty())
+        setPage(m_bookController->getCurrentPage());
+}
+
+void DocumentCanvas::updatePageGeometry()
+{
+    if(m_pageGeometry.isEmpty())
+    {
+        ensureLayout();
+        return;
+    }
+
+    // Keep the page at the top of the viewport in place while the estimated
+    // page sizes are replaced with the exact ones.
+    auto anchorPage = getPageAtY(m_contentY);
+    auto offset = (m_contentY - getPageTop(anchorPage)) / m_zoom;
+
+    m_pageGeometry = m_bookController->getPageGeometry();
+    updateLayout();
+
+    moveContentY(getPageTop(anchorPage) + offset * m_zoom);
+}
+
+void DocumentCanvas::updateLayout()
+{
+    m_contentWidth = m_pageGeometry.getMaxPageWidth() * m_zoom;
+    m_contentHeight = m_pageGeometry.getContentHeight(m_zoom, m_pageSpacing);
+    emit layoutChanged();
+
+    clampContentPosition();
+    polish();
+    update();
+}
+
+void DocumentCanvas::updatePageSize(int pageNumber, const QSize& pageSize)
+{
+    if(m_pageGeometry.getPageSize(pageNumber) == pageSize)
+        return;
+
+    // The page's real size differs from the estimated one. Keep the page at
+    // the top of the viewport in place while the pages below it move.
+    auto anchorPage = getPageAtY(m_contentY);
+    auto offset = m_contentY - getPageTop(anchorPage);
+
+    m_pageGeometry.setPageSize(pageNumber, pageSize);
+    updateLayout();
+
+    moveContentY(getPageTop(anchorPage) + offset);
+}
+
+qreal DocumentCanvas::getPageTop(int pageNumber) const
+{
+    return m_pageGeometry.getPageTop(pageNumber, m_zoom, m_pageSpacing);
+}
+
+QRectF DocumentCanvas::getPageRect(int pageNumber) const
+{
+    auto size = QSizeF(m_pageGeometry.getPageSize(pageNumber)) * m_zoom;
+    auto x = (qMax(width(), m_contentWidth) - size.width()) / 2;
+
+    return QRectF(QPointF(x, getPageTop(pageNumber)), size);
+}
+
+int DocumentCanvas::getPageAtY(qreal y) const
+{
+    return m_pageGeometry.getPageAtY(y, m_zoom, m_pageSpacing);
+}
+
+int DocumentCanvas::getPageAtPoint(const QPointF& point) const
+{
+    if(m_pageGeometry.isEmpty())
+        return -1;
+
+    QPointF contentPoint(point.x() + m_contentX, point.y() + m_contentY);
+    auto pageNumber = getPageAtY(contentPoint.y());
+
+    // The point might be in the spacing between two pages or next to a page
+    if(!getPageRect(pageNumber).contains(contentPoint))
+        return -1;
+
+    return pageNumber;
+}
+
+QPointF DocumentCanvas::mapToPage(int pageNumber, const QPointF& point) const
+{
+    return point + QPointF(m_contentX, m_contentY) -
+           getPageRect(pageNumber).topLeft();
+}
+
+QPointF DocumentCanvas::mapFromPage(int pageNumber, const QPointF& point) const
+{
+    return point + getPageRect(pageNumber).topLeft() -
+           QPointF(m_contentX, m_contentY);
+}
+
+void DocumentCanvas::clampContentPosition()
+{
+    // The setters clamp the positions to the content's bounds
+    setContentX(m_contentX);
+    moveContentY(m_contentY);
+}
+
+void DocumentCanvas::updateScrollSpeed(qreal scrolledPixels)
+{
+    qreal elapsedSeconds = 0;
+    if(m_scrollTimer.isValid())
+        elapsedSeconds = m_scrollTimer.restart() / 1000.0;
+    else
+        m_scrollTimer.start();
+
+    // A pause between two scroll steps starts a new scroll movement
+    if(elapsedSeconds <= 0 || elapsedSeconds > 0.25)
+    {
+        m_scrollSpeed = 0;
+        return;
+    }
+
+    // The time between two scroll steps varies, so smooth the speed a bit
+    auto speed = qAbs(scrolledPixels) / elapsedSeconds;
+    m_scrollSpeed = (m_scrollSpeed + speed) / 2;
+    if(m_scrollSpeed < m_fastScrollSpeed * height())
+        return;
+
+    m_scrollingFast = true;
+    m_scrollSettleTimer.start();
+}
+
+void DocumentCanvas::updateCurrentPage()
+{
+    if(m_bookController == nullptr || m_pageGeometry.isEmpty())
+        return;
+
+    // A new page starts if it is over the middle of the screen (vertically).
+    auto middleOfScreen = m_contentY + height() / 2;
+    auto pageNumber = getPageAtY(middleOfScreen);
+
+    // If the middle of the screen is in the free space between two pages,
+    // take the lower one
+    auto pageRect = getPageRect(pageNumber);
+    if(middleOfScreen > pageRect.bottom() &&
+       pageNumber < m_pageGeometry.getPageCount() - 1)
+    {
+        ++pageNumber;
+    }
+
+    if(pageNumber != m_bookController->getCurrentPage())
+        m_bookController->setCurrentPage(pageNumber);
+}
+
+PageController* DocumentCanvas::getPageController(int pageNumber)
+{
+    ensureLayout();
+    if(pageNumber < 0 || pageNumber >= m_pageGeometry.getPageCount())
+        return nullptr;
+
+    auto it = m_pageControllers.find(pageNumber);
+    if(it != m_pageControllers.end())
+        return it->second.get();
+
+    return createPageController(pageNumber);
+}
+
+PageController* DocumentCanvas::createPageController(int pageNumber)
+{
+    auto page = std::make_unique<PageController>(
+        m_bookController->getFzDocument(),
+        m_bookController->getRenderScheduler(),
+        m_bookController->getRenderCache(),
+        m_bookController->getTextPageCache(), pageNumber,
+        getDevicePixelRatio());
+    page->setZoom(m_zoom);
+
+    connect(page.get(), &PageController::pageImageChanged, this,
+            &DocumentCanvas::update);
+
+    auto pagePtr = page.get();
+    m_pageControllers[pageNumber] = std::move(page);
+
+    if(!m_pageGeometry.isEmpty())
+        updatePageSize(pageNumber, pagePtr->getPageSize());
+
+    return pagePtr;
+}
+
+void DocumentCanvas::updateActivePages()
+{
+    ensureLayout();
+    if(m_pageGeometry.isEmpty())
+        return;
+
+    // Loading a page reveals its real size, which moves the pages below it.
+    // So repeat until the range of pages around the viewport is stable.
+    int firstPage = -1;
+    int lastPage = -1;
+    for(int attempt = 0; attempt < 3; ++attempt)
+    {
+        auto newFirstPage = getPageAtY(m_contentY - m_cacheBuffer);
+        auto newLastPage = getPageAtY(m_contentY + height() + m_cacheBuffer);
+        if(newFirstPage == firstPage && newLastPage == lastPage)
+            break;
+
+        firstPage = newFirstPage;
+        lastPage = newLastPage;
+        for(int i = firstPage; i <= lastPage; ++i)
+        {
+            if(!m_pageControllers.contains(i))
+                createPageController(i);
+        }
+    }
+
+    // The pages that are interacted with are kept, even if out of range
+    std::erase_if(m_pageControllers,
+                  [&](const auto& entry)
+                  {
+                      auto pageNumber = entry.first;
+                      bool inRange =
+                          pageNumber >= firstPage && pageNumber <= lastPage;
+                      return !inRange && pageNumber != m_selectionPage &&
+                             pageNumber != m_pressedPage;
+                  });
+}
+
+void DocumentCanvas::requestPageImages()
+{
+    if(m_zoomSettleTimer.isActive())
+        return;
+
+    QRectF viewport(m_contentX, m_contentY, width(), height());
+    if(!isVisible())
+        viewport = QRectF();
+
+    auto quality =
+        m_scrollingFast ? RenderQuality::Draft : RenderQuality::Full;
+
+    for(auto& [pageNumber, page] : m_pageControllers)
+    {
+        auto pageRect = getPageRect(pageNumber);
+        auto visibleArea = pageRect.intersected(viewport);
+        if(!visibleArea.isEmpty())
+            visibleArea.translate(-pageRect.topLeft());
+
+        page->setVisibleArea(visibleArea);
+        if(!page->pageImageIsOutdated())
+            continue;
+
+        page->requestPageImage(!visibleArea.isEmpty(), quality);
+    }
+}
+
+double DocumentCanvas::getDevicePixelRatio() const
+{
+    if(window() != nullptr)
+        return window()->devicePixelRatio();
+
+    return qGuiApp->devicePixelRatio();
+}
+
+QList<OverlayRect> DocumentCanvas::getSelectionOverlayRects(
+    int pageNumber) const
+{
+    if(pageNumber != m_selectionPage)
+        return {};
+
+    // The selection rects are in device pixels, but the nodes are positioned
+    // in logical pixels.
+    auto dpr = window()->devicePixelRatio();
+    QColor selectionColor(134, 171, 175, 125);
+
+    QList<OverlayRect> overlayRects;
+    auto& page = m_pageControllers.at(pageNumber);
+    for(auto& rect : page->getBufferedSelectionRects())
+    {
+        QRectF scaledRect(rect.topLeft() / dpr, rect.size() / dpr);
+        overlayRects.append({ scaledRect, selectionColor });
+    }
+
+    return overlayRects;
+}
+
+QList<OverlayRect> DocumentCanvas::getHighlightOverlayRects(
+    int pageNumber) const
+{
+    QList<OverlayRect> overlayRects;
+    for(auto highlight : m_bookController->getHighlightsOfPage(pageNumber))
+    {
+        for(auto& rect : highlight->getRects())
+        {
+            // We store the highlights zoom independent, so we need to scale
+            // them to the current zoom here.
+            auto qRect = rect.getQRect();
+            utils::scaleQRectFToZoom(qRect, m_zoom);
+
+            overlayRects.append({ qRect, highlight->getColor() });
+        }
+    }
+
+    return overlayRects;
+}
+
+QList<OverlayRect> DocumentCanvas::getSearchHitOverlayRects(
+    int pageNumber) const
+{
+    QColor searchHitColor(255, 214, 0, 110);
+
+    auto& page = m_pageControllers.at(pageNumber);
+    QPoint pageOffset(page->getXOffset(), page->getYOffset());
+
+    QList<OverlayRect> overlayRects;
+    auto& searchHits = m_bookController->getSearchHits();
+    for(auto& rect : searchHits.getPageHitRects(pageNumber, pageOffset, m_zoom))
+        overlayRects.append({ rect, searchHitColor });
+
+    return overlayRects;
+}
+
+void DocumentCanvas::removeConflictingHighlights(Highlight& highlight)
+{
+    bool existingHighlightRemoved = false;
+
+    auto& highlights = m_bookController->getHighlights();
+    for(int i = 0; i < highlights.size(); ++i)
+    {
+        auto& existingHighlight = highlights[i];
+        if(existingHighlight.getPageNumber() != highlight.getPageNumber())
+            continue;
+
+        for(int u = 0; u < highlight.getRects().size(); ++u)
+        {
+            auto rect = highlight.getRects()[u].getQRect();
+
+            for(int k = 0; k < existingHighlight.getRects().size(); ++k)
+            {
+                auto existingRect = existingHighlight.getRects()[k].getQRect();
+
+                // New rect intersects with old rect
+                if(rect.intersects(existingRect))
+                {
+                    // Make sure that the rects are on the same line. Depending
+                    // on the line height, lines above eachother will overlap,
+                    // but its only an intersect when they are on the same line.
+                    bool onSameLine = rectsAreOnSameLine(existingRect, rect);
+                    if(onSameLine)
+                    {
+                        auto uuid = highlights[i].getUuid();
+                        m_bookController->removeHighlight(uuid);
+                        --i;
+                        existingHighlightRemoved = true;
+                        break;
+                    }
+                }
+            }
+
+            if(existingHighlightRemoved)
+            {
+                existingHighlightRemoved = false;
+                break;
+            }
+        }
+    }
+}
+
+QString DocumentCanvas::createHighlightFromCurrentSelection(const QString& hex,
+                                                            int alpha)
+{
+    auto page = getPageController(m_selectionPage);
+    if(page == nullptr)
+        return QString();
+
+    auto bufferedSelectionRects = page->getBufferedSelectionRects();
+
+    // Make sure to restore the rects to their original size, since we want to
+    // store them, so they need to be zoom independent.
+    for(auto& rect : bufferedSelectionRects)
+    {
+        utils::restoreQRect(rect, page->getZoom());
+    }
+
+    auto pageNumber = m_selectionPage;
+    removeSelection();
+
+    auto color = QColor(hex);
+    color.setAlpha(alpha);
+    auto rects = bufferedSelectionRects;
+    Highlight highlight(pageNumber, color);
+    highlight.setRects(rects);
+
+    removeConflictingHighlights(highlight);
+    m_bookController->addHighlight(highlight);
+
+    update();
+    return highlight.getUuid().toString(QUuid::WithoutBraces);
+}
+
+void DocumentCanvas::removeHighlight(const QString& uuid)
+{
+    m_bookController->removeHighlight(QUuid(uuid));
+
+    update();
+}
+
+void DocumentCanvas::changeHighlightColor(const QString& uuid,
+                                          const QString& color, int alpha)
+{
+    QColor newColor(color);
+    newColor.setAlpha(alpha);
+
+    m_bookController->changeHighlightColor(QUuid(uuid), newColor);
+
+    update();
+}
+
+void DocumentCanvas::copyHighlightedText(const QString& uuid)
+{
+    auto text = getHighlightedText(uuid);
+
+    auto clipboard = QApplication::clipboard();
+    clipboard->setText(text);
+}
+
+QString DocumentCanvas::getSelectedText()
+{
+    auto page = getPageController(m_selectionPage);
+    if(page == nullptr)
+        return QString();
+
+    return page->getTextFromSelection(m_selectionStart, m_selectionEnd);
+}
+
+QString DocumentCanvas::getHighlightedText(const QString& uuid)
+{
+    const Highlight* highlight = nullptr;
+    for(auto& h : m_bookController->getHighlights())
+    {
+        if(h.getUuid() == QUuid(uuid))
+        {
+            highlight = &h;
+            break;
+        }
+    }
+
+    if(highlight == nullptr)
+        return QString();
+
+    auto page = getPageController(highlight->getPageNumber());
+    if(page == nullptr)
+        return QString();
+
+    QPointF start(highlight->getRects().first().getQRect().left(),
+                  highlight->getRects().first().getQRect().center().y());
+
+    QPointF end(highlight->getRects().last().getQRect().right(),
+                highlight->getRects().last().getQRect().center().y());
+
+    start = utils::scalePointToCurrentZoom(start, 1, m_zoom);
+    end = utils::scalePointToCurrentZoom(end, 1, m_zoom);
+
+    return page->getTextFromSelection(start, end);
+}
+
+void DocumentCanvas::setPointingCursor()
+{
+    if(QApplication::overrideCursor() == nullptr ||
+       *QApplication::overrideCursor() != Qt::PointingHandCursor)
+    {
+        resetCursorToDefault();
+        QApplication::setOverrideCursor(Qt::PointingHandCursor);
+    }
+}
+
+void DocumentCanvas::createSelection()
+{
+    auto page = getPageController(m_selectionPage);
+    if(page == nullptr)
+        return;
+
+    page->generateSelectionRects(m_selectionStart, m_selectionEnd);
+    update();
+}
+
+void DocumentCanvas::removeSelection()
+{
+    auto page = getPageController(m_selectionPage);
+    if(page != nullptr)
+        page->clearBufferedSelectionRects();
+    update();
+
+    m_selectionStart = QPointF(0, 0);
+    m_selectionEnd = QPointF(0, 0);
+}
+
+void DocumentCanvas::selectSingleWord()
+{
+    auto page = getPageController(m_selectionPage);
+    if(page == nullptr)
+        return;
+
+    auto points = page->getPositionsForWordSelection(m_selectionStart,
+                                                     m_selectionEnd);
+
+    m_selectionStart = points.first;
+    m_selectionEnd = points.second;
+
+    createSelection();
+}
+
+void DocumentCanvas::selectMultipleWords()
+{
+    auto page = getPageController(m_selectionPage);
+    if(page == nullptr)
+        return;
+
+    auto positions = page->getPositionsForWordSelection(m_selectionStart,
+                                                        m_selectionEnd);
+
+    m_selectionStart = positions.first;
+    m_selectionEnd = positions.second;
+
+    createSelection();
+}
+
+void DocumentCanvas::selectLine()
+{
+    auto page = getPageController(m_selectionPage);
+    if(page == nullptr)
+        return;
+
+    auto positions = page->getPositionsForLineSelection(m_selectionStart);
+
+    m_selectionStart = positions.first;
+    m_selectionEnd = positions.second;
+
+    createSelection();
+}
+
+void DocumentCanvas::copySelectedText()
+{
+    QString text = getSelectedText();
+    if(!m_includeNewLinesInCopiedText)
+    {
+        text.replace("\n", "");
+        text.replace("\r", "");
+    }
+
+    auto clipboard = QApplication::clipboard();
+    clipboard->setText(text);
+}
+
+void DocumentCanvas::resetCursorToDefault()
+{
+    QApplication::restoreOverrideCursor();
+}
+
+void DocumentCanvas::setCorrectCursor(const QPointF& point)
+{
+    auto pageNumber = getPageAtPoint(point);
+    if(pageNumber == -1)
+    {
+        m_hoveredLinkUri.clear();
+        resetCursorToDefault();
+        return;
+    }
+
+    auto page = getPageController(pageNumber);
+    auto pagePoint = mapToPage(pageNumber, point);
+
+    bool isAboveLink = page->pointIsAboveLink(pagePoint);
+    if(isAboveLink)
+        prefetchHoveredLink(page, pagePoint);
+    else
+        m_hoveredLinkUri.clear();
+
+    if(isAboveLink ||
+       m_bookController->getHighlightAtPoint(pagePoint, pageNumber))
+    {
+        setPointingCursor();
+    }
+    else if(page->pointIsAboveText(pagePoint))
+    {
+        if(QApplication::overrideCursor() == nullptr ||
+           *QApplication::overrideCursor() != Qt::IBeamCursor)
+        {
+            resetCursorToDefault();
+            QApplication::setOverrideCursor(Qt::IBeamCursor);
+        }
+    }
+    else
+    {
+        resetCursorToDefault();
+    }
+}
+
+void DocumentCanvas::prefetchHoveredLink(PageController* page,
+                                         const QPointF& point)
+{
+    // Links are likely to be clicked once hovered, so prepare their target
+    auto uri = page->getLinkUriAtPoint(point);
+    if(uri == nullptr || m_hoveredLinkUri == uri)
+        return;
+
+    m_hoveredLinkUri = uri;
+    m_bookController->prefetchLinkTarget(uri);
+}
+
+bool DocumentCanvas::rectsAreOnSameLine(const QRectF& rect1,
+                                        const QRectF& rect2)
+{
+    auto shorterRect = rect1.height() <= rect2.height() ? rect1 : rect2;
+    auto intersectH = rect1.intersected(rect2).height();
+
+    float offsetTolerance = 0.75;
+    bool onSameLine = intersectH >= shorterRect.height() * offsetTolerance;
+
+    return onSameLine;
+}
+
+void DocumentCanvas::setColorTheme(const QString& newColorTheme)
+{
+    // The theme is applied when drawing the pages, so the pages do not need
+    // to be rendered again.
+    m_colorTheme = newColorTheme;
+    updateColorMatrix();
+}
+
+void DocumentCanvas::updateColorMatrix()
+{
+    m_colorMatrix = color_themes::getColorMatrix(m_colorTheme);
+
+    update();
+}
+
+void DocumentCanvas::setIncludeNewLinesInCopiedText(
+    bool newIncludeNewLinesInCopiedText)
+{
+    m_includeNewLinesInCopiedText = newIncludeNewLinesInCopiedText;
+}
+
+}  // namespace cpp_elements
@@ -0,0 +1,203 @@
+#pragma once
+#include <QList>
+#include <QMatrix4x4>
+#include <QPointF>
+#include <QElapsedTimer>
+#include <QQuickItem>
+#include <QString>
+#include <QTimer>
+#include <map>
+#include <memory>
+#include "i_book_controller.hpp"
+#include "layout/page_geometry.hpp"
+#include "overlay_node.hpp"
+#include "page_controller.hpp"
+#include "presentation_export.hpp"
+
+namespace cpp_elements
+{
+
+/**
+ * The DocumentCanvas shows all pages of a book below each other in a single
+ * continuously scrollable view.
+ *
+ * It is one item for the whole document instead of one item per page. It lays
+ * the pages out itself, only keeps PageControllers for the pages in and around
+ * the viewport and draws them into a single scene graph subtree whose page
+ * nodes are recycled. Mouse and keyboard input is hit-tested against the
+ * layout and forwarded to the page below the cursor.
+ *
+ * Qml only binds to the document level properties (e.g. contentY) and calls
+ * the methods operating on the current selection.
+ */
+class PRESENTATION_EXPORT DocumentCanvas : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(adapters::IBookController* bookController WRITE setBookController
+                   CONSTANT)
+    Q_PROPERTY(qreal contentX READ getContentX WRITE setContentX NOTIFY
+                   contentXChanged)
+    Q_PROPERTY(qreal contentY READ getContentY WRITE setContentY NOTIFY
+                   contentYChanged)
+    Q_PROPERTY(qreal contentWidth READ getContentWidth NOTIFY layoutChanged)
+    Q_PROPERTY(qreal contentHeight READ getContentHeight NOTIFY layoutChanged)
+    Q_PROPERTY(int pageSpacing READ getPageSpacing WRITE setPageSpacing NOTIFY
+                   layoutChanged)
+    Q_PROPERTY(QString colorTheme WRITE setColorTheme)
+    Q_PROPERTY(
+        bool includeNewLinesInCopiedText WRITE setIncludeNewLinesInCopiedText)
+
+public:
+    DocumentCanvas();
+
+    void setBookController(adapters::IBookController* newBookController);
+
+    qreal getContentX() const;
+    void setContentX(qreal newContentX);
+    qreal getContentY() const;
+    void setContentY(qreal newContentY);
+    qreal getContentWidth() const;
+    qreal getContentHeight() const;
+
+    int getPageSpacing() const;
+    void setPageSpacing(int newPageSpacing);
+
+    void setColorTheme(const QString& newColorTheme);
+    void setIncludeNewLinesInCopiedText(bool newIncludeNewLinesInCopiedText);
+
+    Q_INVOKABLE void setPage(int pageNumber, float yOffset = 0);
+    Q_INVOKABLE float getYOffset() const;
+    Q_INVOKABLE qreal getPageTop(int pageNumber) const;
+
+    Q_INVOKABLE void copySelectedText();
+    Q_INVOKABLE void copyHighlightedText(const QString& uuid);
+    Q_INVOKABLE QString getSelectedText();
+    Q_INVOKABLE QString getHighlightedText(const QString& uuid);
+
+    Q_INVOKABLE void removeSelection();
+    Q_INVOKABLE void setPointingCursor();
+    Q_INVOKABLE void resetCursorToDefault();
+    Q_INVOKABLE QString createHighlightFromCurrentSelection(const QString& hex,
+                                                            int alpha);
+    Q_INVOKABLE void removeHighlight(const QString& uuid);
+    Q_INVOKABLE void changeHighlightColor(const QString& uuid,
+                                          const QString& color, int alpha);
+
+signals:
+    void contentXChanged();
+    void contentYChanged();
+    void layoutChanged();
+    void mouseHoverMoved();
+
+private slots:
+    void updateZoom(float newZoom);
+    void goToPosition(int pageNumber, int y);
+    void selectText(int pageNumber, QPointF left, QPointF right);
+    void requestPageImages();
+    void updatePageGeometry();
+    void showLoadedBook();
+
+protected:
+    void geometryChange(const QRectF& newGeometry,
+                        const QRectF& oldGeometry) override;
+    void itemChange(ItemChange change, const ItemChangeData& data) override;
+    void updatePolish() override;
+    QSGNode* updatePaintNode(QSGNode* node, UpdatePaintNodeData* _) override;
+
+    virtual void mouseDoubleClickEvent(QMouseEvent* event) override;
+    virtual void mousePressEvent(QMouseEvent* event) override;
+    virtual void mouseReleaseEvent(QMouseEvent* event) override;
+    virtual void mouseMoveEvent(QMouseEvent* event) override;
+    virtual void hoverMoveEvent(QHoverEvent* event) override;
+    virtual void keyPressEvent(QKeyEvent* event) override;
+    virtual void hoverLeaveEvent(QHoverEvent* event) override;
+
+private:
+    // Layout
+    void ensureLayout();
+    void updateLayout();
+    void updatePageSize(int pageNumber, const QSize& pageSize);
+    QRectF getPageRect(int pageNumber) const;
+    int getPageAtY(qreal y) const;
+    int getPageAtPoint(const QPointF& point) const;
+    QPointF mapToPage(int pageNumber, const QPointF& point) const;
+    QPointF mapFromPage(int pageNumber, const QPointF& point) const;
+    // Moves the content without counting as scrolling, e.g. for jumps
+    void moveContentY(qreal newContentY);
+    void clampContentPosition();
+    void updateScrollSpeed(qreal scrolledPixels);
+    void updateCurrentPage();
+
+    // Pages
+    adapters::controllers::PageController* getPageController(int pageNumber);
+    adapters::controllers::PageController* createPageController(
+        int pageNumber);
+    void updateActivePages();
+    double getDevicePixelRatio() const;
+
+    // Interaction
+    void selectSingleWord();
+    void selectMultipleWords();
+    void selectLine();
+    void createSelection();
+    QList<OverlayRect> getSelectionOverlayRects(int pageNumber) const;
+    QList<OverlayRect> getHighlightOverlayRects(int pageNumber) const;
+    QList<OverlayRect> getSearchHitOverlayRects(int pageNumber) const;
+    void handleClickingOnHighlight(
+        int pageNumber, const domain::entities::Highlight* highlight);
+    void removeConflictingHighlights(domain::entities::Highlight& highlight);
+    void setCorrectCursor(const QPointF& point);
+    void prefetchHoveredLink(adapters::controllers::PageController* page,
+                             const QPointF& point);
+    void updateColorMatrix();
+
+    bool rectsAreOnSameLine(const QRectF& rect1, const QRectF& rect2);
+    QPair<float, float> getCenterXAndBottomYFromRects(
+        const QList<QRectF>& rects);
+
+    adapters::IBookController* m_bookController = nullptr;
+
+    // The pages' sizes at a zoom of 1, from which the pages' positions are
+    // computed. The sizes are estimated until the book's exact geometry was
+    // loaded.
+    application::core::PageGeometry m_pageGeometry;
+    qreal m_contentWidth = 0;
+    qreal m_contentHeight = 0;
+    qreal m_contentX = 0;
+    qreal m_contentY = 0;
+    int m_pageSpacing = 0;
+    float m_zoom = 1;
+
+    // Only the pages in and around the viewport have a PageController
+    std::map<int, std::unique_ptr<adapters::controllers::PageController>>
+        m_pageControllers;
+    const qreal m_cacheBuffer = 1000;
+
+    QString m_colorTheme;
+    QMatrix4x4 m_colorMatrix;
+
+    // The page that received the last mouse press, mouse moves and releases
+    // are forwarded to it, even if the cursor leaves it.
+    int m_pressedPage = -1;
+    int m_selectionPage = -1;
+    QPointF m_selectionStart;
+    QPointF m_selectionEnd;
+    bool m_startedMousePressOnLink = false;
+    bool m_startedMousePressOnHighlight = false;
+    QString m_hoveredLinkUri;
+    QTimer m_tripleClickTimer;
+    QTimer m_zoomSettleTimer;
+
+    // The scroll speed in pixels per second. While it is faster than
+    // m_fastScrollSpeed viewport heights per second, pages are only rendered
+    // in draft quality.
+    QElapsedTimer m_scrollTimer;
+    qreal m_scrollSpeed = 0;
+    bool m_scrollingFast = false;
+    QTimer m_scrollSettleTimer;
+    const qreal m_fastScrollSpeed = 2;
+    bool m_doubleClickHold = false;
+    bool m_includeNewLinesInCopiedText = false;
+};
+
+}  // namespace cpp_elements
@@ -0,0 +1,77 @@
+#include "document_node.hpp"
+#include <QMatrix4x4>
+
+namespace cpp_elements
+{
+
+DocumentNode::~DocumentNode()
+{
+    // The unused nodes are not part of the tree, so they are not deleted with
+    // it. Deleting a transform node also deletes its page node.
+    for(auto& entry : m_unusedPages)
+        delete entry.transformNode;
+}
+
+void DocumentNode::beginUpdate()
+{
+    m_usedPages.clear();
+}
+
+PageNode* DocumentNode::getPageNode(int pageNumber, const QPointF& position)
+{
+    m_usedPages.insert(pageNumber);
+
+    auto it = m_pages.find(pageNumber);
+    if(it == m_pages.end())
+    {
+        PageEntry entry;
+        if(!m_unusedPages.empty())
+        {
+            entry = m_unusedPages.back();
+            m_unusedPages.pop_back();
+        }
+        else
+        {
+            entry.transformNode = new QSGTransformNode();
+            entry.pageNode = new PageNode();
+            entry.transformNode->appendChildNode(entry.pageNode);
+        }
+
+        appendChildNode(entry.transformNode);
+        it = m_pages.insert(pageNumber, entry);
+    }
+
+    QMatrix4x4 matrix;
+    matrix.translate(position.x(), position.y());
+    if(it->transformNode->matrix() != matrix)
+        it->transformNode->setMatrix(matrix);
+
+    return it->pageNode;
+}
+
+void DocumentNode::endUpdate()
+{
+    for(auto it = m_pages.begin(); it != m_pages.end();)
+    {
+        if(m_usedPages.contains(it.key()))
+        {
+            ++it;
+            continue;
+        }
+
+        removeChildNode(it->transformNode);
+        if(m_unusedPages.size() < m_maxUnusedPages)
+        {
+            it->pageNode->clear();
+            m_unusedPages.push_back(it.value());
+        }
+        else
+        {
+            delete it->transformNode;
+        }
+
+        it = m_pages.erase(it);
+    }
+}
+
+}  // namespace cpp_elements
@@ -0,0 +1,48 @@
+#pragma once
+#include <QHash>
+#include <QPointF>
+#include <QSGNode>
+#include <QSGTransformNode>
+#include <QSet>
+#include <vector>
+#include "page_node.hpp"
+
+namespace cpp_elements
+{
+
+/**
+ * The scene graph representation of the pages the DocumentCanvas shows. Every
+ * page is a PageNode below a transform node which positions it.
+ *
+ * The nodes of pages that scrolled out of view are cleared and kept around for
+ * the pages that scroll into view, instead of being destroyed and created
+ * again for every page.
+ */
+class DocumentNode : public QSGNode
+{
+public:
+    ~DocumentNode();
+
+    /**
+     * Updating the pages starts with beginUpdate(). Then getPageNode() is
+     * called for every visible page, and endUpdate() recycles the nodes of all
+     * pages it was not called for.
+     */
+    void beginUpdate();
+    PageNode* getPageNode(int pageNumber, const QPointF& position);
+    void endUpdate();
+
+private:
+    struct PageEntry
+    {
+        QSGTransformNode* transformNode;
+        PageNode* pageNode;
+    };
+
+    QHash<int, PageEntry> m_pages;
+    QSet<int> m_usedPages;
+    std::vector<PageEntry> m_unusedPages;
+    const int m_maxUnusedPages = 4;
+};
+
+}  // namespace cpp_elements
@@ -0,0 +1,119 @@
+#include "overlay_node.hpp"
+#include <cstring>
+
+namespace cpp_elements
+{
+
+OverlayMaterial::OverlayMaterial()
+{
+    setFlag(QSGMaterial::Blending);
+}
+
+QSGMaterialType* OverlayMaterial::type() const
+{
+    static QSGMaterialType type;
+    return &type;
+}
+
+QSGMaterialShader* OverlayMaterial::createShader(
+    QSGRendererInterface::RenderMode renderMode) const
+{
+    Q_UNUSED(renderMode);
+    return new OverlayMaterialShader();
+}
+
+OverlayMaterialShader::OverlayMaterialShader()
+{
+    setShaderFileName(VertexStage, ":/shaders/overlay.vert.qsb");
+    setShaderFileName(FragmentStage, ":/shaders/overlay.frag.qsb");
+    setFlag(UpdatesGraphicsPipelineState);
+}
+
+bool OverlayMaterialShader::updateUniformData(RenderState& state,
+                                              QSGMaterial* newMaterial,
+                                              QSGMaterial* oldMaterial)
+{
+    Q_UNUSED(newMaterial);
+    Q_UNUSED(oldMaterial);
+
+    // Layout of the uniform buffer: mat4 qt_Matrix, float qt_Opacity
+    bool changed = false;
+    QByteArray* buffer = state.uniformData();
+    if(state.isMatrixDirty())
+    {
+        auto matrix = state.combinedMatrix();
+        std::memcpy(buffer->data(), matrix.constData(), 64);
+        changed = true;
+    }
+
+    if(state.isOpacityDirty())
+    {
+        float opacity = state.opacity();
+        std::memcpy(buffer->data() + 64, &opacity, 4);
+        changed = true;
+    }
+
+    return changed;
+}
+
+bool OverlayMaterialShader::updateGraphicsPipelineState(
+    RenderState& state, GraphicsPipelineState* pipelineState,
+    QSGMaterial* newMaterial, QSGMaterial* oldMaterial)
+{
+    Q_UNUSED(state);
+    Q_UNUSED(newMaterial);
+    Q_UNUSED(oldMaterial);
+
+    // result = src * dst + dst * (1 - srcAlpha), with a premultiplied src this
+    // is what QPainter's multiply composition mode does on an opaque page.
+    pipelineState->blendEnable = true;
+    pipelineState->srcColor = GraphicsPipelineState::DstColor;
+    pipelineState->dstColor = GraphicsPipelineState::OneMinusSrcAlpha;
+    return true;
+}
+
+OverlayNode::OverlayNode() :
+    m_geometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0)
+{
+    m_geometry.setDrawingMode(QSGGeometry::DrawTriangles);
+    setGeometry(&m_geometry);
+    setMaterial(&m_material);
+}
+
+void OverlayNode::setRects(const QList<OverlayRect>& rects)
+{
+    // Avoid touching the geometry at all if nothing changed, e.g. when the
+    // page is only updated because of a change to a different overlay.
+    if(rects == m_rects)
+        return;
+
+    m_rects = rects;
+
+    // Every rect is made up of two triangles
+    m_geometry.allocate(rects.size() * 6);
+    auto vertices = m_geometry.vertexDataAsColoredPoint2D();
+    for(int i = 0; i < rects.size(); ++i)
+    {
+        auto& rect = rects[i].rect;
+        auto& color = rects[i].color;
+
+        // The scene graph expects premultiplied colors
+        auto alpha = color.alphaF();
+        uchar r = color.red() * alpha;
+        uchar g = color.green() * alpha;
+        uchar b = color.blue() * alpha;
+        uchar a = color.alpha();
+
+        auto vertex = vertices + i * 6;
+        vertex[0].set(rect.left(), rect.top(), r, g, b, a);
+        vertex[1].set(rect.right(), rect.top(), r, g, b, a);
+        vertex[2].set(rect.left(), rect.bottom(), r, g, b, a);
+        vertex[3].set(rect.left(), rect.bottom(), r, g, b, a);
+        vertex[4].set(rect.right(), rect.top(), r, g, b, a);
+        vertex[5].set(rect.right(), rect.bottom(), r, g, b, a);
+    }
+
+    markDirty(QSGNode::DirtyGeometry);
+}
+
+}  // namespace cpp_elements
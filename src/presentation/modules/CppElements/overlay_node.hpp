@@ -0,0 +1,66 @@
+#pragma once
+#include <QColor>
+#include <QList>
+#include <QRectF>
+#include <QSGGeometryNode>
+#include <QSGMaterial>
+#include <QSGMaterialShader>
+
+namespace cpp_elements
+{
+
+struct OverlayRect
+{
+    QRectF rect;
+    QColor color;
+
+    bool operator==(const OverlayRect& other) const = default;
+};
+
+/**
+ * Colors the content below it by multiplying it with the vertex colors, the
+ * same way QPainter::CompositionMode_Multiply does. This keeps text below
+ * selections and highlights readable, instead of covering it.
+ */
+class OverlayMaterial : public QSGMaterial
+{
+public:
+    OverlayMaterial();
+
+    QSGMaterialType* type() const override;
+    QSGMaterialShader* createShader(
+        QSGRendererInterface::RenderMode renderMode) const override;
+};
+
+class OverlayMaterialShader : public QSGMaterialShader
+{
+public:
+    OverlayMaterialShader();
+
+    bool updateUniformData(RenderState& state, QSGMaterial* newMaterial,
+                           QSGMaterial* oldMaterial) override;
+    bool updateGraphicsPipelineState(RenderState& state,
+                                     GraphicsPipelineState* pipelineState,
+                                     QSGMaterial* newMaterial,
+                                     QSGMaterial* oldMaterial) override;
+};
+
+/**
+ * A scene graph node that draws a list of colored rects (e.g. the selection or
+ * highlights of a page) on top of the page's texture. Changing the rects only
+ * updates the node's vertices, the page's texture stays untouched.
+ */
+class OverlayNode : public QSGGeometryNode
+{
+public:
+    OverlayNode();
+
+    void setRects(const QList<OverlayRect>& rects);
+
+private:
+    QSGGeometry m_geometry;
+    OverlayMaterial m_material;
+    QList<OverlayRect> m_rects;
+};
+
+}  // namespace cpp_elements
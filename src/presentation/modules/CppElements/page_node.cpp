@@ -0,0 +1,125 @@
+#include "page_node.hpp"
+
+namespace cpp_elements
+{
+
+PageNode::PageNode() :
+    m_tilesNode(new QSGNode()),
+    m_highlightsNode(new OverlayNode()),
+    m_selectionNode(new OverlayNode())
+{
+    // The page's texture node is created once there is an image for it and is
+    // then inserted below these.
+    appendChildNode(m_tilesNode);
+    appendChildNode(m_highlightsNode);
+    appendChildNode(m_selectionNode);
+}
+
+void PageNode::setPageImage(QQuickWindow* window, const QImage& image,
+                            const QRectF& rect)
+{
+    if(image.cacheKey() != m_pageImageKey)
+    {
+        auto textureNode = createTextureNode(window, image);
+        if(m_pageTextureNode != nullptr)
+        {
+            removeChildNode(m_pageTextureNode);
+            delete m_pageTextureNode;
+        }
+
+        m_pageTextureNode = textureNode;
+        m_pageImageKey = image.cacheKey();
+        prependChildNode(m_pageTextureNode);
+    }
+
+    // The image is stretched over the page until a new one is rendered, e.g.
+    // for a new zoom.
+    if(m_pageTextureNode->rect() != rect)
+        m_pageTextureNode->setRect(rect);
+}
+
+void PageNode::setTiles(QQuickWindow* window, const QList<PageNodeTile>& tiles)
+{
+    // Reuse the nodes of tiles that already have a texture
+    QHash<qint64, ThemedTextureNode*> tileNodes;
+    for(auto& tile : tiles)
+    {
+        auto key = tile.image.cacheKey();
+        auto textureNode = m_tileNodes.take(key);
+        if(textureNode == nullptr)
+        {
+            textureNode = createTextureNode(window, tile.image);
+            m_tilesNode->appendChildNode(textureNode);
+        }
+
+        if(textureNode->rect() != tile.rect)
+            textureNode->setRect(tile.rect);
+
+        tileNodes.insert(key, textureNode);
+    }
+
+    // Whatever is left over belongs to tiles that were dropped
+    for(auto textureNode : std::as_const(m_tileNodes))
+    {
+        m_tilesNode->removeChildNode(textureNode);
+        delete textureNode;
+    }
+
+    m_tileNodes = tileNodes;
+}
+
+void PageNode::setColorMatrix(const QMatrix4x4& colorMatrix)
+{
+    if(m_colorMatrix == colorMatrix)
+        return;
+
+    m_colorMatrix = colorMatrix;
+    if(m_pageTextureNode != nullptr)
+        m_pageTextureNode->setColorMatrix(colorMatrix);
+
+    for(auto textureNode : std::as_const(m_tileNodes))
+        textureNode->setColorMatrix(colorMatrix);
+}
+
+void PageNode::clear()
+{
+    if(m_pageTextureNode != nullptr)
+    {
+        removeChildNode(m_pageTextureNode);
+        delete m_pageTextureNode;
+        m_pageTextureNode = nullptr;
+        m_pageImageKey = 0;
+    }
+
+    setTiles(nullptr, {});
+    m_highlightsNode->setRects({});
+    m_selectionNode->setRects({});
+}
+
+void PageNode::setHighlightRects(const QList<OverlayRect>& rects)
+{
+    m_highlightsNode->setRects(rects);
+}
+
+void PageNode::setSelectionRects(const QList<OverlayRect>& rects)
+{
+    m_selectionNode->setRects(rects);
+}
+
+ThemedTextureNode* PageNode::createTextureNode(QQuickWindow* window,
+                                                  const QImage& image)
+{
+    // Pages are rendered onto an opaque background, so the images' alpha
+    // channel carries no information.
+    std::unique_ptr<QSGTexture> texture(window->createTextureFromImage(
+        image, QQuickWindow::TextureIsOpaque));
+    texture->setFiltering(QSGTexture::Linear);
+
+    auto textureNode = new ThemedTextureNode();
+    textureNode->setTexture(std::move(texture));
+    textureNode->setColorMatrix(m_colorMatrix);
+
+    return textureNode;
+}
+
+}  // namespace cpp_elements
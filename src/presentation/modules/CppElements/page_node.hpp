@@ -0,0 +1,61 @@
+#pragma once
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QMatrix4x4>
+#include <QQuickWindow>
+#include <QRectF>
+#include <QSGNode>
+#include "overlay_node.hpp"
+#include "themed_texture_node.hpp"
+
+namespace cpp_elements
+{
+
+struct PageNodeTile
+{
+    QImage image;
+    QRectF rect;
+};
+
+/**
+ * The scene graph representation of a single page. It consists of (from
+ * bottom to top) the page's texture, the textures of the tiles rendered at high
+ * zoom levels, the highlights and the selection.
+ *
+ * Textures are only uploaded when the image they are created from changes, so
+ * updating the overlays, moving the page or changing the color theme never
+ * re-uploads them.
+ */
+class PageNode : public QSGNode
+{
+public:
+    PageNode();
+
+    void setPageImage(QQuickWindow* window, const QImage& image,
+                      const QRectF& rect);
+    void setTiles(QQuickWindow* window, const QList<PageNodeTile>& tiles);
+    void setHighlightRects(const QList<OverlayRect>& rects);
+    void setSelectionRects(const QList<OverlayRect>& rects);
+    void setColorMatrix(const QMatrix4x4& colorMatrix);
+
+    /**
+     * Drops the page's textures and overlays, so that the node can be reused
+     * for another page without holding on to the old page's textures.
+     */
+    void clear();
+
+private:
+    ThemedTextureNode* createTextureNode(QQuickWindow* window,
+                                            const QImage& image);
+
+    ThemedTextureNode* m_pageTextureNode = nullptr;
+    qint64 m_pageImageKey = 0;
+    QSGNode* m_tilesNode;
+    QHash<qint64, ThemedTextureNode*> m_tileNodes;
+    OverlayNode* m_highlightsNode;
+    OverlayNode* m_selectionNode;
+    QMatrix4x4 m_colorMatrix;
+};
+
+}  // namespace cpp_elements
@@ -0,0 +1,165 @@
+#include "themed_texture_node.hpp"
+#include <cstring>
+
+namespace cpp_elements
+{
+
+ThemedTextureMaterial::ThemedTextureMaterial()
+{
+    setFlag(QSGMaterial::Blending);
+}
+
+QSGMaterialType* ThemedTextureMaterial::type() const
+{
+    static QSGMaterialType type;
+    return &type;
+}
+
+QSGMaterialShader* ThemedTextureMaterial::createShader(
+    QSGRendererInterface::RenderMode renderMode) const
+{
+    Q_UNUSED(renderMode);
+    return new ThemedTextureMaterialShader();
+}
+
+int ThemedTextureMaterial::compare(const QSGMaterial* other) const
+{
+    // Materials are batched if they compare equal, which requires both the
+    // same texture and the same color matrix.
+    auto otherMaterial = static_cast<const ThemedTextureMaterial*>(other);
+    if(auto diff = m_texture->comparisonKey() -
+                   otherMaterial->m_texture->comparisonKey())
+    {
+        return diff < 0 ? -1 : 1;
+    }
+
+    return std::memcmp(m_colorMatrix.constData(),
+                       otherMaterial->m_colorMatrix.constData(),
+                       16 * sizeof(float));
+}
+
+QSGTexture* ThemedTextureMaterial::getTexture() const
+{
+    return m_texture.get();
+}
+
+void ThemedTextureMaterial::setTexture(std::unique_ptr<QSGTexture> texture)
+{
+    m_texture = std::move(texture);
+}
+
+const QMatrix4x4& ThemedTextureMaterial::getColorMatrix() const
+{
+    return m_colorMatrix;
+}
+
+void ThemedTextureMaterial::setColorMatrix(const QMatrix4x4& colorMatrix)
+{
+    m_colorMatrix = colorMatrix;
+}
+
+ThemedTextureMaterialShader::ThemedTextureMaterialShader()
+{
+    setShaderFileName(VertexStage, ":/shaders/themed_texture.vert.qsb");
+    setShaderFileName(FragmentStage, ":/shaders/themed_texture.frag.qsb");
+}
+
+bool ThemedTextureMaterialShader::updateUniformData(RenderState& state,
+                                                    QSGMaterial* newMaterial,
+                                                    QSGMaterial* oldMaterial)
+{
+    // Layout of the uniform buffer: mat4 qt_Matrix, mat4 colorMatrix,
+    // float qt_Opacity
+    bool changed = false;
+    QByteArray* buffer = state.uniformData();
+    if(state.isMatrixDirty())
+    {
+        auto matrix = state.combinedMatrix();
+        std::memcpy(buffer->data(), matrix.constData(), 64);
+        changed = true;
+    }
+
+    auto material = static_cast<ThemedTextureMaterial*>(newMaterial);
+    auto previous = static_cast<ThemedTextureMaterial*>(oldMaterial);
+    if(previous == nullptr ||
+       previous->getColorMatrix() != material->getColorMatrix())
+    {
+        std::memcpy(buffer->data() + 64,
+                    material->getColorMatrix().constData(), 64);
+        changed = true;
+    }
+
+    if(state.isOpacityDirty())
+    {
+        float opacity = state.opacity();
+        std::memcpy(buffer->data() + 128, &opacity, 4);
+        changed = true;
+    }
+
+    return changed;
+}
+
+void ThemedTextureMaterialShader::updateSampledImage(RenderState& state,
+                                                     int binding,
+                                                     QSGTexture** texture,
+                                                     QSGMaterial* newMaterial,
+                                                     QSGMaterial* oldMaterial)
+{
+    Q_UNUSED(oldMaterial);
+    if(binding != 1)
+        return;
+
+    auto material = static_cast<ThemedTextureMaterial*>(newMaterial);
+    auto materialTexture = material->getTexture();
+    materialTexture->commitTextureOperations(state.rhi(),
+                                             state.resourceUpdateBatch());
+    *texture = materialTexture;
+}
+
+ThemedTextureNode::ThemedTextureNode() :
+    m_geometry(QSGGeometry::defaultAttributes_TexturedPoint2D(), 4)
+{
+    setGeometry(&m_geometry);
+    setMaterial(&m_material);
+}
+
+void ThemedTextureNode::setTexture(std::unique_ptr<QSGTexture> texture)
+{
+    m_material.setTexture(std::move(texture));
+    updateGeometry();
+    markDirty(QSGNode::DirtyMaterial);
+}
+
+QRectF ThemedTextureNode::rect() const
+{
+    return m_rect;
+}
+
+void ThemedTextureNode::setRect(const QRectF& rect)
+{
+    m_rect = rect;
+    updateGeometry();
+}
+
+void ThemedTextureNode::setColorMatrix(const QMatrix4x4& colorMatrix)
+{
+    if(m_material.getColorMatrix() == colorMatrix)
+        return;
+
+    m_material.setColorMatrix(colorMatrix);
+    markDirty(QSGNode::DirtyMaterial);
+}
+
+void ThemedTextureNode::updateGeometry()
+{
+    if(m_material.getTexture() == nullptr)
+        return;
+
+    // Small textures might be placed in an atlas, so only a part of the
+    // underlying texture belongs to this node.
+    auto textureRect = m_material.getTexture()->normalizedTextureSubRect();
+    QSGGeometry::updateTexturedRectGeometry(&m_geometry, m_rect, textureRect);
+    markDirty(QSGNode::DirtyGeometry);
+}
+
+}  // namespace cpp_elements
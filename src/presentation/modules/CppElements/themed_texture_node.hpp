@@ -0,0 +1,71 @@
+#pragma once
+#include <QMatrix4x4>
+#include <QRectF>
+#include <QSGGeometryNode>
+#include <QSGMaterial>
+#include <QSGMaterialShader>
+#include <QSGTexture>
+#include <memory>
+
+namespace cpp_elements
+{
+
+/**
+ * Draws a texture with a color matrix applied to it. This is how the color
+ * themes (e.g. inverted or sepia) are applied to the pages, so switching
+ * between them never requires re-rendering a page.
+ */
+class ThemedTextureMaterial : public QSGMaterial
+{
+public:
+    ThemedTextureMaterial();
+
+    QSGMaterialType* type() const override;
+    QSGMaterialShader* createShader(
+        QSGRendererInterface::RenderMode renderMode) const override;
+    int compare(const QSGMaterial* other) const override;
+
+    QSGTexture* getTexture() const;
+    void setTexture(std::unique_ptr<QSGTexture> texture);
+
+    const QMatrix4x4& getColorMatrix() const;
+    void setColorMatrix(const QMatrix4x4& colorMatrix);
+
+private:
+    std::unique_ptr<QSGTexture> m_texture;
+    QMatrix4x4 m_colorMatrix;
+};
+
+class ThemedTextureMaterialShader : public QSGMaterialShader
+{
+public:
+    ThemedTextureMaterialShader();
+
+    bool updateUniformData(RenderState& state, QSGMaterial* newMaterial,
+                           QSGMaterial* oldMaterial) override;
+    void updateSampledImage(RenderState& state, int binding,
+                            QSGTexture** texture, QSGMaterial* newMaterial,
+                            QSGMaterial* oldMaterial) override;
+};
+
+class ThemedTextureNode : public QSGGeometryNode
+{
+public:
+    ThemedTextureNode();
+
+    void setTexture(std::unique_ptr<QSGTexture> texture);
+
+    QRectF rect() const;
+    void setRect(const QRectF& rect);
+
+    void setColorMatrix(const QMatrix4x4& colorMatrix);
+
+private:
+    void updateGeometry();
+
+    QSGGeometry m_geometry;
+    ThemedTextureMaterial m_material;
+    QRectF m_rect;
+};
+
+}  // namespace cpp_elements
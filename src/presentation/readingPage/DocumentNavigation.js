@@ -12,52 +12,14 @@ function handleWheel(wheel) {
     // e.g. pushing the scroll button to the left/right.
     else if (wheel.angleDelta.x !== 0) {
         if (factorX > 1)
-            flick(pageView.scrollSpeed / 3, 0)
+            flick(documentCanvas.scrollSpeed / 3, 0)
         else
-            flick(-pageView.scrollSpeed / 3, 0)
+            flick(-documentCanvas.scrollSpeed / 3, 0)
     } else {
         if (factorY > 1)
-            flick(0, pageView.scrollSpeed)
+            flick(0, documentCanvas.scrollSpeed)
         else
-            flick(0, -pageView.scrollSpeed)
-    }
-}
-
-// Calculate the current page and update the document.
-function updateCurrentPageCounter() {
-    // A new page starts if it is over the middle of the screen (vertically).
-    let middleOfScreen = pageView.contentY + pageView.height / 2
-    let pageNumber = pageView.indexAt(pageView.currentItem.width / 2,
-                                      middleOfScreen)
-
-    // If the middle of the screen is in the free space between two pages, take the lower one
-    if (pageNumber === -1) {
-        let pageSpacing = pageView.getPageSpacing(root.bookController.zoom)
-        pageNumber = pageView.indexAt(pageView.currentItem.width / 2,
-                                      middleOfScreen + pageSpacing)
-    }
-
-    if (pageNumber !== root.bookController.currentPage)
-        root.bookController.currentPage = pageNumber
-}
-
-
-/**
-  Changes the current move direction of the listview, without actually
-  moving visibly. This is neccessary since the listview only chaches
-  delegates in the direction of the current move direction.
-  If we e.g. scroll downwards and then go to the previousPage
-  by setting the contentY, the previous pages are not cached
-  which might lead to visible loading while moving through the
-  book with the arrow keys.
-  */
-function setMoveDirection(direction) {
-    if (direction === "up") {
-        flick(0, -1000)
-        pageView.cancelFlick()
-    } else if (direction === "down") {
-        flick(0, 1000)
-        pageView.cancelFlick()
+            flick(0, -documentCanvas.scrollSpeed)
     }
 }
 
@@ -67,34 +29,41 @@ function zoom(newZoomFactor) {
     if (newZoomFactor === root.bookController.zoom)
         return
 
-    let defaultPageHeight = Math.round(
-            pageView.currentItem.height / root.bookController.zoom)
-    let newPageHeight = Math.round(
-            defaultPageHeight * newZoomFactor) + pageView.getPageSpacing(
-            newZoomFactor)
-
-    let pageOffset = getYOffset()
-
+    // The canvas keeps the current position when the zoom changes
     root.bookController.zoom = newZoomFactor
-    pageView.forceLayout()
-    pageView.contentY = newPageHeight * root.bookController.currentPage
-            + pageOffset + pageView.originY
 }
 
+/**
+  Moves the content by the distance a flick with the given velocity would
+  cover until it is decelerated to a stop. Consecutive flicks add up.
+  */
 function flick(x, y) {
-    pageView.flick(x, y)
+    flickAxis(flickAnimationX, documentCanvas.contentX,
+              documentCanvas.contentWidth - documentCanvas.width, x)
+    flickAxis(flickAnimationY, documentCanvas.contentY,
+              documentCanvas.contentHeight - documentCanvas.height, y)
 }
 
-function setPage(newPageNumber) {
-    if (newPageNumber < 0 || newPageNumber > root.bookController.pageCount)
+function flickAxis(animation, position, maxPosition, velocity) {
+    if (velocity === 0)
         return
 
-    pageView.currentIndex = newPageNumber
-    pageView.positionViewAtIndex(newPageNumber, ListView.Beginning)
-    root.bookController.currentPage = newPageNumber
+    let distance = -Math.sign(
+            velocity) * velocity * velocity / (2 * documentCanvas.flickDeceleration)
+    let start = animation.running ? animation.to : position
+    let target = Math.max(0, Math.min(start + distance, maxPosition))
+
+    animation.stop()
+    animation.from = position
+    animation.to = target
+    animation.start()
+}
+
+function setPage(newPageNumber, yOffset = 0) {
+    if (newPageNumber < 0 || newPageNumber >= root.bookController.pageCount)
+        return
 
-    if (newPageNumber > root.bookController.currentPage)
-        setMoveDirection("up")
-    else if (newPageNumber < root.bookController.currentPage)
-        setMoveDirection("down")
+    flickAnimationX.stop()
+    flickAnimationY.stop()
+    documentCanvas.setPage(newPageNumber, yOffset)
 }
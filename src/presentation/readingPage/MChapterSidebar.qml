@@ -13,6 +13,7 @@ import QtQuick.Shapes
 Item {
     id: root
     signal switchPage(int pageNumber, real yOffset)
+    signal pageHovered(int pageNumber)
     property alias model: treeView.model
 
     implicitWidth: 300
@@ -66,7 +67,11 @@ Item {
                         color: "transparent"
                     }
 
-                    onTextEdited: BookController.tableOfContents.filterString = text
+                    onTextEdited: {
+                        // There is no outline until the book was loaded
+                        if (BookController.tableOfContents)
+                            BookController.tableOfContents.filterString = text
+                    }
                 }
             }
 
@@ -115,12 +120,24 @@ Item {
                             required property bool expanded
                             required property int hasChildren
                             required property int depth
+                            // The page of an entry is resolved once it is
+                            // shown, clicking it before switches afterwards
+                            property bool switchWhenResolved: false
 
                             implicitWidth: treeView.width - 2 // L/R margins
                             width: implicitWidth
                             implicitHeight: treeNodeLabel.height
                             color: "transparent"
 
+                            TableView.onReused: switchWhenResolved = false
+
+                            onPageNumberChanged: {
+                                if (switchWhenResolved && pageNumber >= 0) {
+                                    switchWhenResolved = false
+                                    switchToEntry()
+                                }
+                            }
+
                             RowLayout {
                                 id: nodeLayout
                                 anchors.left: parent.left
@@ -167,12 +184,20 @@ Item {
                                         id: pageSwitchTrigger
                                         anchors.fill: parent
                                         cursorShape: Qt.PointingHandCursor
+                                        hoverEnabled: true
 
-                                        // NaN check: x !== x
-                                        onClicked: root.switchPage(
-                                                       model.pageNumber,
-                                                       model.yOffset
-                                                       !== model.yOffset ? 1 : model.yOffset - 10)
+                                        onEntered: {
+                                            if (model.pageNumber >= 0)
+                                                root.pageHovered(
+                                                            model.pageNumber)
+                                        }
+
+                                        onClicked: {
+                                            if (treeNode.pageNumber >= 0)
+                                                treeNode.switchToEntry()
+                                            else
+                                                treeNode.switchWhenResolved = true
+                                        }
                                     }
                                 }
 
@@ -184,10 +209,17 @@ Item {
                                     color: Style.colorText
                                     opacity: pageSwitchTrigger.pressed ? 0.7 : 1
                                     font.pixelSize: 14
-                                    text: treeNode.pageNumber
-                                          + 1 // Convert from 0-indexed to normal numbers
+                                    // Convert from 0-indexed to normal numbers
+                                    text: treeNode.pageNumber >= 0
+                                          ? treeNode.pageNumber + 1 : ""
                                 }
                             }
+
+                            function switchToEntry() {
+                                // NaN check: x !== x
+                                root.switchPage(model.pageNumber,
+                                                model.yOffset !== model.yOffset ? 1 : model.yOffset - 10)
+                            }
                         }
                     }
 
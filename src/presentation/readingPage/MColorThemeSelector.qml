@@ -0,0 +1,87 @@
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+import Librum.style
+import Librum.icons
+import Librum.fonts
+import Librum.elements
+
+// Lets the user pick the color theme that the pages are shown in, the themes
+// are the ones registered in color_themes.hpp.
+Item {
+    id: root
+    required property var bookController
+
+    implicitHeight: layout.implicitHeight
+
+    ColumnLayout {
+        id: layout
+        width: parent.width
+        spacing: 8
+
+        RowLayout {
+            id: titleLayout
+            spacing: 6
+
+            Image {
+                id: themeIcon
+                Layout.leftMargin: -1
+                source: Icons.readingOptionsInvertColor
+                sourceSize.width: 24
+                fillMode: Image.PreserveAspectFit
+            }
+
+            Label {
+                id: themeTitle
+                text: qsTr("Color theme")
+                color: Style.colorText
+                font.pointSize: Fonts.size12
+                font.weight: Font.Medium
+            }
+        }
+
+        RowLayout {
+            id: themeLayout
+            spacing: 8
+
+            Repeater {
+                model: ColorThemes.themes
+
+                delegate: Rectangle {
+                    id: themeSwatch
+                    required property var modelData
+                    property bool selected: root.bookController.colorTheme === modelData.name
+
+                    Layout.preferredWidth: 36
+                    Layout.preferredHeight: 24
+                    radius: 4
+                    color: modelData.background
+                    border.width: selected ? 2 : 1
+                    border.color: selected ? Style.colorBasePurple : Style.colorContainerBorder
+                    opacity: themeArea.pressed ? 0.7 : 1
+
+                    Label {
+                        anchors.centerIn: parent
+                        text: "Aa"
+                        color: themeSwatch.modelData.foreground
+                        font.pointSize: Fonts.size10
+                        font.weight: Font.Medium
+                    }
+
+                    MouseArea {
+                        id: themeArea
+                        anchors.fill: parent
+                        hoverEnabled: true
+                        cursorShape: Qt.PointingHandCursor
+
+                        onClicked: root.bookController.colorTheme = themeSwatch.modelData.name
+                    }
+
+                    ToolTip.visible: themeArea.containsMouse
+                    ToolTip.delay: 500
+                    ToolTip.text: qsTranslate("ColorThemes", themeSwatch.modelData.label)
+                }
+            }
+        }
+    }
+}
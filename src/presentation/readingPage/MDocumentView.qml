@@ -1,8 +1,10 @@
 import QtQuick
 import QtQuick.Controls
 import QtQuick.Layouts
+import CustomComponents
 import Librum.elements
 import Librum.style
+import Librum.fonts
 import Librum.globals
 import Librum.controllers
 import "DocumentNavigation.js" as NavigationLogic
@@ -17,6 +19,7 @@ Pane {
     signal clicked
     signal zoomFactorChanged(real factor)
     property var bookController
+    signal loadingAborted
 
     padding: 0
     background: Rectangle {
@@ -29,15 +32,16 @@ Pane {
 
     Component.onCompleted: root.bookController.zoom
                            = SettingsController.appearanceSettings.DefaultZoom / 100
-    Component.onDestruction: root.bookController.zoom = 1
+    Component.onDestruction: {
+        root.bookController.zoom = 1
+
+        // Leaving the page while the book is still loading
+        root.bookController.cancelLoading()
+    }
 
     Connections {
         target: root.bookController
 
-        function onGoToPosition(pageNumber, y) {
-            root.setPage(pageNumber, y - pageView.currentItem.yOffset)
-        }
-
         function onTextSelectionFinished(centerX, topY) {
             selectionOptionsPopup.highlight = ""
 
@@ -46,17 +50,21 @@ Pane {
 
         function onHighlightSelected(centerX, topY, highlightUuid) {
             // Remove selection if there is one when selecting a highlight
-            activeFocusItem.removeSelection()
+            documentCanvas.removeSelection()
             selectionOptionsPopup.highlight = highlightUuid
 
             internal.openSelectionOptionsPopup(centerX, topY)
         }
 
-        function onZoomChanged(newZoom) {
-            let normMaxWidth = pageView.widestItem / pageView.prevZoom
-            pageView.widestItem = normMaxWidth * root.bookController.zoom
+        // The book can't be shown, e.g. because its file is broken
+        function onLoadingFailed() {
+            root.loadingAborted()
+        }
 
-            pageView.prevZoom = root.bookController.zoom
+        function onSearchHitsChanged() {
+            // Hits arrive page by page, so don't recompute for every page
+            if (!searchHitDensityTimer.running)
+                searchHitDensityTimer.start()
         }
     }
 
@@ -80,6 +88,13 @@ Pane {
         }
     }
 
+    Timer {
+        id: searchHitDensityTimer
+        interval: 100
+
+        onTriggered: internal.updateSearchHitDensity()
+    }
+
     Timer {
         id: hideCursorTimer
         interval: SettingsController.behaviorSettings.HideCursorAfterDelay
@@ -92,7 +107,7 @@ Pane {
                 return
             }
 
-            pageView.currentItem.resetCursorToDefault()
+            documentCanvas.resetCursorToDefault()
             mouseArea.cursorShape = Qt.BlankCursor
         }
     }
@@ -110,57 +125,45 @@ Pane {
         onPressed: mouse.accepted = false
         onReleased: mouse.accepted = false
 
-        ListView {
-            id: pageView
+        DocumentCanvas {
+            id: documentCanvas
             readonly property int scrollSpeed: 5500
-            property int pageSpacing: pageView.getPageSpacing(
-                                          root.bookController.zoom)
-            property int widestItem: 0
-            property real prevZoom: 1
-
-            height: parent.height
-            width: contentWidth <= root.width ? contentWidth : root.width
-            contentWidth: pageView.widestItem
-            anchors.centerIn: parent
-            flickableDirection: Flickable.AutoFlickDirection
-            flickDeceleration: 150000
-            interactive: false
-            clip: true
-            cacheBuffer: 1000
-            maximumFlickVelocity: scrollSpeed
-            boundsMovement: Flickable.StopAtBounds
-            boundsBehavior: Flickable.StopAtBounds
-            model: root.bookController.pageCount
-            spacing: pageSpacing
-            delegate: PageView {
-                id: page
-                pageNumber: modelData
-                bookController: root.bookController
-                height: implicitHeight
-                width: implicitWidth
-                colorInverted: root.bookController.colorTheme === "Inverted"
-                includeNewLinesInCopiedText: SettingsController.behaviorSettings.IncludeNewLinesInCopiedText === "ON"
-                anchors.horizontalCenter: if (parent != null)
-                                              parent.horizontalCenter
-
-                Component.onCompleted: {
-                    if (implicitWidth > pageView.contentWidth)
-                        pageView.widestItem = page.implicitWidth
-                }
+            readonly property int flickDeceleration: 150000
 
-                onMouseHoverMoved: internal.showCursor()
-            }
+            anchors.fill: parent
+            bookController: root.bookController
+            pageSpacing: documentCanvas.getPageSpacing(root.bookController.zoom)
+            colorTheme: root.bookController.colorTheme
+            includeNewLinesInCopiedText: SettingsController.behaviorSettings.IncludeNewLinesInCopiedText === "ON"
 
-            // Set the book's current page once the model is loaded
             onContentYChanged: {
-                NavigationLogic.updateCurrentPageCounter()
                 selectionOptionsPopup.close()
+                internal.prefetchPages()
             }
 
             onContentXChanged: selectionOptionsPopup.close()
 
+            onMouseHoverMoved: internal.showCursor()
+
             Component.onCompleted: root.setPage(root.bookController.currentPage)
 
+            // Flicks move the content smoothly instead of jumping
+            NumberAnimation {
+                id: flickAnimationY
+                target: documentCanvas
+                property: "contentY"
+                duration: 100
+                easing.type: Easing.OutQuad
+            }
+
+            NumberAnimation {
+                id: flickAnimationX
+                target: documentCanvas
+                property: "contentX"
+                duration: 100
+                easing.type: Easing.OutQuad
+            }
+
             function getPageSpacing(zoom) {
                 return Math.round(
                             SettingsController.appearanceSettings.PageSpacing
@@ -176,16 +179,17 @@ Pane {
         active: true
         policy: ScrollBar.AlwaysOn
         orientation: Qt.Vertical
-        size: pageView.height / pageView.contentHeight
+        size: documentCanvas.height / documentCanvas.contentHeight
         minimumSize: 0.04
-        position: (pageView.contentY - pageView.originY) / pageView.contentHeight
+        position: documentCanvas.contentY / documentCanvas.contentHeight
         onPositionChanged: if (pressed)
-                               pageView.contentY = position
-                                       * pageView.contentHeight + pageView.originY
+                               documentCanvas.contentY = position
+                                       * documentCanvas.contentHeight
         anchors.top: parent.top
         anchors.right: parent.right
         anchors.bottom: parent.bottom
         horizontalPadding: 4
+        onHeightChanged: searchHitDensityTimer.start()
 
         contentItem: Rectangle {
             color: Style.colorScrollBarHandle
@@ -198,6 +202,25 @@ Pane {
             implicitHeight: 200
             color: verticalScrollbar.pressed
                    || verticalScrollbar.hovered ? Style.colorContainerBackground : "transparent"
+
+            // Marks where the search hits are, the more hits the stronger
+            Repeater {
+                model: internal.searchHitDensity
+
+                delegate: Rectangle {
+                    required property int index
+                    required property real modelData
+                    property real bucketHeight: parent.height / internal.searchHitDensity.length
+
+                    visible: modelData > 0
+                    x: 2
+                    y: index * bucketHeight
+                    width: parent.width - 4
+                    height: Math.max(bucketHeight, 2)
+                    color: Style.colorScrollBarSearchHit
+                    opacity: 0.35 + 0.65 * modelData
+                }
+            }
         }
     }
 
@@ -207,12 +230,14 @@ Pane {
         hoverEnabled: true
         active: true
         policy: ScrollBar.AlwaysOn
-        visible: pageView.contentWidth > pageView.width
+        visible: documentCanvas.contentWidth > documentCanvas.width
         orientation: Qt.Horizontal
-        size: pageView.width / pageView.contentWidth
+        size: documentCanvas.width / documentCanvas.contentWidth
         minimumSize: 0.04
-        position: (pageView.contentX - pageView.originX) / pageView.contentWidth
-        onPositionChanged: pageView.contentX = position * pageView.contentWidth + pageView.originX
+        position: documentCanvas.contentX / documentCanvas.contentWidth
+        onPositionChanged: if (pressed)
+                               documentCanvas.contentX = position
+                                       * documentCanvas.contentWidth
         anchors.left: parent.left
         anchors.right: parent.right
         anchors.bottom: parent.bottom
@@ -231,6 +256,45 @@ Pane {
         }
     }
 
+    // Shown while the book is opened in the background
+    ColumnLayout {
+        id: loadingIndicator
+        anchors.centerIn: parent
+        visible: root.bookController.loading
+        spacing: 14
+
+        Label {
+            Layout.alignment: Qt.AlignHCenter
+            text: qsTr("Opening book...")
+            color: Style.colorText
+            font.pointSize: Fonts.size12
+        }
+
+        MProgressBar {
+            Layout.preferredWidth: 220
+            Layout.alignment: Qt.AlignHCenter
+            progress: root.bookController.loadingProgress
+        }
+
+        MButton {
+            Layout.preferredWidth: 140
+            Layout.preferredHeight: 38
+            Layout.alignment: Qt.AlignHCenter
+            borderWidth: 1
+            backgroundColor: "transparent"
+            opacityOnPressed: 0.7
+            text: qsTr("Cancel")
+            textColor: Style.colorUnfocusedButtonText
+            fontWeight: Font.Bold
+            fontSize: Fonts.size12
+
+            onClicked: {
+                root.bookController.cancelLoading()
+                root.loadingAborted()
+            }
+        }
+    }
+
     MSelectionOptionsPopup {
         id: selectionOptionsPopup
         property real highlightCenterX
@@ -265,7 +329,7 @@ Pane {
 
     function flick(direction) {
         let up = direction === "up"
-        NavigationLogic.flick(0, (pageView.scrollSpeed / 1.4) * (up ? 1 : -1))
+        NavigationLogic.flick(0, (documentCanvas.scrollSpeed / 1.4) * (up ? 1 : -1))
     }
 
     function nextPage() {
@@ -282,21 +346,26 @@ Pane {
     }
 
     function setPage(pageNumber, yOffset = 0) {
-        NavigationLogic.setPage(pageNumber)
-
-        pageView.contentY += yOffset * root.bookController.zoom
+        NavigationLogic.setPage(pageNumber, yOffset)
     }
 
     function getYOffset() {
-        let currentPageHeight = pageView.currentItem.height + pageView.getPageSpacing(
-                root.bookController.zoom)
-        let currentPos = pageView.contentY - pageView.originY
-        return currentPos - (currentPageHeight * root.bookController.currentPage)
+        return documentCanvas.getYOffset()
     }
 
     QtObject {
         id: internal
         property string optionNameCursorModeHiddenAfterDelay: "Hidden after delay"
+        property real lastContentY: 0
+        property double lastContentYTime: 0
+        property var searchHitDensity: []
+
+        function updateSearchHitDensity() {
+            // One bucket per few pixels, that is as fine as it can be seen
+            let bucketCount = Math.max(1, Math.floor(verticalScrollbar.height / 3))
+            internal.searchHitDensity = root.bookController.getSearchHitDensity(
+                        bucketCount)
+        }
 
         function openSelectionOptionsPopup(centerX, bottomY) {
             if (centerX === -1 && bottomY === -1) {
@@ -310,20 +379,20 @@ Pane {
         }
 
         function openPopupAt(popup, centerX, bottomY) {
-            let pageYOffset = pageView.contentY - activeFocusItem.y
-            let pageXOffset = pageView.contentX - activeFocusItem.x
-
-            let posY = bottomY + -pageYOffset + 6
-            let spaceToBottom = (pageView.y + root.height) - (posY + popup.height)
+            // The positions are relative to the document canvas
+            let posY = bottomY + documentCanvas.y + 6
+            let spaceToBottom = (documentCanvas.y + root.height) - (posY + popup.height)
             if (spaceToBottom < 0)
                 posY = posY + spaceToBottom
 
-            let posX = centerX + pageView.x - popup.width / 2 - pageXOffset
-            let spaceToRight = (pageView.x + pageView.width) - (posX + popup.width)
+            let posX = centerX + documentCanvas.x - popup.width / 2
+            let spaceToRight = (documentCanvas.x + documentCanvas.width) - (posX + popup.width)
             if (spaceToRight < 0)
                 posX = posX + spaceToRight
 
-            let spaceToLeft = (pageView.x + pageView.width) - (posX + popup.width)
+            let spaceToLeft = posX - documentCanvas.x
+            if (spaceToLeft < 0)
+                posX = documentCanvas.x
 
             popup.x = posX
             popup.y = posY
@@ -335,5 +404,24 @@ Pane {
             mouseArea.cursorShape = Qt.ArrowCursor
             hideCursorTimer.restart()
         }
+
+        // Prefetch the pages ahead of the scroll direction, the amount depends
+        // on the scrolling speed in pages per second.
+        function prefetchPages() {
+            let now = Date.now()
+            let elapsedSeconds = (now - internal.lastContentYTime) / 1000
+            let scrolledPixels = documentCanvas.contentY - internal.lastContentY
+            internal.lastContentY = documentCanvas.contentY
+            internal.lastContentYTime = now
+
+            let pageCount = root.bookController.pageCount
+            if (elapsedSeconds <= 0 || pageCount <= 0)
+                return
+
+            let pageHeight = documentCanvas.contentHeight / pageCount
+            let pagesPerSecond = scrolledPixels / pageHeight / elapsedSeconds
+            root.bookController.prefetchPages(
+                        root.bookController.currentPage, pagesPerSecond)
+        }
     }
 }
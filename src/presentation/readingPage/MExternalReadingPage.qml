@@ -200,6 +200,8 @@ Page {
                                           lastWidth = width
                     onSwitchPage: (pageNumber, yOffset) => documentView.setPage(
                                       pageNumber, yOffset)
+                    onPageHovered: pageNumber => ExternalBookController.prefetchPage(
+                                       pageNumber)
 
                     Rectangle {
                         id: rightChaptersBorder
@@ -235,6 +237,9 @@ Page {
                     Layout.fillWidth: true
                     Layout.fillHeight: true
                     bookController: ExternalBookController
+
+                    onLoadingAborted: loadPage(homePage, sidebar.homeItem,
+                                               false)
                 }
             }
         }
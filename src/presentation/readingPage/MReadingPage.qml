@@ -242,6 +242,8 @@ Page {
                                           lastWidth = width
                     onSwitchPage: (pageNumber, yOffset) => documentView.setPage(
                                       pageNumber, yOffset)
+                    onPageHovered: pageNumber => BookController.prefetchPage(
+                                       pageNumber)
 
                     Rectangle {
                         id: rightChaptersBorder
@@ -311,6 +313,9 @@ Page {
                     Layout.fillWidth: true
                     Layout.fillHeight: true
                     bookController: BookController
+
+                    onLoadingAborted: loadPage(homePage, sidebar.homeItem,
+                                               false)
                 }
             }
         }
@@ -23,6 +23,7 @@ Item {
         if (visible) {
             inputField.forceActiveFocus()
         } else {
+            searchAsYouTypeTimer.stop()
             root.clearQuery()
             inputField.clear()
             inputField.previousText = ""
@@ -146,7 +147,10 @@ Item {
                                 color: "transparent"
                             }
 
-                            onTextEdited: internal.resetSearchError()
+                            onTextEdited: {
+                                internal.resetSearchError()
+                                searchAsYouTypeTimer.restart()
+                            }
 
                             Keys.onReturnPressed: {
                                 // When clicking Enter without changing the text, go to the next hit
@@ -155,6 +159,7 @@ Item {
                                     return
                                 }
 
+                                searchAsYouTypeTimer.stop()
                                 root.searchQueried(text)
                                 previousText = text
                             }
@@ -203,6 +208,25 @@ Item {
         }
     }
 
+    // Search while typing, once the user paused for a moment. Searching runs in
+    // the background and a new search cancels the previous one.
+    Timer {
+        id: searchAsYouTypeTimer
+        interval: 250
+
+        onTriggered: {
+            if (inputField.text === inputField.previousText)
+                return
+
+            if (inputField.text === "")
+                root.clearQuery()
+            else
+                root.searchQueried(inputField.text)
+
+            inputField.previousText = inputField.text
+        }
+    }
+
     MReadingSearchbarOptionsPopup {
         id: optionsPopup
         x: optionsButton.x + 8
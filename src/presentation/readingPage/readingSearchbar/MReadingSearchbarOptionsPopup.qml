@@ -82,6 +82,20 @@ Popup {
 
                     onCheckedChanged: internal.updateSearchOptions()
                 }
+
+                MLabeledCheckBox {
+                    id: regularExpressionBox
+                    Layout.fillWidth: true
+                    boxWidth: 18
+                    boxHeight: 18
+                    spacing: 8
+                    imageSize: 10
+                    checked: BookController.searchRegularExpression
+                    text: qsTr("Regular expression")
+                    fontSize: Fonts.size12
+
+                    onCheckedChanged: internal.updateSearchOptions()
+                }
             }
         }
 
@@ -102,6 +116,7 @@ Popup {
         function updateSearchOptions() {
             BookController.searchWholeWords = wholeWordsBox.checked
             BookController.searchCaseSensitive = caseSensitiveBox.checked
+            BookController.searchRegularExpression = regularExpressionBox.checked
             BookController.searchFromStart = fromStartBox.checked
             root.settingsChanged()
         }
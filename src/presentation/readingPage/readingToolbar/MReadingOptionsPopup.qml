@@ -7,6 +7,7 @@ import Librum.controllers
 import Librum.style
 import Librum.icons
 import Librum.fonts
+import ".."
 
 Popup {
     id: root
@@ -107,33 +108,11 @@ Popup {
                     Layout.bottomMargin: 16
                     spacing: 10
 
-                    MButton {
-                        id: invertColorsButton
+                    MColorThemeSelector {
+                        id: colorThemeSelector
                         Layout.fillWidth: true
-                        Layout.preferredHeight: 21
-                        centerContentHorizontally: false
-                        backgroundColor: "transparent"
-                        opacityOnPressed: 0.7
-                        borderWidth: 0
-                        text: qsTr("Invert colors")
-                        textColor: Style.colorText
-                        fontSize: Fonts.size12
-                        fontWeight: Font.Medium
-                        imagePath: Icons.readingOptionsInvertColor
-                        imageSize: 24
-                        imageSpacing: 6
-                        imageLeftMargin: -1
-
-                        onClicked: {
-                            let value = ""
-                            let current = BookController.colorTheme
-                            if (current === "Inverted")
-                                value = "Normal"
-                            else
-                                value = "Inverted"
-
-                            BookController.colorTheme = value
-                        }
+                        Layout.rightMargin: 14
+                        bookController: BookController
                     }
 
                     MButton {
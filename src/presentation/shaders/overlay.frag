@@ -0,0 +1,11 @@
+#version 440
+
+layout(location = 0) in vec4 color;
+
+layout(location = 0) out vec4 fragColor;
+
+void main()
+{
+    // The multiply blending is done by the pipeline's blend state
+    fragColor = color;
+}
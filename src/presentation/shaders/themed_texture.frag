@@ -0,0 +1,24 @@
+#version 440
+
+layout(location = 0) in vec2 texCoord;
+
+layout(location = 0) out vec4 fragColor;
+
+layout(std140, binding = 0) uniform buf {
+    mat4 qt_Matrix;
+    mat4 colorMatrix;
+    float qt_Opacity;
+};
+
+layout(binding = 1) uniform sampler2D qt_Texture;
+
+void main()
+{
+    // The color matrix works on straight (not premultiplied) colors. Its last
+    // column is added to the color, which allows e.g. inverting via 1 - color.
+    vec4 color = texture(qt_Texture, texCoord);
+    vec3 rgb = color.a > 0.0 ? color.rgb / color.a : color.rgb;
+    rgb = clamp((colorMatrix * vec4(rgb, 1.0)).rgb, 0.0, 1.0);
+
+    fragColor = vec4(rgb * color.a, color.a) * qt_Opacity;
+}
@@ -0,0 +1,18 @@
+#version 440
+
+layout(location = 0) in vec4 vertexCoord;
+layout(location = 1) in vec2 vertexTexCoord;
+
+layout(location = 0) out vec2 texCoord;
+
+layout(std140, binding = 0) uniform buf {
+    mat4 qt_Matrix;
+    mat4 colorMatrix;
+    float qt_Opacity;
+};
+
+void main()
+{
+    texCoord = vertexTexCoord;
+    gl_Position = qt_Matrix * vertexCoord;
+}
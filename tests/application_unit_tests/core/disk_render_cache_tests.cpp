@@ -0,0 +1,187 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <QFile>
+#include <QImage>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include "rendering/disk_render_cache.hpp"
+
+
+using namespace testing;
+using namespace application::core;
+
+namespace tests::application
+{
+
+struct ADiskRenderCache : public ::testing::Test
+{
+    QImage createImage(int width, int height, QColor color = Qt::white)
+    {
+        QImage image(width, height, QImage::Format_RGBA8888_Premultiplied);
+        image.fill(color);
+        return image;
+    }
+
+    RenderCacheKey createKey(int pageNumber, float zoom = 1)
+    {
+        return RenderCacheKey {
+            .pageNumber = pageNumber,
+            .zoom = zoom,
+            .dpr = 1,
+        };
+    }
+
+    void writeBookFile(const QByteArray& content)
+    {
+        QFile bookFile(bookFilePath);
+        bookFile.open(QFile::WriteOnly);
+        bookFile.write(content);
+    }
+
+    QTemporaryDir directory;
+    QTemporaryDir bookDirectory;
+    QString bookFilePath = bookDirectory.filePath("book.pdf");
+};
+
+TEST_F(ADiskRenderCache, SucceedsLoadingAStoredImage)
+{
+    // Arrange
+    DiskRenderCache diskRenderCache(directory.path());
+    diskRenderCache.setUp("some_book", bookFilePath);
+    auto image = createImage(20, 30, Qt::red);
+
+
+    // Act
+    diskRenderCache.storeImage(createKey(3), image);
+    diskRenderCache.waitForPendingWrites();
+
+    auto result = diskRenderCache.getImage(createKey(3));
+
+    // Assert
+    EXPECT_EQ(image, result);
+}
+
+TEST_F(ADiskRenderCache, SucceedsLoadingImagesAfterBeingRecreated)
+{
+    // Arrange
+    auto image = createImage(20, 30);
+    {
+        DiskRenderCache diskRenderCache(directory.path());
+        diskRenderCache.setUp("some_book", bookFilePath);
+        diskRenderCache.storeImage(createKey(3), image);
+    }
+
+    DiskRenderCache diskRenderCache(directory.path());
+
+
+    // Act
+    diskRenderCache.setUp("some_book", bookFilePath);
+
+    // Assert
+    EXPECT_TRUE(diskRenderCache.containsImage(createKey(3)));
+    EXPECT_EQ(image, diskRenderCache.getImage(createKey(3)));
+}
+
+TEST_F(ADiskRenderCache, FailsGettingImagesOfOtherBooksOrZooms)
+{
+    // Arrange
+    DiskRenderCache diskRenderCache(directory.path());
+    diskRenderCache.setUp("some_book", bookFilePath);
+    diskRenderCache.storeImage(createKey(3), createImage(20, 30));
+    diskRenderCache.waitForPendingWrites();
+
+
+    // Act
+    auto otherZoom = diskRenderCache.getImage(createKey(3, 1.5));
+    diskRenderCache.setUp("other_book", bookFilePath);
+    auto otherBook = diskRenderCache.getImage(createKey(3));
+
+    // Assert
+    EXPECT_TRUE(otherZoom.isNull());
+    EXPECT_TRUE(otherBook.isNull());
+}
+
+TEST_F(ADiskRenderCache, SucceedsEvictingImagesWhenExceedingTheCapacity)
+{
+    // Arrange
+    DiskRenderCache diskRenderCache(directory.path(), 1);
+    diskRenderCache.setUp("some_book", bookFilePath);
+
+
+    // Act
+    diskRenderCache.storeImage(createKey(1), createImage(20, 30));
+    diskRenderCache.waitForPendingWrites();
+
+    // Assert
+    EXPECT_FALSE(diskRenderCache.containsImage(createKey(1)));
+    EXPECT_TRUE(diskRenderCache.getImage(createKey(1)).isNull());
+}
+
+TEST_F(ADiskRenderCache, SucceedsLoadingAStoredImageInTheBackground)
+{
+    // Arrange
+    DiskRenderCache diskRenderCache(directory.path());
+    diskRenderCache.setUp("some_book", bookFilePath);
+    QSignalSpy spy(&diskRenderCache, &DiskRenderCache::imageLoaded);
+    auto image = createImage(20, 30, Qt::red);
+    diskRenderCache.storeImage(createKey(3), image);
+
+
+    // Act
+    auto missingTicket = diskRenderCache.loadImage(createKey(4));
+    auto ticket = diskRenderCache.loadImage(createKey(3));
+    diskRenderCache.waitForPendingWrites();
+
+    // Assert
+    EXPECT_EQ(0, missingTicket);
+    ASSERT_EQ(1, spy.count());
+    EXPECT_EQ(ticket, spy[0][0].value<quint64>());
+    EXPECT_EQ(image, spy[0][1].value<QImage>());
+}
+
+TEST_F(ADiskRenderCache, SucceedsRemovingImagesOnceTheBookFileChanged)
+{
+    // Arrange
+    writeBookFile("first version");
+    DiskRenderCache diskRenderCache(directory.path());
+    diskRenderCache.setUp("some_book", bookFilePath);
+    diskRenderCache.storeImage(createKey(3), createImage(20, 30));
+    diskRenderCache.waitForPendingWrites();
+
+
+    // Act
+    diskRenderCache.setUp("some_book", bookFilePath);
+    bool containsBeforeChange = diskRenderCache.containsImage(createKey(3));
+
+    writeBookFile("second, longer version");
+    diskRenderCache.setUp("some_book", bookFilePath);
+
+    // Assert
+    EXPECT_TRUE(containsBeforeChange);
+    EXPECT_FALSE(diskRenderCache.containsImage(createKey(3)));
+    EXPECT_EQ(0, diskRenderCache.getSize());
+}
+
+TEST_F(ADiskRenderCache, SucceedsTrackingTheSizeOfTheStoredImages)
+{
+    // Arrange
+    qint64 size = 0;
+    {
+        DiskRenderCache diskRenderCache(directory.path());
+        diskRenderCache.setUp("some_book", bookFilePath);
+        diskRenderCache.storeImage(createKey(1), createImage(20, 30));
+        diskRenderCache.storeImage(createKey(2), createImage(40, 60));
+        diskRenderCache.waitForPendingWrites();
+        size = diskRenderCache.getSize();
+    }
+
+
+    // Act
+    DiskRenderCache diskRenderCache(directory.path());
+
+    // Assert
+    EXPECT_GT(size, 0);
+    EXPECT_EQ(size, diskRenderCache.getSize());
+}
+
+}  // namespace tests::application
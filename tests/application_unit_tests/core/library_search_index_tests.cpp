@@ -0,0 +1,119 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <QBuffer>
+#include <QDataStream>
+#include <QRectF>
+#include <QUuid>
+#include "library_search_index.hpp"
+#include "search_index.hpp"
+
+
+using namespace testing;
+using namespace application::core::utils;
+
+namespace tests::application
+{
+
+class ALibrarySearchIndex : public ::testing::Test
+{
+public:
+    SearchIndex createBookIndex(const QStringList& words)
+    {
+        SearchIndex index;
+        for(auto& word : words)
+            index.addWord(0, word, QRectF());
+        index.setPageCount(1);
+
+        return index;
+    }
+
+    LibrarySearchIndex libraryIndex;
+};
+
+TEST_F(ALibrarySearchIndex, SucceedsRankingBooksByRelevance)
+{
+    // Arrange
+    auto firstBook = QUuid::createUuid();
+    auto secondBook = QUuid::createUuid();
+    auto thirdBook = QUuid::createUuid();
+    libraryIndex.addBook(firstBook, "1", createBookIndex({ "whale", "sea" }));
+    libraryIndex.addBook(secondBook, "2",
+                         createBookIndex({ "whale", "whale", "whale" }));
+    libraryIndex.addBook(thirdBook, "3", createBookIndex({ "garden" }));
+
+
+    // Act
+    auto result = libraryIndex.search("Whale", 10);
+
+    // Assert
+    ASSERT_EQ(2, result.size());
+    EXPECT_EQ(secondBook, result[0].uuid);
+    EXPECT_EQ(firstBook, result[1].uuid);
+    EXPECT_GT(result[0].score, result[1].score);
+}
+
+TEST_F(ALibrarySearchIndex, SucceedsFindingBooksContainingAllTermsByPrefix)
+{
+    // Arrange
+    auto firstBook = QUuid::createUuid();
+    auto secondBook = QUuid::createUuid();
+    libraryIndex.addBook(firstBook, "1",
+                         createBookIndex({ "libraries", "books" }));
+    libraryIndex.addBook(secondBook, "2", createBookIndex({ "library" }));
+
+
+    // Act
+    auto result = libraryIndex.search("libr book", 10);
+
+    // Assert
+    ASSERT_EQ(1, result.size());
+    EXPECT_EQ(firstBook, result[0].uuid);
+}
+
+TEST_F(ALibrarySearchIndex, SucceedsReplacingAndRemovingBooks)
+{
+    // Arrange
+    auto firstBook = QUuid::createUuid();
+    auto secondBook = QUuid::createUuid();
+    libraryIndex.addBook(firstBook, "1", createBookIndex({ "whale" }));
+    libraryIndex.addBook(secondBook, "2", createBookIndex({ "whale" }));
+
+
+    // Act
+    libraryIndex.addBook(firstBook, "3", createBookIndex({ "garden" }));
+    libraryIndex.removeBook(secondBook);
+
+    // Assert
+    EXPECT_EQ(1, libraryIndex.getBookCount());
+    EXPECT_TRUE(libraryIndex.containsBook(firstBook, "3"));
+    EXPECT_FALSE(libraryIndex.containsBook(firstBook, "1"));
+    EXPECT_FALSE(libraryIndex.containsBook(secondBook, "2"));
+    EXPECT_TRUE(libraryIndex.search("whale", 10).isEmpty());
+    EXPECT_EQ(1, libraryIndex.search("garden", 10).size());
+}
+
+TEST_F(ALibrarySearchIndex, SucceedsRoundTrippingThroughADataStream)
+{
+    // Arrange
+    auto book = QUuid::createUuid();
+    libraryIndex.addBook(book, "1", createBookIndex({ "whale", "sea" }));
+
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+
+
+    // Act
+    QDataStream stream(&buffer);
+    stream << libraryIndex;
+    buffer.seek(0);
+
+    LibrarySearchIndex result;
+    stream >> result;
+
+    // Assert
+    EXPECT_TRUE(result.containsBook(book, "1"));
+    ASSERT_EQ(1, result.search("sea", 10).size());
+    EXPECT_EQ(book, result.search("sea", 10).first().uuid);
+}
+
+}  // namespace tests::application
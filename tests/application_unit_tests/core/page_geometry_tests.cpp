@@ -0,0 +1,115 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <QList>
+#include <QSize>
+#include "layout/page_geometry.hpp"
+
+
+using namespace testing;
+using namespace application::core;
+
+namespace tests::application
+{
+
+TEST(APageGeometry, SucceedsGettingThePageTops)
+{
+    // Arrange
+    PageGeometry pageGeometry({ QSize(100, 200), QSize(100, 300),
+                                QSize(150, 100) });
+
+
+    // Act
+    auto firstTop = pageGeometry.getPageTop(0, 1, 10);
+    auto secondTop = pageGeometry.getPageTop(1, 1, 10);
+    auto thirdTop = pageGeometry.getPageTop(2, 1, 10);
+
+    // Assert
+    EXPECT_EQ(0, firstTop);
+    EXPECT_EQ(210, secondTop);
+    EXPECT_EQ(520, thirdTop);
+}
+
+TEST(APageGeometry, SucceedsGettingThePageTopsWithZoomApplied)
+{
+    // Arrange
+    PageGeometry pageGeometry({ QSize(100, 200), QSize(100, 300),
+                                QSize(150, 100) });
+
+
+    // Act
+    auto thirdTop = pageGeometry.getPageTop(2, 2, 10);
+    auto contentHeight = pageGeometry.getContentHeight(2, 10);
+
+    // Assert
+    EXPECT_EQ(1020, thirdTop);
+    EXPECT_EQ(1220, contentHeight);
+}
+
+TEST(APageGeometry, SucceedsGettingThePageAtAPosition)
+{
+    // Arrange
+    PageGeometry pageGeometry({ QSize(100, 200), QSize(100, 300),
+                                QSize(150, 100) });
+
+
+    // Act
+    auto firstPage = pageGeometry.getPageAtY(0, 1, 10);
+    auto pageBeforeSpacing = pageGeometry.getPageAtY(205, 1, 10);
+    auto secondPage = pageGeometry.getPageAtY(210, 1, 10);
+    auto lastPage = pageGeometry.getPageAtY(5000, 1, 10);
+    auto pageAboveStart = pageGeometry.getPageAtY(-50, 1, 10);
+
+    // Assert
+    EXPECT_EQ(0, firstPage);
+    EXPECT_EQ(0, pageBeforeSpacing);
+    EXPECT_EQ(1, secondPage);
+    EXPECT_EQ(2, lastPage);
+    EXPECT_EQ(0, pageAboveStart);
+}
+
+TEST(APageGeometry, SucceedsUpdatingTheOffsetsWhenAPageSizeChanges)
+{
+    // Arrange
+    PageGeometry pageGeometry({ QSize(100, 200), QSize(100, 200),
+                                QSize(100, 200) });
+
+
+    // Act
+    pageGeometry.setPageSize(1, QSize(300, 400));
+
+    // Assert
+    EXPECT_EQ(200, pageGeometry.getPageTop(1, 1, 0));
+    EXPECT_EQ(600, pageGeometry.getPageTop(2, 1, 0));
+    EXPECT_EQ(300, pageGeometry.getMaxPageWidth());
+}
+
+TEST(APageGeometry, SucceedsRoundTrippingThroughJson)
+{
+    // Arrange
+    QList<QSize> pageSizes { QSize(100, 200), QSize(120, 300) };
+    PageGeometry pageGeometry(pageSizes);
+
+
+    // Act
+    auto result = PageGeometry::fromJson(pageGeometry.toJson());
+
+    // Assert
+    EXPECT_EQ(pageSizes, result.getPageSizes());
+    EXPECT_EQ(500, result.getContentHeight(1, 0));
+}
+
+TEST(APageGeometry, FailsFindingAPageIfItIsEmpty)
+{
+    // Arrange
+    PageGeometry pageGeometry;
+
+
+    // Act
+    auto result = pageGeometry.getPageAtY(100, 1, 10);
+
+    // Assert
+    EXPECT_EQ(-1, result);
+    EXPECT_EQ(0, pageGeometry.getContentHeight(1, 10));
+}
+
+}  // namespace tests::application
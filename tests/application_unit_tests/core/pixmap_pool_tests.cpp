@@ -0,0 +1,119 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <QImage>
+#include "rendering/pixmap_pool.hpp"
+
+
+using namespace testing;
+using namespace application::core;
+
+namespace tests::application
+{
+
+TEST(APixmapPool, SucceedsCreatingATightlyPackedImage)
+{
+    // Arrange
+    PixmapPool pixmapPool;
+
+
+    // Act
+    auto image = pixmapPool.createImage(QSize(13, 7));
+
+    // Assert
+    EXPECT_EQ(QSize(13, 7), image.size());
+    EXPECT_EQ(13 * 4, image.bytesPerLine());
+    EXPECT_EQ(QImage::Format_RGBA8888_Premultiplied, image.format());
+}
+
+TEST(APixmapPool, FailsCreatingAnEmptyImage)
+{
+    // Arrange
+    PixmapPool pixmapPool;
+
+
+    // Act
+    auto image = pixmapPool.createImage(QSize(0, 10));
+
+    // Assert
+    EXPECT_TRUE(image.isNull());
+}
+
+TEST(APixmapPool, SucceedsReusingTheBufferOfADestroyedImage)
+{
+    // Arrange
+    PixmapPool pixmapPool;
+    auto image = pixmapPool.createImage(QSize(10, 10));
+    const uchar* bits = image.constBits();
+
+
+    // Act
+    image = QImage();
+    auto result = pixmapPool.createImage(QSize(10, 10));
+
+    // Assert
+    EXPECT_EQ(bits, result.constBits());
+    EXPECT_EQ(0, pixmapPool.getPooledSize());
+}
+
+TEST(APixmapPool, SucceedsKeepingTheBufferWhileACopyOfTheImageExists)
+{
+    // Arrange
+    PixmapPool pixmapPool;
+    auto image = pixmapPool.createImage(QSize(10, 10));
+    auto copy = image;
+
+
+    // Act
+    image = QImage();
+
+    // Assert
+    EXPECT_EQ(0, pixmapPool.getPooledSize());
+    EXPECT_FALSE(copy.isNull());
+}
+
+TEST(APixmapPool, FailsReusingABufferThatIsMuchLarger)
+{
+    // Arrange
+    PixmapPool pixmapPool;
+    pixmapPool.createImage(QSize(100, 100));
+
+
+    // Act
+    auto result = pixmapPool.createImage(QSize(10, 10));
+
+    // Assert
+    EXPECT_EQ(100 * 100 * 4, pixmapPool.getPooledSize());
+}
+
+TEST(APixmapPool, SucceedsStayingWithinItsCapacity)
+{
+    // Arrange
+    PixmapPool pixmapPool(10 * 10 * 4);
+
+
+    // Act
+    pixmapPool.createImage(QSize(10, 10));
+    pixmapPool.createImage(QSize(20, 20));
+
+    // Assert
+    EXPECT_EQ(10 * 10 * 4, pixmapPool.getPooledSize());
+}
+
+TEST(APixmapPool, SucceedsReleasingImagesThatOutliveThePool)
+{
+    // Arrange
+    QImage image;
+    {
+        PixmapPool pixmapPool;
+        image = pixmapPool.createImage(QSize(10, 10));
+    }
+
+
+    // Act
+    image.fill(Qt::white);
+
+    // Assert
+    EXPECT_EQ(QColor(Qt::white), image.pixelColor(0, 0));
+}
+
+}  // namespace tests::application
@@ -0,0 +1,155 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <QImage>
+#include "rendering/render_cache.hpp"
+
+
+using namespace testing;
+using namespace application::core;
+
+namespace tests::application
+{
+
+struct ARenderCache : public ::testing::Test
+{
+    QImage createImage(int width, int height)
+    {
+        // 4 bytes per pixel, so the size in bytes is width * height * 4
+        QImage image(width, height, QImage::Format_RGB32);
+        image.fill(Qt::white);
+        return image;
+    }
+
+    RenderCacheKey createKey(int pageNumber, float zoom = 1)
+    {
+        return RenderCacheKey {
+            .pageNumber = pageNumber,
+            .zoom = zoom,
+            .dpr = 1,
+        };
+    }
+};
+
+TEST_F(ARenderCache, SucceedsGettingAnInsertedImage)
+{
+    // Arrange
+    RenderCache renderCache(1024 * 1024);
+    auto image = createImage(10, 10);
+
+
+    // Act
+    renderCache.insertImage(createKey(3), image);
+    auto result = renderCache.getImage(createKey(3));
+
+    // Assert
+    EXPECT_EQ(image, result);
+    EXPECT_EQ(image.sizeInBytes(), renderCache.getImageCacheSize());
+}
+
+TEST_F(ARenderCache, FailsGettingAnImageWithADifferentKey)
+{
+    // Arrange
+    RenderCache renderCache(1024 * 1024);
+    renderCache.insertImage(createKey(3, 1), createImage(10, 10));
+
+
+    // Act
+    auto otherPage = renderCache.getImage(createKey(4, 1));
+    auto otherZoom = renderCache.getImage(createKey(3, 1.5));
+
+    // Assert
+    EXPECT_TRUE(otherPage.isNull());
+    EXPECT_TRUE(otherZoom.isNull());
+}
+
+TEST_F(ARenderCache, SucceedsEvictingTheLeastRecentlyUsedImage)
+{
+    // Arrange
+    RenderCache renderCache(3 * 10 * 10 * 4);
+    renderCache.insertImage(createKey(1), createImage(10, 10));
+    renderCache.insertImage(createKey(2), createImage(10, 10));
+    renderCache.insertImage(createKey(3), createImage(10, 10));
+
+    // Using the first image makes the second one the least recently used one
+    renderCache.getImage(createKey(1));
+
+
+    // Act
+    renderCache.insertImage(createKey(4), createImage(10, 10));
+
+    // Assert
+    EXPECT_FALSE(renderCache.getImage(createKey(1)).isNull());
+    EXPECT_TRUE(renderCache.getImage(createKey(2)).isNull());
+    EXPECT_FALSE(renderCache.getImage(createKey(3)).isNull());
+    EXPECT_FALSE(renderCache.getImage(createKey(4)).isNull());
+}
+
+TEST_F(ARenderCache, SucceedsEvictingImagesWhenTheBudgetIsLowered)
+{
+    // Arrange
+    RenderCache renderCache(1024 * 1024);
+    renderCache.insertImage(createKey(1), createImage(10, 10));
+    renderCache.insertImage(createKey(2), createImage(10, 10));
+
+
+    // Act
+    renderCache.setImageBudget(10 * 10 * 4);
+
+    // Assert
+    EXPECT_TRUE(renderCache.getImage(createKey(1)).isNull());
+    EXPECT_FALSE(renderCache.getImage(createKey(2)).isNull());
+    EXPECT_EQ(10 * 10 * 4, renderCache.getImageCacheSize());
+}
+
+TEST_F(ARenderCache, FailsInsertingAnImageLargerThanTheBudget)
+{
+    // Arrange
+    RenderCache renderCache(10 * 10 * 4);
+    renderCache.insertImage(createKey(1), createImage(10, 10));
+
+
+    // Act
+    renderCache.insertImage(createKey(2), createImage(20, 20));
+
+    // Assert
+    EXPECT_FALSE(renderCache.getImage(createKey(1)).isNull());
+    EXPECT_TRUE(renderCache.getImage(createKey(2)).isNull());
+}
+
+TEST_F(ARenderCache, SucceedsCheckingForImagesWithoutMarkingThemAsUsed)
+{
+    // Arrange
+    RenderCache renderCache(2 * 10 * 10 * 4);
+    renderCache.insertImage(createKey(1), createImage(10, 10));
+    renderCache.insertImage(createKey(2), createImage(10, 10));
+
+
+    // Act
+    bool containsFirst = renderCache.containsImage(createKey(1));
+    bool containsOther = renderCache.containsImage(createKey(4));
+    renderCache.insertImage(createKey(3), createImage(10, 10));
+
+    // Assert
+    EXPECT_TRUE(containsFirst);
+    EXPECT_FALSE(containsOther);
+    EXPECT_FALSE(renderCache.containsImage(createKey(1)));
+    EXPECT_TRUE(renderCache.containsImage(createKey(2)));
+    EXPECT_FALSE(renderCache.containsImageOnDisk(createKey(2)));
+}
+
+TEST_F(ARenderCache, SucceedsClearingAllEntries)
+{
+    // Arrange
+    RenderCache renderCache(1024 * 1024);
+    renderCache.insertImage(createKey(1), createImage(10, 10));
+
+
+    // Act
+    renderCache.clear();
+
+    // Assert
+    EXPECT_TRUE(renderCache.getImage(createKey(1)).isNull());
+    EXPECT_EQ(0, renderCache.getImageCacheSize());
+}
+
+}  // namespace tests::application
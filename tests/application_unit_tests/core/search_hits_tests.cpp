@@ -0,0 +1,132 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <vector>
+#include "search_hits.hpp"
+
+
+using namespace testing;
+using namespace application::core::utils;
+
+namespace tests::application
+{
+
+class ASearchHits : public ::testing::Test
+{
+public:
+    std::vector<mupdf::FzQuad> createQuads(int count)
+    {
+        std::vector<mupdf::FzQuad> quads;
+        for(int i = 0; i < count; ++i)
+        {
+            fz_rect rect { 0, i * 10.0f, 50, i * 10.0f + 8 };
+            quads.push_back(mupdf::FzQuad(mupdf::ll_fz_quad_from_rect(rect)));
+        }
+
+        return quads;
+    }
+
+    SearchHits searchHits;
+};
+
+TEST_F(ASearchHits, SucceedsKeepingPagesSortedWhenAddedOutOfOrder)
+{
+    // Arrange
+    searchHits.addPageHits(7, createQuads(2));
+    searchHits.addPageHits(9, createQuads(1));
+
+
+    // Act
+    searchHits.addPageHits(2, createQuads(3));
+
+    // Assert
+    EXPECT_EQ(6, searchHits.getHitCount());
+    EXPECT_EQ(3, searchHits.getPageHits(2).size());
+    EXPECT_TRUE(searchHits.getPageHits(3).empty());
+
+    SearchHits::Position expected { 2, 0 };
+    EXPECT_EQ(expected, searchHits.findFirstFrom(0));
+}
+
+TEST_F(ASearchHits, SucceedsFindingTheFirstHitFromAPageWrappingAround)
+{
+    // Arrange
+    searchHits.addPageHits(3, createQuads(1));
+    searchHits.addPageHits(8, createQuads(2));
+
+
+    // Act
+    auto fromBetween = searchHits.findFirstFrom(4);
+    auto fromAfterLast = searchHits.findFirstFrom(9);
+    auto upToBetween = searchHits.findLastUpTo(7);
+    auto upToBeforeFirst = searchHits.findLastUpTo(1);
+
+    // Assert
+    EXPECT_EQ((SearchHits::Position { 8, 0 }), fromBetween);
+    EXPECT_EQ((SearchHits::Position { 3, 0 }), fromAfterLast);
+    EXPECT_EQ((SearchHits::Position { 3, 0 }), upToBetween);
+    EXPECT_EQ((SearchHits::Position { 8, 1 }), upToBeforeFirst);
+}
+
+TEST_F(ASearchHits, SucceedsNavigatingAcrossPages)
+{
+    // Arrange
+    searchHits.addPageHits(1, createQuads(2));
+    searchHits.addPageHits(5, createQuads(1));
+    SearchHits::Position position { 1, 1 };
+
+
+    // Act
+    auto next = searchHits.findNext(position);
+    auto afterLast = searchHits.findNext(next);
+    auto beforeFirst = searchHits.findPrevious(afterLast);
+
+    // Assert
+    EXPECT_EQ((SearchHits::Position { 5, 0 }), next);
+    EXPECT_EQ((SearchHits::Position { 1, 0 }), afterLast);
+    EXPECT_EQ((SearchHits::Position { 5, 0 }), beforeFirst);
+    EXPECT_EQ(5, searchHits.getHit(next).pageNumber);
+}
+
+TEST_F(ASearchHits, SucceedsComputingTheDensityOfHits)
+{
+    // Arrange
+    searchHits.addPageHits(0, createQuads(1));
+    searchHits.addPageHits(1, createQuads(1));
+    searchHits.addPageHits(9, createQuads(4));
+
+
+    // Act
+    auto result = searchHits.getDensity(10, 5);
+
+    // Assert
+    QList<qreal> expected { 0.5, 0, 0, 0, 1 };
+    EXPECT_EQ(expected, result);
+}
+
+TEST_F(ASearchHits, SucceedsMovingHitRectsToThePagesCropBox)
+{
+    // Arrange
+    searchHits.addPageHits(4, createQuads(2));
+
+
+    // Act
+    auto rects = searchHits.getPageHitRects(4, QPoint(20, 30), 2);
+
+    // Assert
+    ASSERT_EQ(2, rects.size());
+    EXPECT_EQ(QRectF(-40, -60, 100, 16), rects[0]);
+    EXPECT_EQ(QRectF(-40, -40, 100, 16), rects[1]);
+}
+
+TEST_F(ASearchHits, FailsFindingHitsWhenThereAreNone)
+{
+    // Act
+    auto first = searchHits.findFirstFrom(0);
+    auto hit = searchHits.getHit(first);
+
+    // Assert
+    EXPECT_FALSE(first.isValid());
+    EXPECT_EQ(-1, hit.pageNumber);
+}
+
+}  // namespace tests::application
@@ -0,0 +1,144 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <QBuffer>
+#include <QDataStream>
+#include <QRectF>
+#include "search_index.hpp"
+
+
+using namespace testing;
+using namespace application::core::utils;
+
+namespace tests::application
+{
+
+TEST(ASearchIndex, SucceedsFindingAWordCaseInsensitively)
+{
+    // Arrange
+    SearchIndex searchIndex;
+    searchIndex.addWord(0, "Hello", QRectF(10, 10, 50, 12));
+    searchIndex.addWord(0, "world", QRectF(70, 10, 50, 12));
+    searchIndex.addWord(3, "HELLO", QRectF(10, 40, 50, 12));
+
+
+    // Act
+    auto result = searchIndex.findWord("hello");
+
+    // Assert
+    ASSERT_EQ(2, result.size());
+    EXPECT_EQ(0, result[0].pageNumber);
+    EXPECT_EQ(QRectF(10, 10, 50, 12), result[0].rect);
+    EXPECT_EQ(3, result[1].pageNumber);
+}
+
+TEST(ASearchIndex, SucceedsFindingWordsByTheirPrefix)
+{
+    // Arrange
+    SearchIndex searchIndex;
+    searchIndex.addWord(2, "library", QRectF(10, 10, 50, 12));
+    searchIndex.addWord(1, "librarian", QRectF(10, 10, 50, 12));
+    searchIndex.addWord(1, "book", QRectF(70, 10, 50, 12));
+    searchIndex.addWord(1, "Liberty", QRectF(10, 30, 50, 12));
+
+
+    // Act
+    auto result = searchIndex.findPrefix("libr");
+
+    // Assert
+    ASSERT_EQ(2, result.size());
+    EXPECT_EQ(1, result[0].pageNumber);
+    EXPECT_EQ(2, result[1].pageNumber);
+}
+
+TEST(ASearchIndex, SucceedsFindingTheCandidatePagesOfAPhrase)
+{
+    // Arrange
+    SearchIndex searchIndex;
+    searchIndex.addWord(0, "open", QRectF());
+    searchIndex.addWord(0, "source", QRectF());
+    searchIndex.addWord(1, "reopen", QRectF());
+    searchIndex.addWord(1, "sources", QRectF());
+    searchIndex.addWord(2, "open", QRectF());
+
+
+    // Act
+    auto result = searchIndex.findCandidatePages("open-source");
+
+    // Assert
+    EXPECT_EQ(QSet<int>({ 0, 1 }), result);
+}
+
+TEST(ASearchIndex, SucceedsSplittingTextIntoTerms)
+{
+    // Arrange
+    QString text = "  Hello, World! e-mail 42";
+
+
+    // Act
+    auto result = SearchIndex::splitIntoTerms(text);
+
+    // Assert
+    QStringList expected { "hello", "world", "e", "mail", "42" };
+    EXPECT_EQ(expected, result);
+}
+
+TEST(ASearchIndex, SucceedsRoundTrippingThroughADataStream)
+{
+    // Arrange
+    SearchIndex searchIndex;
+    searchIndex.addWord(0, "hello", QRectF(10, 10, 50, 12));
+    searchIndex.addWord(4, "world", QRectF(70, 10, 50, 12));
+    searchIndex.setPageCount(5);
+
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+
+
+    // Act
+    QDataStream stream(&buffer);
+    stream << searchIndex;
+    buffer.seek(0);
+
+    SearchIndex result;
+    stream >> result;
+
+    // Assert
+    EXPECT_EQ(5, result.getPageCount());
+    EXPECT_EQ(2, result.getTermCount());
+    EXPECT_EQ(searchIndex.findWord("world"), result.findWord("world"));
+}
+
+TEST(ASearchIndex, SucceedsCreatingASnippetAroundTheText)
+{
+    // Arrange
+    SearchIndex searchIndex;
+    searchIndex.setPageText(
+        2, "Call me Ishmael.  Some years ago,\nnever mind how long precisely");
+
+
+    // Act
+    auto result = searchIndex.getSnippet(2, "years", 10);
+
+    // Assert
+    EXPECT_EQ("...Ishmael. Some years ago, never...", result);
+}
+
+TEST(ASearchIndex, FailsFindingWordsItDoesNotContain)
+{
+    // Arrange
+    SearchIndex searchIndex;
+    searchIndex.addWord(0, "hello", QRectF(10, 10, 50, 12));
+
+
+    // Act
+    auto word = searchIndex.findWord("hell");
+    auto prefix = searchIndex.findPrefix("world");
+    auto candidatePages = searchIndex.findCandidatePages("hello world");
+
+    // Assert
+    EXPECT_TRUE(word.isEmpty());
+    EXPECT_TRUE(prefix.isEmpty());
+    EXPECT_TRUE(candidatePages.isEmpty());
+}
+
+}  // namespace tests::application
@@ -0,0 +1,107 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <QPointF>
+#include <QRectF>
+#include "spatial_grid.hpp"
+
+
+using namespace testing;
+using namespace application::core::utils;
+
+namespace tests::application
+{
+
+TEST(ASpatialGrid, SucceedsFindingAnItemAtAPoint)
+{
+    // Arrange
+    SpatialGrid<int> spatialGrid(10);
+    spatialGrid.insert(1, QRectF(5, 5, 20, 10));
+    spatialGrid.insert(2, QRectF(100, 100, 10, 10));
+
+
+    // Act
+    auto result = spatialGrid.itemAt(QPointF(22, 12));
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(1, *result);
+}
+
+TEST(ASpatialGrid, FailsFindingAnItemOutsideOfAllRects)
+{
+    // Arrange
+    SpatialGrid<int> spatialGrid(10);
+    spatialGrid.insert(1, QRectF(5, 5, 20, 10));
+
+
+    // Act
+    // The point is in a cell that the rect overlaps, but not in the rect itself
+    auto result = spatialGrid.itemAt(QPointF(27, 17));
+
+    // Assert
+    EXPECT_FALSE(result.has_value());
+}
+
+TEST(ASpatialGrid, SucceedsFindingTheFirstInsertedOfOverlappingItems)
+{
+    // Arrange
+    SpatialGrid<int> spatialGrid(10);
+    spatialGrid.insert(1, QRectF(0, 0, 30, 30));
+    spatialGrid.insert(2, QRectF(10, 10, 30, 30));
+
+
+    // Act
+    auto result = spatialGrid.itemAt(QPointF(15, 15));
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(1, *result);
+}
+
+TEST(ASpatialGrid, SucceedsFindingItemsWithNegativeCoordinates)
+{
+    // Arrange
+    SpatialGrid<int> spatialGrid(10);
+    spatialGrid.insert(1, QRectF(-25, -25, 10, 10));
+
+
+    // Act
+    auto result = spatialGrid.itemAt(QPointF(-20, -20));
+
+    // Assert
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(1, *result);
+}
+
+TEST(ASpatialGrid, SucceedsRemovingAnItemWithMultipleRects)
+{
+    // Arrange
+    SpatialGrid<QString> spatialGrid(10);
+    spatialGrid.insert("first", QRectF(0, 0, 50, 10));
+    spatialGrid.insert("first", QRectF(0, 20, 50, 10));
+    spatialGrid.insert("second", QRectF(0, 40, 50, 10));
+
+
+    // Act
+    spatialGrid.remove("first");
+
+    // Assert
+    EXPECT_FALSE(spatialGrid.containsItemAt(QPointF(25, 5)));
+    EXPECT_FALSE(spatialGrid.containsItemAt(QPointF(25, 25)));
+    EXPECT_TRUE(spatialGrid.containsItemAt(QPointF(25, 45)));
+}
+
+TEST(ASpatialGrid, SucceedsIgnoringEmptyRects)
+{
+    // Arrange
+    SpatialGrid<int> spatialGrid(10);
+
+
+    // Act
+    spatialGrid.insert(1, QRectF(5, 5, 0, 10));
+
+    // Assert
+    EXPECT_TRUE(spatialGrid.isEmpty());
+}
+
+}  // namespace tests::application
@@ -0,0 +1,77 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <QBuffer>
+#include <QDataStream>
+#include <QRectF>
+#include "search_index.hpp"
+#include "term_page_index.hpp"
+
+
+using namespace testing;
+using namespace application::core::utils;
+
+namespace tests::application
+{
+
+struct ATermPageIndex : public ::testing::Test
+{
+    void SetUp() override
+    {
+        searchIndex.addWord(0, "library", QRectF());
+        searchIndex.addWord(2, "library", QRectF());
+        searchIndex.addWord(2, "Librarian", QRectF());
+        searchIndex.addWord(1, "book", QRectF());
+        searchIndex.setPageText(0, "The library");
+        searchIndex.setPageText(1, "A book");
+        searchIndex.setPageText(2, "The library and its librarian");
+        searchIndex.setPageCount(3);
+
+        buffer.open(QBuffer::ReadWrite);
+        QDataStream stream(&buffer);
+        stream.setVersion(QDataStream::Qt_6_0);
+        TermPageIndex::write(searchIndex, stream);
+        buffer.seek(0);
+    }
+
+    SearchIndex searchIndex;
+    QBuffer buffer;
+};
+
+TEST_F(ATermPageIndex, SucceedsFindingThePagesOfWordsByTheirPrefix)
+{
+    // Arrange
+    TermPageIndex termPageIndex;
+
+
+    // Act
+    bool opened = termPageIndex.open(&buffer);
+    auto result = termPageIndex.findPrefix("LIBR");
+    auto missing = termPageIndex.findPrefix("books");
+
+    // Assert
+    EXPECT_TRUE(opened);
+    ASSERT_EQ(2, result.size());
+    EXPECT_EQ(1, result.value(0));
+    EXPECT_EQ(2, result.value(2));
+    EXPECT_TRUE(missing.isEmpty());
+}
+
+TEST_F(ATermPageIndex, SucceedsReadingThePageTexts)
+{
+    // Arrange
+    TermPageIndex termPageIndex;
+    termPageIndex.open(&buffer);
+
+
+    // Act
+    auto text = termPageIndex.getPageText(2);
+    auto firstText = termPageIndex.getPageText(0);
+    auto missingText = termPageIndex.getPageText(3);
+
+    // Assert
+    EXPECT_EQ("The library and its librarian", text);
+    EXPECT_EQ("The library", firstText);
+    EXPECT_TRUE(missingText.isEmpty());
+}
+
+}  // namespace tests::application
@@ -0,0 +1,89 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <QList>
+#include <QString>
+#include "search_options.hpp"
+#include "text_matcher.hpp"
+
+
+using namespace testing;
+using namespace application::core::utils;
+
+namespace tests::application
+{
+
+TEST(ATextMatcher, SucceedsFindingTextCaseInsensitively)
+{
+    // Arrange
+    TextMatcher matcher("the", SearchOptions());
+
+
+    // Act
+    auto result = matcher.findMatches("The theme of the book");
+
+    // Assert
+    QList<TextMatcher::Match> expected { { 0, 3 }, { 4, 3 }, { 13, 3 } };
+    EXPECT_EQ(expected, result);
+}
+
+TEST(ATextMatcher, SucceedsFindingTextCaseSensitively)
+{
+    // Arrange
+    SearchOptions options { .caseSensitive = true };
+    TextMatcher matcher("The", options);
+
+
+    // Act
+    auto result = matcher.findMatches("The theme of The book");
+
+    // Assert
+    QList<TextMatcher::Match> expected { { 0, 3 }, { 13, 3 } };
+    EXPECT_EQ(expected, result);
+}
+
+TEST(ATextMatcher, SucceedsFindingWholeWordsOnly)
+{
+    // Arrange
+    SearchOptions options { .wholeWords = true };
+    TextMatcher matcher("the", options);
+
+
+    // Act
+    auto result = matcher.findMatches("bathe the theme, (the)");
+
+    // Assert
+    QList<TextMatcher::Match> expected { { 6, 3 }, { 18, 3 } };
+    EXPECT_EQ(expected, result);
+}
+
+TEST(ATextMatcher, SucceedsFindingRegularExpressionMatches)
+{
+    // Arrange
+    SearchOptions options { .wholeWords = true, .regularExpression = true };
+    TextMatcher matcher("b[aeiou]+k", options);
+
+
+    // Act
+    auto result = matcher.findMatches("A BOOK about books and a bak");
+
+    // Assert
+    QList<TextMatcher::Match> expected { { 2, 4 }, { 25, 3 } };
+    EXPECT_EQ(expected, result);
+}
+
+TEST(ATextMatcher, FailsMatchingWithAnInvalidRegularExpression)
+{
+    // Arrange
+    SearchOptions options { .regularExpression = true };
+    TextMatcher matcher("(unclosed", options);
+
+
+    // Act
+    auto result = matcher.findMatches("(unclosed");
+
+    // Assert
+    EXPECT_FALSE(matcher.isValid());
+    EXPECT_TRUE(result.isEmpty());
+}
+
+}  // namespace tests::application
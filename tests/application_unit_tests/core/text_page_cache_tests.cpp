@@ -0,0 +1,139 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include "mupdf/classes.h"
+#include "text_page_cache.hpp"
+
+
+using namespace testing;
+using namespace application::core::utils;
+
+namespace tests::application
+{
+
+struct ATextPageCache : public ::testing::Test
+{
+    TextPageCache::TextPageFactory createFactory(int* extractionCount)
+    {
+        return [extractionCount]()
+        {
+            ++*extractionCount;
+            return std::make_shared<mupdf::FzStextPage>(
+                mupdf::FzRect(0, 0, 100, 100));
+        };
+    }
+};
+
+TEST_F(ATextPageCache, SucceedsExtractingAPageOnlyOnce)
+{
+    // Arrange
+    TextPageCache textPageCache;
+    int extractionCount = 0;
+    auto factory = createFactory(&extractionCount);
+
+
+    // Act
+    auto first = textPageCache.getTextPage(3, factory);
+    auto second = textPageCache.getTextPage(3, factory);
+
+    // Assert
+    EXPECT_EQ(1, extractionCount);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first, textPageCache.findTextPage(3));
+    EXPECT_EQ(nullptr, textPageCache.findTextPage(4));
+}
+
+TEST_F(ATextPageCache, SucceedsEvictingTheLeastRecentlyUsedPage)
+{
+    // Arrange
+    int extractionCount = 0;
+    auto factory = createFactory(&extractionCount);
+    auto pageSize = TextPageCache::estimateSize(*factory());
+    TextPageCache textPageCache(pageSize * 2);
+    textPageCache.getTextPage(1, factory);
+    auto secondPage = textPageCache.getTextPage(2, factory);
+
+
+    // Act
+    textPageCache.getTextPage(1, factory);
+    textPageCache.getTextPage(3, factory);
+
+    // Assert
+    EXPECT_EQ(2, textPageCache.getPageCount());
+    EXPECT_EQ(pageSize * 2, textPageCache.getCacheSize());
+    EXPECT_NE(nullptr, textPageCache.findTextPage(1));
+    EXPECT_EQ(nullptr, textPageCache.findTextPage(2));
+    EXPECT_NE(nullptr, textPageCache.findTextPage(3));
+
+    // Evicted pages stay alive as long as they are used
+    EXPECT_NE(nullptr, secondPage->m_internal);
+}
+
+TEST_F(ATextPageCache, FailsCachingAPageThatCouldNotBeExtracted)
+{
+    // Arrange
+    TextPageCache textPageCache;
+    int extractionCount = 0;
+    auto failingFactory = []() -> std::shared_ptr<mupdf::FzStextPage>
+    {
+        throw std::runtime_error("Broken page");
+    };
+
+
+    // Act
+    EXPECT_THROW(textPageCache.getTextPage(0, failingFactory),
+                 std::runtime_error);
+    textPageCache.getTextPage(0, createFactory(&extractionCount));
+
+    // Assert
+    EXPECT_EQ(1, extractionCount);
+    EXPECT_EQ(1, textPageCache.getPageCount());
+}
+
+TEST_F(ATextPageCache, SucceedsGettingAPageWithoutWaitingForItsExtraction)
+{
+    // Arrange
+    TextPageCache textPageCache;
+    int extractionCount = 0;
+    auto factory = createFactory(&extractionCount);
+    std::shared_ptr<mupdf::FzStextPage> pageWithoutWaiting;
+
+    // The page is requested again while it is still being extracted
+    auto extractingFactory = [&]()
+    {
+        pageWithoutWaiting =
+            textPageCache.getTextPageWithoutWaiting(2, factory);
+        return factory();
+    };
+
+
+    // Act
+    auto page = textPageCache.getTextPage(2, extractingFactory);
+
+    // Assert
+    EXPECT_EQ(2, extractionCount);
+    EXPECT_NE(nullptr, pageWithoutWaiting);
+    EXPECT_EQ(page, textPageCache.findTextPage(2));
+    EXPECT_EQ(1, textPageCache.getPageCount());
+}
+
+TEST_F(ATextPageCache, SucceedsClearingAllPages)
+{
+    // Arrange
+    TextPageCache textPageCache;
+    int extractionCount = 0;
+    textPageCache.getTextPage(0, createFactory(&extractionCount));
+    textPageCache.getTextPage(1, createFactory(&extractionCount));
+
+
+    // Act
+    textPageCache.clear();
+
+    // Assert
+    EXPECT_EQ(0, textPageCache.getPageCount());
+    EXPECT_EQ(0, textPageCache.getCacheSize());
+    EXPECT_EQ(nullptr, textPageCache.findTextPage(0));
+}
+
+}  // namespace tests::application
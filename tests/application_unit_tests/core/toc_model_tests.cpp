@@ -0,0 +1,83 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "mupdf/classes.h"
+#include "toc/filtered_toc_model.hpp"
+#include "toc/toc_model.hpp"
+
+
+using namespace testing;
+using namespace application::core;
+
+namespace tests::application
+{
+
+struct ATOCModel : public ::testing::Test
+{
+    // An outline of a fixed layout document, whose pages are known right away
+    mupdf::FzOutline createOutline()
+    {
+        auto part = createEntry("Part One", 0);
+        part->down = createEntry("Chapter One", 3);
+        part->down->next = createEntry("Chapter Two", 7);
+        part->next = createEntry("Appendix", 12);
+
+        return mupdf::FzOutline(part);
+    }
+
+    fz_outline* createEntry(const char* title, int pageNumber)
+    {
+        auto entry = mupdf::ll_fz_new_outline();
+        entry->title = mupdf::ll_fz_strdup(title);
+        entry->page.chapter = 0;
+        entry->page.page = pageNumber;
+        return entry;
+    }
+};
+
+TEST_F(ATOCModel, SucceedsAddingChildrenOnlyOnceExpanded)
+{
+    // Arrange
+    TOCModel tocModel(createOutline(), "book.pdf", "book");
+    auto part = tocModel.index(0, 0);
+
+
+    // Act
+    int rowCountBefore = tocModel.rowCount(part);
+    bool canFetchBefore = tocModel.canFetchMore(part);
+    tocModel.fetchMore(part);
+
+    // Assert
+    EXPECT_EQ(2, tocModel.rowCount());
+    EXPECT_EQ(0, rowCountBefore);
+    EXPECT_TRUE(canFetchBefore);
+    EXPECT_TRUE(tocModel.hasChildren(part));
+    EXPECT_FALSE(tocModel.hasChildren(tocModel.index(1, 0)));
+
+    EXPECT_EQ(2, tocModel.rowCount(part));
+    EXPECT_FALSE(tocModel.canFetchMore(part));
+    auto chapter = tocModel.index(1, 0, part);
+    EXPECT_EQ("Chapter Two",
+              tocModel.data(chapter, TOCModel::TitleRole).toString());
+    EXPECT_EQ(7, tocModel.data(chapter, TOCModel::PageNumberRole).toInt());
+}
+
+TEST_F(ATOCModel, SucceedsFilteringByEntriesWhichWereNeverExpanded)
+{
+    // Arrange
+    TOCModel tocModel(createOutline(), "book.pdf", "book");
+    FilteredTOCModel filteredTOCModel;
+    filteredTOCModel.setSourceModel(&tocModel);
+
+
+    // Act
+    filteredTOCModel.setFilterString("Chapter Two");
+
+    // Assert
+    ASSERT_EQ(1, filteredTOCModel.rowCount());
+    auto part = filteredTOCModel.index(0, 0);
+    EXPECT_EQ("Part One",
+              filteredTOCModel.data(part, TOCModel::TitleRole).toString());
+    EXPECT_TRUE(filteredTOCModel.hasChildren(part));
+}
+
+}  // namespace tests::application
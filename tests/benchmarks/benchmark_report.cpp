@@ -0,0 +1,76 @@
+#include "benchmark_report.hpp"
+#include <QJsonArray>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace tests::benchmarks
+{
+
+void BenchmarkReport::addSample(const QString& phase, qint64 nanoseconds)
+{
+    m_samples[phase].push_back(nanoseconds);
+}
+
+void BenchmarkReport::addFile(const QString& filePath, int pageCount)
+{
+    m_files.insert(filePath, pageCount);
+}
+
+QJsonObject BenchmarkReport::toJson() const
+{
+    // Durations are reported in milliseconds, which is easier to read
+    auto toMs = [](double nanoseconds)
+    {
+        return nanoseconds / 1'000'000.0;
+    };
+
+    QJsonObject phases;
+    for(auto it = m_samples.cbegin(); it != m_samples.cend(); ++it)
+    {
+        auto samples = it.value();
+        std::ranges::sort(samples);
+        auto total = std::accumulate(samples.begin(), samples.end(), 0.0);
+
+        phases.insert(
+            it.key(),
+            QJsonObject {
+                { "count", static_cast<qint64>(samples.size()) },
+                { "mean_ms", toMs(total / samples.size()) },
+                { "min_ms", toMs(samples.front()) },
+                { "p50_ms", toMs(getPercentile(samples, 50)) },
+                { "p90_ms", toMs(getPercentile(samples, 90)) },
+                { "p99_ms", toMs(getPercentile(samples, 99)) },
+                { "max_ms", toMs(samples.back()) },
+            });
+    }
+
+    QJsonArray files;
+    for(auto it = m_files.cbegin(); it != m_files.cend(); ++it)
+    {
+        files.append(QJsonObject {
+            { "path", it.key() },
+            { "page_count", it.value() },
+        });
+    }
+
+    return QJsonObject {
+        { "files", files },
+        { "phases", phases },
+    };
+}
+
+double BenchmarkReport::getPercentile(const std::vector<qint64>& sortedSamples,
+                                      double percentile)
+{
+    if(sortedSamples.empty())
+        return 0;
+
+    // Nearest-rank method, the result is always one of the samples
+    auto rank = std::ceil(percentile / 100.0 * sortedSamples.size());
+    auto index = std::clamp(static_cast<int>(rank) - 1, 0,
+                            static_cast<int>(sortedSamples.size()) - 1);
+    return sortedSamples[index];
+}
+
+}  // namespace tests::benchmarks
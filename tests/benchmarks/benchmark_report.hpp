@@ -0,0 +1,32 @@
+#pragma once
+#include <QJsonObject>
+#include <QMap>
+#include <QString>
+#include <vector>
+
+namespace tests::benchmarks
+{
+
+/**
+ * The BenchmarkReport collects the durations of the benchmarked phases (e.g.
+ * loading a page or rendering it) and summarizes them as percentiles, so that
+ * runs before and after a change can be compared.
+ */
+class BenchmarkReport
+{
+public:
+    void addSample(const QString& phase, qint64 nanoseconds);
+    void addFile(const QString& filePath, int pageCount);
+
+    QJsonObject toJson() const;
+
+    static double getPercentile(const std::vector<qint64>& sortedSamples,
+                                double percentile);
+
+private:
+    // QMap keeps the phases sorted by name, which keeps the output stable
+    QMap<QString, std::vector<qint64>> m_samples;
+    QMap<QString, int> m_files;
+};
+
+}  // namespace tests::benchmarks
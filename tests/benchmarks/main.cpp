@@ -0,0 +1,251 @@
+#include <mupdf/classes.h>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QStringList>
+#include <algorithm>
+#include <cstdio>
+#include "benchmark_report.hpp"
+#include "book_searcher.hpp"
+#include "metadata_extractor.hpp"
+#include "page_generator.hpp"
+#include "rendering/pixmap_pool.hpp"
+
+using namespace application::core;
+
+namespace tests::benchmarks
+{
+
+struct BenchmarkOptions
+{
+    QList<float> zooms;
+    QString query;
+    int maxPages;
+};
+
+/**
+ * Runs the given function and adds its duration to the phase's samples.
+ */
+template<typename Function>
+auto measure(BenchmarkReport& report, const QString& phase, Function function)
+{
+    QElapsedTimer timer;
+    timer.start();
+    auto result = function();
+    report.addSample(phase, timer.nsecsElapsed());
+
+    return result;
+}
+
+QStringList collectCorpus(const QStringList& paths)
+{
+    const QStringList extensions { "*.pdf", "*.epub", "*.cbz" };
+
+    QStringList files;
+    for(auto& path : paths)
+    {
+        QFileInfo fileInfo(path);
+        if(fileInfo.isFile())
+        {
+            files.append(fileInfo.absoluteFilePath());
+            continue;
+        }
+
+        QDirIterator it(path, extensions, QDir::Files,
+                        QDirIterator::Subdirectories);
+        while(it.hasNext())
+            files.append(it.next());
+    }
+
+    files.sort();
+    return files;
+}
+
+void benchmarkPages(mupdf::FzDocument& document, int pageCount,
+                    const BenchmarkOptions& options, BenchmarkReport& report)
+{
+    PixmapPool pixmapPool;
+    for(int i = 0; i < pageCount; ++i)
+    {
+        auto page = measure(report, "load_page",
+                            [&]()
+                            {
+                                return document.fz_load_page(i);
+                            });
+        auto pageBox = page.fz_bound_page();
+
+        auto displayList = measure(
+            report, "display_list",
+            [&]()
+            {
+                mupdf::FzDisplayList list(pageBox);
+                auto listDevice = list.fz_new_list_device();
+                mupdf::FzCookie cookie;
+                page.fz_run_page(listDevice, mupdf::FzMatrix(), cookie);
+                listDevice.fz_close_device();
+                return list;
+            });
+
+        measure(report, "stext_page",
+                [&]()
+                {
+                    mupdf::FzStextOptions stextOptions;
+                    return mupdf::FzStextPage(displayList, stextOptions);
+                });
+
+        // Render through the same path as the render workers
+        for(auto zoom : options.zooms)
+        {
+            auto phase = QString("render_zoom_%1").arg(zoom);
+            measure(report, phase,
+                    [&]()
+                    {
+                        mupdf::FzCookie cookie;
+                        return PageGenerator::renderDisplayList(
+                            displayList, pageBox, zoom, cookie, pixmapPool);
+                    });
+        }
+    }
+}
+
+void benchmarkSearch(const QString& filePath, const BenchmarkOptions& options,
+                     BenchmarkReport& report)
+{
+    // Searching runs in the background, wait until all pages were searched.
+    // The file path is the cache key, like for books without a hash.
+    utils::BookSearcher bookSearcher(filePath, filePath);
+    QEventLoop eventLoop;
+    QObject::connect(&bookSearcher, &utils::BookSearcher::searchFinished,
+                     &eventLoop, &QEventLoop::quit);
+
+    measure(report, "search",
+            [&]()
+            {
+                bookSearcher.search(options.query, { .fromStart = true });
+                return eventLoop.exec();
+            });
+}
+
+void benchmarkCover(const QString& filePath, BenchmarkReport& report)
+{
+    // Covers are extracted when importing a book, which includes opening it
+    measure(report, "cover",
+            [&]()
+            {
+                MetadataExtractor metadataExtractor;
+                if(!metadataExtractor.setup(filePath))
+                    return QImage();
+
+                return metadataExtractor.getBookCover();
+            });
+}
+
+bool benchmarkFile(const QString& filePath, const BenchmarkOptions& options,
+                   BenchmarkReport& report)
+{
+    try
+    {
+        auto stdFilePath = filePath.toStdString();
+        auto document =
+            measure(report, "open_document",
+                    [&]()
+                    {
+                        return mupdf::FzDocument(stdFilePath.c_str());
+                    });
+
+        // Reflowable formats are laid out when the page count is requested
+        auto pageCount = measure(report, "layout_document",
+                                 [&]()
+                                 {
+                                     return document.fz_count_pages();
+                                 });
+        report.addFile(filePath, pageCount);
+
+        if(options.maxPages > 0)
+            pageCount = std::min(pageCount, options.maxPages);
+
+        benchmarkPages(document, pageCount, options, report);
+        benchmarkSearch(filePath, options, report);
+        benchmarkCover(filePath, report);
+        return true;
+    }
+    catch(...)
+    {
+        qWarning() << QString("Failed benchmarking book at: %1").arg(filePath);
+        return false;
+    }
+}
+
+}  // namespace tests::benchmarks
+
+int main(int argc, char* argv[])
+{
+    using namespace tests::benchmarks;
+
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Measures loading, rendering and searching the books of a corpus and "
+        "prints the percentiles of every phase as JSON.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("corpus",
+                                 "Books or directories containing books.",
+                                 "[corpus...]");
+    parser.addOptions({
+        { "zooms", "Comma separated zooms to render at.", "zooms", "1,2,4" },
+        { "query", "The text to search for.", "query", "the" },
+        { "max-pages", "The maximum number of pages per book, 0 for all.",
+          "count", "50" },
+        { "output", "Write the JSON to a file instead of stdout.", "file" },
+    });
+    parser.process(app);
+
+    BenchmarkOptions options {
+        .query = parser.value("query"),
+        .maxPages = parser.value("max-pages").toInt(),
+    };
+    for(auto& zoom : parser.value("zooms").split(',', Qt::SkipEmptyParts))
+        options.zooms.append(zoom.toFloat());
+
+    auto corpus = collectCorpus(parser.positionalArguments());
+    if(corpus.isEmpty())
+    {
+        // Meson treats this exit code as a skipped benchmark
+        qWarning() << "No books to benchmark, pass files or directories";
+        return 77;
+    }
+
+    BenchmarkReport report;
+    bool succeeded = true;
+    for(auto& filePath : corpus)
+    {
+        if(!benchmarkFile(filePath, options, report))
+            succeeded = false;
+    }
+
+    auto json = QJsonDocument(report.toJson()).toJson();
+    if(parser.isSet("output"))
+    {
+        QFile file(parser.value("output"));
+        if(!file.open(QFile::WriteOnly))
+        {
+            qWarning() << QString("Failed opening output file at: %1")
+                              .arg(file.fileName());
+            return 1;
+        }
+
+        file.write(json);
+    }
+    else
+    {
+        std::fwrite(json.constData(), 1, json.size(), stdout);
+    }
+
+    return succeeded ? 0 : 1;
+}